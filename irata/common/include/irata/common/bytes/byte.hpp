@@ -10,37 +10,46 @@ namespace irata::common::bytes {
 class ByteResult;
 
 // A single byte (8 bits).
+// Byte is a trivially copyable value type with the same size as a uint8_t, so
+// buffers of bytes can be copied around as raw memory.
 class Byte {
 public:
   // Constructs a byte with the given unsigned value.
-  Byte(uint8_t value);
+  constexpr Byte(uint8_t value) : value_(value) {}
 
-  operator uint8_t() const;
+  constexpr operator uint8_t() const { return value_; }
 
   // Constructs a byte with the given unsigned value.
-  static Byte from_unsigned(uint8_t value);
+  static constexpr Byte from_unsigned(uint8_t value) { return Byte(value); }
 
   // Constructs a byte with the given signed value.
-  static Byte from_signed(int8_t value);
+  static constexpr Byte from_signed(int8_t value) {
+    return Byte(static_cast<uint8_t>(value));
+  }
 
   // Allow copying and assigning.
   Byte() = default;
   Byte(const Byte &) = default;
   Byte &operator=(const Byte &) = default;
-  virtual ~Byte() = default;
 
-  bool operator==(const Byte &rhs) const;
-  bool operator!=(const Byte &rhs) const;
-  bool operator<(const Byte &rhs) const;
+  constexpr bool operator==(const Byte &rhs) const {
+    return value_ == rhs.value_;
+  }
+  constexpr bool operator!=(const Byte &rhs) const {
+    return value_ != rhs.value_;
+  }
+  constexpr bool operator<(const Byte &rhs) const {
+    return value_ < rhs.value_;
+  }
 
   template <typename T, typename std::enable_if<
                             std::is_integral<T>::value>::type * = nullptr>
-  bool operator==(T rhs) const {
+  constexpr bool operator==(T rhs) const {
     return rhs == value_;
   }
   template <typename T, typename std::enable_if<
                             std::is_integral<T>::value>::type * = nullptr>
-  bool operator!=(T rhs) const {
+  constexpr bool operator!=(T rhs) const {
     return rhs != value_;
   }
 
@@ -50,16 +59,21 @@ public:
   std::vector<bool> bits() const;
 
   // Returns the unsigned value of this byte.
-  uint8_t value() const;
+  constexpr uint8_t value() const { return value_; }
   // Returns the unsigned value of this byte.
-  uint8_t unsigned_value() const;
+  constexpr uint8_t unsigned_value() const { return value_; }
   // Returns the signed value of this byte.
-  int8_t signed_value() const;
+  constexpr int8_t signed_value() const {
+    return static_cast<int8_t>(value_);
+  }
 
 private:
   uint8_t value_ = 0;
 };
 
+static_assert(std::is_trivially_copyable_v<Byte>);
+static_assert(sizeof(Byte) == sizeof(uint8_t));
+
 std::ostream &operator<<(std::ostream &os, const Byte &byte);
 
 } // namespace irata::common::bytes
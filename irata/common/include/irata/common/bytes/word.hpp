@@ -1,50 +1,73 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <irata/common/bytes/byte.hpp>
 #include <ostream>
+#include <type_traits>
 #include <utility>
 
 namespace irata::common::bytes {
 
 // A 16-bit word.
+// Word is a trivially copyable value type with the same size as a uint16_t.
 class Word {
 public:
   // Constructs a word with the given value.
-  Word(uint16_t value = 0);
+  constexpr Word(uint16_t value = 0) : value_(value) {}
   Word(const Word &) = default;
   Word &operator=(const Word &) = default;
-  virtual ~Word() = default;
 
-  operator uint16_t() const;
+  constexpr operator uint16_t() const { return value_; }
 
   // Constructs a word from the given high and low bytes.
-  static Word from_bytes(Byte high, Byte low);
+  static constexpr Word from_bytes(Byte high, Byte low) {
+    return Word((high.unsigned_value() << 8) | low.unsigned_value());
+  }
   // Returns the high and low bytes of this word.
-  std::pair<Byte, Byte> to_bytes() const;
+  constexpr std::pair<Byte, Byte> to_bytes() const {
+    return {Byte::from_unsigned(value_ >> 8),
+            Byte::from_unsigned(value_ & 0xFF)};
+  }
 
   // Returns the value of this word.
-  uint16_t value() const;
-
-  bool operator==(const Word &other) const;
-  bool operator!=(const Word &other) const;
-  bool operator<(const Word &other) const;
-  bool operator<=(const Word &other) const;
-  bool operator>(const Word &other) const;
-  bool operator>=(const Word &other) const;
-  Word operator+(const Word &other) const;
-  Word operator-(const Word &other) const;
-  Word operator+(size_t other) const;
-  Word operator-(size_t other) const;
+  constexpr uint16_t value() const { return value_; }
+
+  constexpr bool operator==(const Word &other) const {
+    return value_ == other.value_;
+  }
+  constexpr bool operator!=(const Word &other) const {
+    return value_ != other.value_;
+  }
+  constexpr bool operator<(const Word &other) const {
+    return value_ < other.value_;
+  }
+  constexpr bool operator<=(const Word &other) const {
+    return value_ <= other.value_;
+  }
+  constexpr bool operator>(const Word &other) const {
+    return value_ > other.value_;
+  }
+  constexpr bool operator>=(const Word &other) const {
+    return value_ >= other.value_;
+  }
+  constexpr Word operator+(const Word &other) const {
+    return Word(value_ + other.value_);
+  }
+  constexpr Word operator-(const Word &other) const {
+    return Word(value_ - other.value_);
+  }
+  constexpr Word operator+(size_t other) const { return Word(value_ + other); }
+  constexpr Word operator-(size_t other) const { return Word(value_ - other); }
 
   template <typename T, typename std::enable_if<
                             std::is_integral<T>::value>::type * = nullptr>
-  bool operator==(T rhs) const {
+  constexpr bool operator==(T rhs) const {
     return rhs == value_;
   }
   template <typename T, typename std::enable_if<
                             std::is_integral<T>::value>::type * = nullptr>
-  bool operator!=(T rhs) const {
+  constexpr bool operator!=(T rhs) const {
     return rhs != value_;
   }
 
@@ -52,6 +75,9 @@ private:
   uint16_t value_;
 };
 
+static_assert(std::is_trivially_copyable_v<Word>);
+static_assert(sizeof(Word) == sizeof(uint16_t));
+
 std::ostream &operator<<(std::ostream &os, const Word &word);
 
 } // namespace irata::common::bytes
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string_view>
+
+// Helpers for the binary formats that the simulator writes, such as microcode
+// images, snapshots and traces. Integers are little endian, so files are
+// portable between hosts.
+namespace irata::common::serialization {
+
+void write_u8(std::ostream &os, uint8_t value);
+void write_u16(std::ostream &os, uint16_t value);
+void write_u32(std::ostream &os, uint32_t value);
+void write_u64(std::ostream &os, uint64_t value);
+
+// Throw std::runtime_error if the stream ends first.
+uint8_t read_u8(std::istream &is);
+uint16_t read_u16(std::istream &is);
+uint32_t read_u32(std::istream &is);
+uint64_t read_u64(std::istream &is);
+
+// 64 bit FNV-1a, which is stable across platforms and standard libraries,
+// unlike std::hash.
+class Hasher {
+public:
+  // Adds the string, terminated so that adjacent strings can't run together.
+  void add(std::string_view s);
+
+  // Adds the value's little endian bytes.
+  void add(uint64_t value);
+
+  void add_byte(uint8_t byte);
+
+  uint64_t value() const;
+
+private:
+  uint64_t value_ = 0xcbf29ce484222325ull;
+};
+
+} // namespace irata::common::serialization
@@ -1,56 +1,11 @@
 #include <iomanip>
 #include <irata/common/bytes/word.hpp>
-#include <utility>
 
 namespace irata::common::bytes {
 
-Word::Word(uint16_t value) : value_(value) {}
-
-Word::operator uint16_t() const { return value_; }
-
-Word Word::from_bytes(Byte high, Byte low) {
-  return Word((high.unsigned_value() << 8) | low.unsigned_value());
-}
-
-std::pair<Byte, Byte> Word::to_bytes() const {
-  return {Byte::from_unsigned(value_ >> 8), Byte::from_unsigned(value_ & 0xFF)};
-}
-
-uint16_t Word::value() const { return value_; }
-
 std::ostream &operator<<(std::ostream &os, const Word &word) {
   return os << "0x" << std::uppercase << std::hex << std::setw(4)
             << std::setfill('0') << static_cast<int>(word.value());
 }
 
-bool Word::operator==(const Word &other) const {
-  return value_ == other.value_;
-}
-
-bool Word::operator!=(const Word &other) const { return !(*this == other); }
-
-bool Word::operator<(const Word &other) const { return value_ < other.value_; }
-
-bool Word::operator<=(const Word &other) const {
-  return value_ <= other.value_;
-}
-
-bool Word::operator>(const Word &other) const { return value_ > other.value_; }
-
-bool Word::operator>=(const Word &other) const {
-  return value_ >= other.value_;
-}
-
-Word Word::operator+(const Word &other) const {
-  return Word(value_ + other.value_);
-}
-
-Word Word::operator-(const Word &other) const {
-  return Word(value_ - other.value_);
-}
-
-Word Word::operator+(size_t other) const { return Word(value_ + other); }
-
-Word Word::operator-(size_t other) const { return Word(value_ - other); }
-
 } // namespace irata::common::bytes
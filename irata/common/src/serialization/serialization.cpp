@@ -0,0 +1,69 @@
+#include <irata/common/serialization/serialization.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace irata::common::serialization {
+
+void write_u8(std::ostream &os, uint8_t value) {
+  os.put(static_cast<char>(value));
+}
+
+void write_u16(std::ostream &os, uint16_t value) {
+  write_u8(os, value & 0xFF);
+  write_u8(os, value >> 8);
+}
+
+void write_u32(std::ostream &os, uint32_t value) {
+  write_u16(os, value & 0xFFFF);
+  write_u16(os, value >> 16);
+}
+
+void write_u64(std::ostream &os, uint64_t value) {
+  write_u32(os, value & 0xFFFFFFFF);
+  write_u32(os, value >> 32);
+}
+
+uint8_t read_u8(std::istream &is) {
+  const int c = is.get();
+  if (c == std::char_traits<char>::eof()) {
+    throw std::runtime_error("input is truncated");
+  }
+  return static_cast<uint8_t>(c);
+}
+
+uint16_t read_u16(std::istream &is) {
+  const uint16_t low = read_u8(is);
+  return low | (read_u8(is) << 8);
+}
+
+uint32_t read_u32(std::istream &is) {
+  const uint32_t low = read_u16(is);
+  return low | (uint32_t(read_u16(is)) << 16);
+}
+
+uint64_t read_u64(std::istream &is) {
+  const uint64_t low = read_u32(is);
+  return low | (uint64_t(read_u32(is)) << 32);
+}
+
+void Hasher::add(std::string_view s) {
+  for (const char c : s) {
+    add_byte(static_cast<uint8_t>(c));
+  }
+  add_byte(0);
+}
+
+void Hasher::add(uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    add_byte((value >> (i * 8)) & 0xFF);
+  }
+}
+
+void Hasher::add_byte(uint8_t byte) {
+  value_ ^= byte;
+  value_ *= 0x100000001b3ull;
+}
+
+uint64_t Hasher::value() const { return value_; }
+
+} // namespace irata::common::serialization
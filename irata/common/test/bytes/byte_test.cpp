@@ -1,7 +1,9 @@
+#include <cstring>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <irata/common/bytes/byte.hpp>
 #include <stdexcept>
+#include <vector>
 
 using ::testing::ElementsAre;
 
@@ -69,6 +71,21 @@ TEST(ByteTest, Bits) {
               ElementsAre(false, true, false, true, false, true, false, true));
 }
 
+TEST(ByteTest, Constexpr) {
+  constexpr Byte byte = Byte::from_signed(-1);
+  static_assert(byte.unsigned_value() == 0xFF);
+  static_assert(byte.signed_value() == -1);
+  static_assert(byte == Byte(0xFF));
+  static_assert(Byte(0x01) < byte);
+}
+
+TEST(ByteTest, CopyAsRawMemory) {
+  const std::vector<uint8_t> raw = {0x12, 0x34, 0x56};
+  std::vector<Byte> bytes(raw.size());
+  std::memcpy(bytes.data(), raw.data(), raw.size());
+  EXPECT_EQ(bytes, std::vector<Byte>({0x12, 0x34, 0x56}));
+}
+
 TEST(ByteTest, ToString) {
   const auto to_str = [](const Byte &byte) {
     std::ostringstream os;
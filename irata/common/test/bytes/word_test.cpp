@@ -19,6 +19,14 @@ TEST(WordTest, ForValue) {
   EXPECT_EQ(word.value(), 0x1234);
 }
 
+TEST(WordTest, Constexpr) {
+  constexpr Word word = Word::from_bytes(Byte(0x12), Byte(0x34));
+  static_assert(word.value() == 0x1234);
+  static_assert(word.to_bytes().first == Byte(0x12));
+  static_assert(word.to_bytes().second == Byte(0x34));
+  static_assert(word + Word(1) == Word(0x1235));
+}
+
 TEST(WordTest, FromBytes) {
   const Word word =
       Word::from_bytes(Byte::from_unsigned(0x12), Byte::from_unsigned(0x34));
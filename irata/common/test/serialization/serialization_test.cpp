@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <irata/common/serialization/serialization.hpp>
+#include <sstream>
+#include <stdexcept>
+
+namespace irata::common::serialization {
+
+TEST(SerializationTest, IntegersAreLittleEndian) {
+  std::ostringstream os;
+  write_u8(os, 0x01);
+  write_u16(os, 0x0302);
+  write_u32(os, 0x07060504);
+  write_u64(os, 0x0f0e0d0c0b0a0908ull);
+  EXPECT_EQ(os.str(), std::string("\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a"
+                                  "\x0b\x0c\x0d\x0e\x0f"));
+}
+
+TEST(SerializationTest, RoundTrip) {
+  std::stringstream ss;
+  write_u8(ss, 0xAB);
+  write_u16(ss, 0xABCD);
+  write_u32(ss, 0xDEADBEEF);
+  write_u64(ss, 0x0123456789ABCDEFull);
+  EXPECT_EQ(read_u8(ss), 0xAB);
+  EXPECT_EQ(read_u16(ss), 0xABCD);
+  EXPECT_EQ(read_u32(ss), 0xDEADBEEF);
+  EXPECT_EQ(read_u64(ss), 0x0123456789ABCDEFull);
+}
+
+TEST(SerializationTest, ReadPastEnd) {
+  std::istringstream is(std::string("\x01\x02\x03", 3));
+  EXPECT_THROW(read_u32(is), std::runtime_error);
+}
+
+TEST(SerializationTest, HasherIsFnv1a) {
+  Hasher hasher;
+  EXPECT_EQ(hasher.value(), 0xcbf29ce484222325ull);
+  hasher.add_byte('a');
+  EXPECT_EQ(hasher.value(), 0xaf63dc4c8601ec8cull);
+}
+
+TEST(SerializationTest, HasherSeparatesStrings) {
+  Hasher ab_c, a_bc;
+  ab_c.add("ab");
+  ab_c.add("c");
+  a_bc.add("a");
+  a_bc.add("bc");
+  EXPECT_NE(ab_c.value(), a_bc.value());
+}
+
+} // namespace irata::common::serialization
@@ -0,0 +1,46 @@
+# Generates the source for Compiler::irata_image(), which embeds the microcode
+# image written by the microcode tool in the library. Without an IMAGE, the
+# generated irata_image() returns an empty image, for the microcode tool
+# itself.
+# Usage: cmake [-DIMAGE=<image>] -DOUTPUT=<source> -P embed_image.cmake
+
+if(DEFINED IMAGE)
+  file(READ ${IMAGE} HEX HEX)
+  string(REGEX REPLACE "(..)" "0x\\1," BYTES "${HEX}")
+  # Put 12 bytes on each line. CMake regexes have no {n} repetition.
+  string(REPEAT "0x..," 12 LINE)
+  string(REGEX REPLACE "(${LINE})" "\\1\n    " BYTES "${BYTES}")
+  string(REPLACE ",0x" ", 0x" BYTES "${BYTES}")
+  string(STRIP "${BYTES}" BYTES)
+  set(BODY "namespace {
+
+const unsigned char image[] = {
+    ${BYTES}};
+
+} // namespace
+
+std::string_view Compiler::irata_image() {
+  return std::string_view(reinterpret_cast<const char *>(image), sizeof(image));
+}")
+else()
+  set(BODY "std::string_view Compiler::irata_image() { return {}; }")
+endif()
+
+set(CONTENT "// Generated by embed_image.cmake. Do not edit.
+#include <irata/sim/microcode/compiler/compiler.hpp>
+
+namespace irata::sim::microcode::compiler {
+
+${BODY}
+
+} // namespace irata::sim::microcode::compiler
+")
+
+# Only touch the output when the image changes, so that an unchanged image
+# doesn't relink everything.
+if(EXISTS ${OUTPUT})
+  file(READ ${OUTPUT} OLD_CONTENT)
+endif()
+if(NOT "${OLD_CONTENT}" STREQUAL "${CONTENT}")
+  file(WRITE ${OUTPUT} "${CONTENT}")
+endif()
@@ -0,0 +1,48 @@
+# Generates the source for Compiler::fingerprint(), a hash of the sources that
+# the compiled microcode table depends on, and Compiler::pass_fingerprint(), a
+# hash of the same sources without the irata instruction set, which the passes
+# don't depend on.
+# Usage: cmake -DROOT=<sim dir> -DOUTPUT=<source> -P fingerprint.cmake
+
+file(GLOB_RECURSE INPUTS RELATIVE ${ROOT}
+  ${ROOT}/src/hdl/*.cpp
+  ${ROOT}/src/microcode/*.cpp
+  ${ROOT}/include/irata/sim/hdl/*.hpp
+  ${ROOT}/include/irata/sim/microcode/*.hpp
+)
+list(SORT INPUTS)
+set(INSTRUCTION_SET src/microcode/dsl/irata_instruction_set.cpp)
+set(HASHES "")
+set(PASS_HASHES "")
+foreach(INPUT ${INPUTS})
+  file(SHA256 ${ROOT}/${INPUT} HASH)
+  string(APPEND HASHES "${INPUT} ${HASH}\n")
+  if(NOT INPUT STREQUAL INSTRUCTION_SET)
+    string(APPEND PASS_HASHES "${INPUT} ${HASH}\n")
+  endif()
+endforeach()
+string(SHA256 FINGERPRINT "${HASHES}")
+string(SUBSTRING ${FINGERPRINT} 0 16 FINGERPRINT)
+string(SHA256 PASS_FINGERPRINT "${PASS_HASHES}")
+string(SUBSTRING ${PASS_FINGERPRINT} 0 16 PASS_FINGERPRINT)
+
+set(CONTENT "// Generated by fingerprint.cmake. Do not edit.
+#include <irata/sim/microcode/compiler/compiler.hpp>
+
+namespace irata::sim::microcode::compiler {
+
+uint64_t Compiler::fingerprint() { return 0x${FINGERPRINT}; }
+
+uint64_t Compiler::pass_fingerprint() { return 0x${PASS_FINGERPRINT}; }
+
+} // namespace irata::sim::microcode::compiler
+")
+
+# Only touch the output when the fingerprint changes, so that an unchanged
+# fingerprint doesn't relink everything.
+if(EXISTS ${OUTPUT})
+  file(READ ${OUTPUT} OLD_CONTENT)
+endif()
+if(NOT "${OLD_CONTENT}" STREQUAL "${CONTENT}")
+  file(WRITE ${OUTPUT} "${CONTENT}")
+endif()
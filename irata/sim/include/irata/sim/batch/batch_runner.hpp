@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <irata/sim/components/irata.hpp>
+#include <irata/sim/components/memory/module.hpp>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace irata::sim::batch {
+
+// BatchRunner runs many cartridges to completion, each on its own
+// components::Irata, spread over a pool of worker threads.
+// Each worker owns a queue of cartridges and steals from the other workers'
+// queues when its own runs dry, so a few slow cartridges don't leave the
+// other threads idle.
+//
+// Simulated machines share nothing but the process-wide singletons:
+// hdl::irata(), dsl::InstructionSet::irata(), asm_::InstructionSet::irata(),
+// Compiler::irata(), the microcode table from Compiler::irata_table() and the
+// encoded instruction memory from Controller::irata_microcode().
+// All of these are function-local statics, whose initialization is thread
+// safe. Only Compiler::irata() changes after construction: each compile
+// replaces its cached control registry and instruction pass results, which
+// its mutex guards. The mutex is only held to read and update the cache, not
+// while passes run. The runner loads the microcode before starting any
+// workers, so every machine is built from the one shared copy and workers
+// never compile.
+class BatchRunner {
+public:
+  // A cartridge to run.
+  struct Job {
+    // A name to report the job's result under, such as the cartridge's path.
+    std::string name;
+    // The cartridge, mapped at 0x8000. Each run gets a clone, so read-only
+    // cartridges such as memory::ROM and memory::MappedROM are never copied.
+    std::shared_ptr<const components::memory::Module> cartridge;
+  };
+
+  // The outcome of running a single job.
+  struct JobResult {
+    std::string name;
+    // How the program ended, or nullopt if it didn't, in which case error
+    // says why.
+    std::optional<components::Irata::Result> result;
+    std::string error;
+    // The number of ticks the machine ran for.
+    uint64_t ticks = 0;
+    // The wall time spent running the machine, excluding building it.
+    double seconds = 0;
+  };
+
+  struct Report {
+    // The results of each job, in the order the jobs were given.
+    std::vector<JobResult> results;
+    // The number of worker threads used.
+    size_t num_threads = 0;
+    // The wall time for the whole batch.
+    double seconds = 0;
+
+    uint64_t total_ticks() const;
+    // Returns the number of jobs that halted.
+    size_t num_halted() const;
+  };
+
+  // Constructs a runner with the given number of worker threads. Zero means
+  // one per hardware thread.
+  // Each machine is stopped with an error after max_ticks ticks if
+  // max_ticks is non-negative.
+  explicit BatchRunner(size_t num_threads = 0, int64_t max_ticks = -1);
+
+  size_t num_threads() const;
+
+  // Runs every job and returns their results. Never throws for a failing
+  // job; errors are reported in the job's result.
+  Report run(const std::vector<Job> &jobs) const;
+
+  // Runs a single job on the calling thread.
+  JobResult run_job(const Job &job) const;
+
+private:
+  const size_t num_threads_;
+  const int64_t max_ticks_;
+};
+
+// Writes a line per job and a throughput summary.
+std::ostream &operator<<(std::ostream &os, const BatchRunner::Report &report);
+
+} // namespace irata::sim::batch
@@ -72,6 +72,8 @@ public:
   const Status &address_add_carry() const;
 
 protected:
+  std::set<hdl::TickPhase> tick_phases() const override;
+
   void tick_process(Logger &logger) override;
 
 private:
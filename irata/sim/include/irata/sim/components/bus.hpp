@@ -24,15 +24,24 @@ public:
   // Returns the current value on the bus during this tick, if any.
   std::optional<T> value() const;
   // Sets the value on the bus for this tick.
-  void set_value(T value, Component &setter);
+  // Throws std::logic_error if a different component already set the value
+  // during this tick.
+  void set_value(T value, const Component &setter);
 
-  std::optional<std::string> setter() const;
+  // Returns the component that set the value during this tick, or nullptr if
+  // the bus hasn't been set.
+  const Component *setter() const;
 
   void tick_clear(Logger &logger) override;
 
+protected:
+  std::set<hdl::TickPhase> tick_phases() const override;
+
 private:
   std::optional<T> value_;
-  std::optional<std::string> setter_;
+  // The setter is tracked by pointer so that bus transfers don't build or
+  // copy paths. The path is only rendered when reporting a conflict.
+  const Component *setter_ = nullptr;
 };
 
 using ByteBus = Bus<Byte>;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <iomanip>
 #include <iostream>
@@ -10,9 +12,11 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <set>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace irata::sim::components {
 
@@ -65,11 +69,24 @@ public:
   // Returns the path of the component, which is the path from the root to the
   // component, separated by slashes. For example, if the component is named
   // "child" and its parent is named "parent", then the path is "/parent/child".
-  std::string path() const;
+  // The path is cached and updated whenever the component's tree changes.
+  const std::string &path() const;
 
   // Tick the whole component tree, doing all tick phases in order top down.
+  // Log messages from each component are written to log_output.
+  // The first tick of a tree visits every component in every phase, and
+  // records which ones tick in each phase, from their tick_phases(). Later
+  // ticks only visit those components, in traversal order. Adding a component
+  // anywhere in the tree discards the schedule.
+  // The first tick throws std::logic_error if a component's tick handler ran
+  // for a phase that isn't in its tick_phases(), since later ticks would skip
+  // it.
   void tick(std::ostream &log_output = std::cerr);
 
+  // Tick the whole component tree without logging. Every component gets a
+  // disabled logger, so no log messages are formatted or buffered.
+  void tick_quiet();
+
   // Returns a list of all controls in the component tree.
   virtual std::vector<Control *> controls();
   std::vector<const Control *> controls() const;
@@ -81,51 +98,99 @@ public:
   // Serialize the whole component tree to the given output stream.
   void serialize_all(std::ostream &os) const;
 
+  // Writes a compact binary snapshot of the state of the whole component tree
+  // to the given output stream: every register, counter, status, control and
+  // RAM byte. Snapshots can only be taken between ticks.
+  void save_snapshot(std::ostream &os) const;
+
+  // Restores the whole component tree to the state in a snapshot written by
+  // save_snapshot, in place. The snapshot must come from a tree with the same
+  // components. Throws std::invalid_argument if it doesn't, and
+  // std::runtime_error if the snapshot is malformed. The whole snapshot is
+  // checked before anything is restored, so the tree is unchanged if this
+  // throws.
+  void load_snapshot(std::istream &is);
+
+  // Copies the state of the whole of the source's tree into this whole tree,
+  // which must have the same components, as if by a snapshot. Components that
+  // can share storage with their source do so instead of copying it.
+  // Throws std::invalid_argument if the trees have different components.
+  void copy_state_from(const Component &source);
+
   // Returns the currently active tick phase, or nullopt if no tick phase is
   // currently active.
   // Note that this is set during a component's tick and its children's ticks,
   // for each phase of the tick.
   std::optional<hdl::TickPhase> active_tick_phase() const;
 
+  // Returns the components that are ticked in the given phase, in tick order,
+  // or nullopt if the tree hasn't been ticked since it last changed.
+  std::optional<std::vector<const Component *>>
+  tick_schedule(hdl::TickPhase tick_phase) const;
+
 protected:
   // Helper class used for logging during a tick.
   // Logs a message to the output stream when destroyed, if a message was
   // written to the logger.
   // Output includes the tick phase and the component's path.
+  // A logger with no output stream is disabled: everything written to it is
+  // discarded and its buffer is never constructed. Components that need to do
+  // extra work to build a message should check enabled() first.
   class Logger {
   public:
-    explicit Logger(std::ostream &output, hdl::TickPhase tick_phase,
+    explicit Logger(std::ostream *output, hdl::TickPhase tick_phase,
                     const Component &component);
+    Logger(const Logger &) = delete;
+    Logger &operator=(const Logger &) = delete;
     ~Logger();
 
+    // Returns true if messages written to this logger will be output.
+    bool enabled() const { return output_ != nullptr; }
+
     template <typename T> Logger &operator<<(const T &value) {
-      os_ << value;
-      logged_ = true;
+      if (output_ == nullptr) {
+        return *this;
+      }
+      if (!os_) {
+        os_.emplace();
+      }
+      *os_ << value;
       return *this;
     }
 
   private:
-    std::ostringstream os_;
+    friend class Component;
+
+    std::optional<std::ostringstream> os_;
     hdl::TickPhase tick_phase_;
     const Component &component_;
-    std::ostream &output_;
-    bool logged_ = false;
+    std::ostream *output_;
+    // Set by the base tick handlers, so that the first tick can find a
+    // component that overrides a handler without declaring its phase.
+    bool unhandled_ = false;
   };
 
+  // Returns the tick phases that this component has tick handlers for, which
+  // are the only phases it's ticked in. A class that overrides tick handlers
+  // must override this to add their phases to its base class's phases, or
+  // the first tick throws.
+  // Defaults to no phases.
+  virtual std::set<hdl::TickPhase> tick_phases() const;
+
   // Set up any control lines that will be used this tick.
-  virtual void tick_control(Logger &logger) {}
+  virtual void tick_control(Logger &logger) { logger.unhandled_ = true; }
 
   // Write any data to the bus that was requested by control lines.
-  virtual void tick_write(Logger &logger) {}
+  virtual void tick_write(Logger &logger) { logger.unhandled_ = true; }
 
   // Read any data from the bus that was requested by control lines.
-  virtual void tick_read(Logger &logger) {}
+  virtual void tick_read(Logger &logger) { logger.unhandled_ = true; }
 
   // Do any local processing for this tick.
-  virtual void tick_process(Logger &logger) {}
+  virtual void tick_process(Logger &logger) { logger.unhandled_ = true; }
 
   // Clear any control lines and any other state that was set up this tick.
-  virtual void tick_clear(Logger &logger) {}
+  virtual void tick_clear(Logger &logger) { logger.unhandled_ = true; }
 
   class Serializer {
   public:
@@ -151,26 +216,136 @@ protected:
   // Virtual entry point for serializing components.
   virtual void serialize(Serializer &serializer) const {}
 
+  // Helper classes for writing and reading a single component's state in a
+  // snapshot.
+  class StateWriter {
+  public:
+    explicit StateWriter(std::ostream &os);
+    StateWriter(const StateWriter &) = delete;
+    StateWriter &operator=(const StateWriter &) = delete;
+
+    void write_bool(bool value);
+    void write_byte(uint8_t value);
+    // Writes a length prefixed buffer.
+    void write_bytes(const std::vector<uint8_t> &bytes);
+
+  private:
+    friend class Component;
+
+    // A value written by a component, which a snapshot's payload is checked
+    // against before it's restored.
+    struct Field {
+      enum class Kind { Bool, Byte, Bytes };
+      Kind kind;
+      // The length of a buffer.
+      size_t size = 0;
+    };
+
+    std::ostream &os_;
+    // If set, every value written is also recorded here.
+    std::vector<Field> *fields_ = nullptr;
+  };
+
+  class StateReader {
+  public:
+    explicit StateReader(std::istream &is);
+    StateReader(const StateReader &) = delete;
+    StateReader &operator=(const StateReader &) = delete;
+
+    bool read_bool();
+    uint8_t read_byte();
+    // Reads a buffer written by write_bytes into bytes, which must already be
+    // the size of the buffer.
+    void read_bytes(std::vector<uint8_t> &bytes);
+
+  private:
+    std::istream &is_;
+  };
+
+  // Virtual entry points for snapshotting components. Components with state
+  // write it in save_state and read it back in the same order in load_state.
+  // Children are saved separately and shouldn't be included.
+  virtual void save_state(StateWriter &writer) const {}
+  virtual void load_state(StateReader &reader) {}
+
+  // Virtual entry point for copying state between trees. Components that can
+  // share their state with the source component, which is at the same path in
+  // another tree, do so and return true. Otherwise the state is copied with
+  // save_state and load_state.
+  virtual bool share_state(const Component &source) { return false; }
+
+  // Returns the active tick phase of the whole tree, which is the root's
+  // active tick phase. This is a single load from the tree's shared context.
+  std::optional<hdl::TickPhase> tree_tick_phase() const {
+    return context_->active_tick_phase;
+  }
+
 private:
+  // State shared by every component in a tree. Each component owns a context
+  // that is used while it is a root, and points to its root's context.
+  struct Context {
+    // The root of the tree.
+    Component *root;
+    // The currently active tick phase of the tree, only set during a tick.
+    std::optional<hdl::TickPhase> active_tick_phase = std::nullopt;
+    // The component whose tick handler is running, only set during a tick.
+    // It and its ancestors are the components with an active tick phase.
+    const Component *ticking = nullptr;
+  };
+
   // The name of the component.
   std::string name_;
 
   // The parent of the component, or nullptr if the component has no parent.
   Component *parent_ = nullptr;
 
+  // The cached path of the component.
+  std::string path_;
+
+  // The context owned by this component, used while it is a root.
+  Context own_context_;
+
+  // The context of this component's tree, owned by its root.
+  Context *context_;
+
+  // Points this component's subtree at the given context and recomputes the
+  // subtree's paths. Called when the subtree is added to a new parent.
+  void attach(Context *context);
+
   // The children of the component, keyed by name.
   // Note that the children are not owned by this map.
   std::map<std::string, Component *> children_;
 
-  void tick_traverse(std::ostream &log_output, hdl::TickPhase tick_phase);
+  // The components that tick in each tick phase, indexed by phase, in the
+  // order that a top down traversal of the tree visits them.
+  using TickSchedule = std::array<std::vector<Component *>, 5>;
+
+  // The tick schedule of this tree, only kept on the root. Recorded on the
+  // first tick and discarded whenever the tree changes.
+  std::optional<TickSchedule> tick_schedule_ = std::nullopt;
+
+  // Runs this component's tick handler for the given phase.
+  // Returns false if only the base Component handler ran.
+  bool tick_phase(std::ostream *log_output, hdl::TickPhase tick_phase);
+
+  // Appends each component in this subtree to the schedule of each phase that
+  // it ticks in, in traversal order.
+  void schedule_traverse(TickSchedule &schedule);
+
+  // Ticks every component in the tree in every phase and records the tree's
+  // tick schedule. Throws std::logic_error if a handler ran for a phase that
+  // its component doesn't declare.
+  void tick_and_schedule(std::ostream *log_output);
+
+  // Tick the whole component tree, logging to log_output if it isn't null.
+  void tick_all(std::ostream *log_output);
 
   // Traverse this component's subtree, calling serialize on each component.
   void serialize_traverse(Serializer &serializer) const;
 
-  // The currently active tick phase, only set during a tick.
-  std::optional<hdl::TickPhase> active_tick_phase_ = std::nullopt;
-
-  void set_active_tick_phase(std::optional<hdl::TickPhase> tick_phase);
+  // Appends this component's subtree to components, in the order that
+  // snapshots store them.
+  void snapshot_traverse(std::vector<const Component *> &components) const;
 };
 
 } // namespace irata::sim::components
\ No newline at end of file
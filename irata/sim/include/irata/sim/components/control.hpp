@@ -28,8 +28,12 @@ public:
   hdl::TickPhase phase() const;
 
   // Returns the value of the control line.
+  // Throws if read outside of the control's phase during a tick, unless phase
+  // checks are compiled out with IRATA_DISABLE_PHASE_CHECKS.
   bool value() const;
   // Sets the value of the control line.
+  // Throws if set in a phase where that isn't allowed during a tick, unless
+  // phase checks are compiled out with IRATA_DISABLE_PHASE_CHECKS.
   void set_value(bool value);
 
   // Returns the value of the clear control line, if any.
@@ -52,6 +56,12 @@ public:
   // Returns true if the control line can be set during the given phase.
   bool can_be_set_during_phase(std::optional<hdl::TickPhase> phase) const;
 
+protected:
+  std::set<hdl::TickPhase> tick_phases() const override;
+
+  void save_state(StateWriter &writer) const override;
+  void load_state(StateReader &reader) override;
+
 private:
   // The phase of the control line.
   const hdl::TickPhase phase_;
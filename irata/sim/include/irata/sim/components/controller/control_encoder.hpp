@@ -3,7 +3,9 @@
 #include <cstdint>
 #include <irata/sim/hdl/control_decl.hpp>
 #include <irata/sim/microcode/table/table.hpp>
+#include <map>
 #include <set>
+#include <vector>
 
 namespace irata::sim::components::controller {
 
@@ -24,10 +26,17 @@ public:
   // Returns the number of controls in the table.
   size_t num_controls() const;
 
+  // Returns the bit index of each control in an encoded value. Controls are
+  // assigned bits in order of their paths.
   const std::map<const hdl::ControlDecl *, size_t> &indices() const;
 
+  // Returns the controls ordered by their bit index in an encoded value, so
+  // that bit i of an encoded value corresponds to controls()[i].
+  const std::vector<const hdl::ControlDecl *> &controls() const;
+
 private:
   const std::map<const hdl::ControlDecl *, size_t> indices_;
+  const std::vector<const hdl::ControlDecl *> controls_;
 };
 
 } // namespace irata::sim::components::controller
@@ -4,12 +4,17 @@
 #include <irata/sim/bytes/word.hpp>
 #include <irata/sim/components/bus.hpp>
 #include <irata/sim/components/component.hpp>
+#include <irata/sim/components/control.hpp>
 #include <irata/sim/components/controller/instruction_memory.hpp>
 #include <irata/sim/components/counter.hpp>
 #include <irata/sim/components/register.hpp>
+#include <irata/sim/components/status.hpp>
 #include <irata/sim/components/word_counter.hpp>
 #include <irata/sim/microcode/table/table.hpp>
+#include <memory>
+#include <optional>
 #include <string_view>
+#include <vector>
 
 namespace irata::sim::components::controller {
 
@@ -17,12 +22,24 @@ class Controller : public Component {
 public:
   Controller(const microcode::table::Table &table, ByteBus &data_bus,
              std::string_view name = "controller", Component *parent = nullptr);
+  // Creates a controller whose instruction memory has the given contents,
+  // which may be shared with other controllers.
+  Controller(std::shared_ptr<const InstructionMemory::Contents> microcode,
+             ByteBus &data_bus, std::string_view name = "controller",
+             Component *parent = nullptr);
   virtual ~Controller() = default;
 
+  // Creates a controller for the irata microcode, sharing the instruction
+  // memory contents from irata_microcode().
   static Controller irata(ByteBus &data_bus,
                           std::string_view name = "controller",
                           Component *parent = nullptr);
 
+  // Returns the instruction memory contents for the irata microcode, which
+  // are encoded on the first call.
+  static const std::shared_ptr<const InstructionMemory::Contents> &
+  irata_microcode();
+
   hdl::ComponentType type() const override;
 
   const InstructionMemory &instruction_memory() const;
@@ -38,15 +55,57 @@ public:
   Byte step_counter() const;
   void set_step_counter(Byte step_counter);
 
+  // Resolves the controls and statuses used by the microcode table to the
+  // corresponding sim components in this component's tree, so that ticks can
+  // access them directly by encoded bit index instead of searching the tree.
+  // This is done automatically on the first tick, since the rest of the tree
+  // is usually built after the controller. It can be called explicitly once
+  // the tree is complete to surface binding errors early.
+  // Throws an exception if a status used by the microcode table is missing.
+  // Controls used by the microcode table that are missing are only reported
+  // if they are asserted.
+  void bind();
+
+  // Returns true if bind has been called.
+  bool bound() const;
+
+  std::set<hdl::TickPhase> tick_phases() const override;
+
   void tick_control(Logger &logger) override;
 
+  // The address read from the instruction memory on a tick and the encoded
+  // controls read from it.
+  struct Read {
+    uint8_t opcode = 0;
+    uint8_t step_counter = 0;
+    uint32_t encoded_statuses = 0;
+    uint64_t encoded_controls = 0;
+  };
+
+  // Returns what the controller read on the last tick, which is kept for
+  // tracing since the opcode and step counter may have changed by the end of
+  // the tick.
+  const Read &last_read() const;
+
+  // Returns the bit index of the given control in encoded controls, or
+  // nullopt if the control isn't bound.
+  std::optional<size_t> control_index(const Control &control) const;
+
 private:
   InstructionMemory instruction_memory_;
   Register opcode_;
   Counter step_counter_;
 
-  CompleteStatuses status_values() const;
-  void set_control_values(const std::set<const hdl::ControlDecl *> &controls);
+  // Bound controls, indexed by control encoder bit index. Controls that
+  // weren't found in the tree are nullptr.
+  std::vector<Control *> controls_;
+  // Bound statuses, indexed by status encoder bit index.
+  std::vector<const Status *> statuses_;
+  bool bound_ = false;
+  Read last_read_;
+
+  uint32_t encoded_status_values() const;
+  void set_control_values(uint64_t encoded_controls);
 };
 
 } // namespace irata::sim::components::controller
\ No newline at end of file
@@ -14,12 +14,14 @@
 namespace irata::sim::components::controller {
 
 // InstructionEncoder is responsible for encoding the instruction memory
-// of the CPU. Addresses in the instruction memory are composed of:
+// of the CPU. Flat addresses in the instruction memory are composed of:
 //   - up to 8 bits for the opcode
 //   - up to 8 bits for the statuses
 //   - up to 8 bits for the step index
 // The actual widths of each field are determined by the microcode table.
-// The instruction memory is encoded as a map from addresses to values.
+// Flat addresses are limited to 16 bits, but tables that need more can still
+// be encoded, since the instruction memory itself is indexed by opcode rather
+// than by flat address. See InstructionMemory.
 // The values are the encoded controls for the given instruction, statuses, and
 // step index.
 class InstructionEncoder {
@@ -28,9 +30,19 @@ public:
   InstructionEncoder(const InstructionEncoder &) = delete;
   InstructionEncoder &operator=(const InstructionEncoder &) = delete;
 
+  // Throws if the opcode or step index is out of bounds for the table.
+  void check_bounds(uint8_t opcode, uint8_t step_index) const;
+
+  // Encodes a flat address.
+  // Throws if the table needs more than 16 address bits.
   uint16_t encode_address(uint8_t opcode, const CompleteStatuses &statuses,
                           uint8_t step_index) const;
 
+  // Encodes an address from statuses that have already been encoded by the
+  // status encoder.
+  uint16_t encode_address(uint8_t opcode, uint32_t encoded_statuses,
+                          uint8_t step_index) const;
+
   std::vector<uint16_t> encode_address(uint8_t opcode,
                                        const PartialStatuses &statuses,
                                        uint8_t step_index) const;
@@ -73,7 +85,7 @@ public:
   // The number of bits that are used to encode the step index.
   size_t num_step_index_bits() const;
 
-  // Returns the number of address bits in the instruction memory.
+  // Returns the number of bits in a flat address, which may be more than 16.
   size_t num_address_bits() const;
 
   // Returns the number of value bits in the instruction memory.
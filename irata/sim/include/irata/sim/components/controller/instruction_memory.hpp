@@ -7,14 +7,58 @@
 #include <irata/sim/microcode/table/table.hpp>
 #include <map>
 #include <memory>
+#include <vector>
 
 namespace irata::sim::components::controller {
 
+// InstructionMemory holds the encoded microcode of the CPU, which the
+// controller reads from on every tick. The microcode is stored in two levels:
+//   - a header for each opcode, giving the statuses that the opcode branches
+//     on and where its steps start in the step table
+//   - a step table of encoded control words, with a block of steps for each
+//     combination of the statuses that its opcode branches on
+// Most opcodes don't branch, so they have a single block of steps instead of
+// one for every combination of every status, and the table doesn't depend on
+// the width of a flat address.
+// The step table is also split across eight byte-wide ROMs, which mirror how
+// the instruction memory would be built in hardware and are kept for
+// inspection.
 class InstructionMemory : public Component {
 public:
+  // Where an opcode's steps are in the step table.
+  struct Header {
+    // The index of the opcode's first step in the step table.
+    uint32_t offset = 0;
+    // The encoded status bits that the opcode branches on.
+    uint32_t status_mask = 0;
+    // The number of steps in each of the opcode's blocks, which is zero for
+    // opcodes that aren't in the table.
+    uint16_t num_steps = 0;
+  };
+
+  // The encoded contents of an instruction memory. Contents never change once
+  // built, so many instruction memories can share them, including across
+  // threads.
+  struct Contents {
+    explicit Contents(const microcode::table::Table &table);
+
+    const InstructionEncoder encoder;
+    // Indexed by opcode.
+    const std::vector<Header> headers;
+    const std::vector<uint64_t> steps;
+    // The buffers of each of the byte-wide ROMs.
+    const std::array<std::shared_ptr<const std::vector<uint8_t>>, 8> roms;
+  };
+
   explicit InstructionMemory(const microcode::table::Table &table,
                              std::string_view name = "instruction_memory",
                              Component *parent = nullptr);
+
+  // Creates an instruction memory with the given contents, which may be shared
+  // with other instruction memories.
+  explicit InstructionMemory(std::shared_ptr<const Contents> contents,
+                             std::string_view name = "instruction_memory",
+                             Component *parent = nullptr);
   virtual ~InstructionMemory() = default;
 
   const InstructionEncoder &encoder() const;
@@ -27,11 +71,44 @@ public:
                                           const CompleteStatuses &statuses,
                                           uint8_t step_index) const;
 
+  // Returns the encoded controls at the given flat address, without decoding
+  // them. Addresses that aren't programmed read as zero.
+  // Throws std::invalid_argument if the table needs more than 16 address bits,
+  // as InstructionEncoder::encode_address does.
+  uint64_t read(uint16_t address) const;
+
+  // Returns the encoded controls for the given opcode, encoded statuses and
+  // step index, without decoding them. Steps that aren't programmed read as
+  // zero.
+  // Throws if the opcode or step index is out of bounds for the table.
+  uint64_t read_encoded(uint8_t opcode, uint32_t encoded_statuses,
+                        uint8_t step_index) const;
+
+  // Returns the header of each opcode, indexed by opcode.
+  const std::vector<Header> &headers() const;
+
+  // Returns the step table, which holds the encoded control words of every
+  // opcode's steps.
+  const std::vector<uint64_t> &steps() const;
+
+  // Returns the byte-wide ROMs that make up the step table. ROM i holds bits
+  // [8*i, 8*i+8) of each encoded control word. The ROMs hold the whole step
+  // table, but ROM::read takes a Word, so only the first 65,536 steps can be
+  // read through it; read_roms reads any step.
+  const std::array<memory::ROM, 8> &roms() const;
+
+  // Returns the encoded control word at the given index of the step table,
+  // assembled from the bytes of the ROMs.
+  // Throws std::out_of_range if the index is past the end of the step table.
+  uint64_t read_roms(size_t index) const;
+
 private:
-  const InstructionEncoder encoder_;
+  const std::shared_ptr<const Contents> contents_;
+  // Cached from contents_, since they're read on every tick.
+  const InstructionEncoder &encoder_;
+  const std::vector<Header> &headers_;
+  const std::vector<uint64_t> &steps_;
   std::array<memory::ROM, 8> roms_;
-
-  uint64_t read(uint16_t address) const;
 };
 
 } // namespace irata::sim::components::controller
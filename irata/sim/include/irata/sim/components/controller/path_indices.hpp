@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace irata::sim::components::controller {
+
+// Numbers the given declarations from 0 in order of path, so that an encoding
+// built from them depends only on which declarations there are and not on
+// where they happen to be allocated.
+// Decl is an hdl declaration type with a path(), such as hdl::ControlDecl.
+// Throws std::invalid_argument if two declarations share a path, naming them
+// by the given kind, e.g. "controls".
+template <typename Decl>
+std::map<const Decl *, size_t>
+build_path_indices(const std::set<const Decl *> &decls, std::string_view kind) {
+  std::vector<std::pair<std::string, const Decl *>> sorted;
+  for (const auto *decl : decls) {
+    sorted.emplace_back(decl->path(), decl);
+  }
+  std::sort(sorted.begin(), sorted.end());
+  std::map<const Decl *, size_t> indices;
+  for (size_t index = 0; index < sorted.size(); ++index) {
+    if (index > 0 && sorted[index].first == sorted[index - 1].first) {
+      throw std::invalid_argument("Multiple " + std::string(kind) +
+                                  " with path " + sorted[index].first);
+    }
+    indices[sorted[index].second] = index;
+  }
+  return indices;
+}
+
+// Returns the declarations numbered by build_path_indices, ordered by index.
+template <typename Decl>
+std::vector<const Decl *>
+by_path_index(const std::map<const Decl *, size_t> &indices) {
+  std::vector<const Decl *> decls(indices.size(), nullptr);
+  for (const auto &[decl, index] : indices) {
+    decls[index] = decl;
+  }
+  return decls;
+}
+
+} // namespace irata::sim::components::controller
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <irata/sim/microcode/table/table.hpp>
+#include <vector>
 
 namespace irata::sim::components::controller {
 
@@ -8,22 +9,28 @@ class PartialStatuses;
 class CompleteStatuses;
 
 // StatusEncoder is responsible for encoding the statuses of the CPU into
-// a single byte that can be used to index into the microcode table.
+// a single word, with a bit per status, that can be used to index into the
+// microcode table.
 class StatusEncoder {
 public:
+  // The most statuses that a table can use.
+  static constexpr size_t max_statuses = 32;
+
+  // Throws std::invalid_argument if the table uses more than max_statuses
+  // statuses.
   explicit StatusEncoder(const microcode::table::Table &table);
   StatusEncoder(const StatusEncoder &) = delete;
   StatusEncoder &operator=(const StatusEncoder &) = delete;
 
   // Permutes the given statuses by setting all unset statuses to true and false
-  // and encodes the resulting statuses into a byte.
-  std::vector<uint8_t> encode(const PartialStatuses &statuses) const;
+  // and encodes the resulting statuses.
+  std::vector<uint32_t> encode(const PartialStatuses &statuses) const;
 
-  // Encodes the given statuses into a byte.
-  uint8_t encode(const CompleteStatuses &statuses) const;
+  // Encodes the given statuses.
+  uint32_t encode(const CompleteStatuses &statuses) const;
 
-  // Decodes the given byte into a map of statuses.
-  CompleteStatuses decode(uint8_t encoded_statuses) const;
+  // Decodes the given encoded statuses into a map of statuses.
+  CompleteStatuses decode(uint32_t encoded_statuses) const;
 
   // Permutes the given statuses by setting all statuses to true and false
   // if they are not already set.
@@ -35,8 +42,17 @@ public:
   // Returns the set of all statuses that are used in the microcode table.
   std::set<const hdl::StatusDecl *> statuses() const;
 
+  // Returns the bit index of each status in the encoded statuses.
+  // Statuses are assigned bits in order of their paths.
+  const std::map<const hdl::StatusDecl *, size_t> &indices() const;
+
+  // Returns the statuses ordered by their bit index in the encoded statuses,
+  // so that bit i corresponds to statuses_by_index()[i].
+  const std::vector<const hdl::StatusDecl *> &statuses_by_index() const;
+
 private:
   const std::map<const hdl::StatusDecl *, size_t> indices_;
+  const std::vector<const hdl::StatusDecl *> statuses_;
 };
 
 } // namespace irata::sim::components::controller
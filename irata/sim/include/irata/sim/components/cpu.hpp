@@ -8,6 +8,7 @@
 #include <irata/sim/components/register.hpp>
 #include <irata/sim/components/status.hpp>
 #include <irata/sim/components/status_register.hpp>
+#include <memory>
 
 namespace irata::sim::components {
 
@@ -15,6 +16,10 @@ class Cpu final : public Component {
 public:
   Cpu(microcode::table::Table microcode_table, ByteBus &data_bus,
       WordBus &address_bus, Component *parent = nullptr);
+  // Creates a cpu whose controller uses the given instruction memory
+  // contents, which may be shared with other cpus.
+  Cpu(std::shared_ptr<const controller::InstructionMemory::Contents> microcode,
+      ByteBus &data_bus, WordBus &address_bus, Component *parent = nullptr);
 
   static Cpu irata(ByteBus &data_bus, WordBus &address_bus,
                    Component *parent = nullptr);
@@ -5,7 +5,10 @@
 #include <irata/sim/components/control.hpp>
 #include <irata/sim/components/cpu.hpp>
 #include <irata/sim/components/memory/memory.hpp>
+#include <irata/sim/profile/profile.hpp>
+#include <irata/sim/trace/recorder.hpp>
 #include <memory>
+#include <optional>
 
 namespace irata::sim::components {
 
@@ -16,7 +19,17 @@ class Irata final : public Component {
 public:
   enum class Result { Halt, Crash };
 
-  explicit Irata(std::unique_ptr<memory::ROM> cartridge = nullptr);
+  // How much is logged while running until halt.
+  enum class LogLevel {
+    // Nothing is logged.
+    Quiet,
+    // The cpu state is logged to stdout before each tick, and each component's
+    // tick messages are logged to stderr.
+    Trace,
+  };
+
+  // Constructs a machine with the given cartridge, if any, mapped at 0x8000.
+  explicit Irata(std::unique_ptr<memory::Module> cartridge = nullptr);
 
   hdl::ComponentType type() const override final;
 
@@ -38,11 +51,43 @@ public:
   const Control &crash() const;
   Control &crash();
 
-  Result tick_until_halt(int max_ticks = -1);
+  // Returns the result of the program if it has halted or crashed.
+  std::optional<Result> result() const;
+
+  Result tick_until_halt(int max_ticks = -1,
+                         LogLevel log_level = LogLevel::Trace);
+
+  // Returns a new machine in the same state as this one. The fork shares the
+  // cartridge and RAM pages with this machine copy-on-write, so afterwards
+  // each machine only copies the RAM pages it writes to.
+  // Forks can run on different threads from each other and from this
+  // machine, but this machine must not be running during the call.
+  std::unique_ptr<Irata> fork() const;
+
+  // Records every following tick to the given recorder, or stops recording if
+  // it's nullptr. The recorder must outlive the recording. Each record is
+  // taken once the buses have been written, and recording costs nothing but
+  // a null check while it's off.
+  void set_recorder(trace::Recorder *recorder);
+  trace::Recorder *recorder() const;
+
+  // Returns the header describing this machine's traces.
+  trace::Header trace_header() const;
+
+  // Counts what every following tick does into the given profile, or stops
+  // counting if it's nullptr. The profile must outlive the counting. Like
+  // recording, counting costs only null checks while it's off.
+  void set_profile(profile::Profile *profile);
+  profile::Profile *profile() const;
 
 protected:
+  std::set<hdl::TickPhase> tick_phases() const override;
+
   void tick_process(Logger &logger) override final;
 
+  void save_state(StateWriter &writer) const override final;
+  void load_state(StateReader &reader) override final;
+
 private:
   ByteBus data_bus_;
   WordBus address_bus_;
@@ -52,6 +97,16 @@ private:
   Control crash_;
   bool halt_received_ = false;
   bool crash_received_ = false;
+  trace::Recorder *recorder_ = nullptr;
+  profile::Profile *profile_ = nullptr;
+  // The encoded control bits that the profile decodes, since controls can't
+  // be read outside their own tick phase. A bit that isn't bound is never
+  // asserted.
+  std::optional<size_t> opcode_read_bit_;
+  std::vector<std::optional<size_t>> alu_opcode_bits_;
+
+  void record_tick();
+  void profile_tick();
 };
 
 } // namespace irata::sim::components
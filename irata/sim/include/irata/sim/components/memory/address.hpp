@@ -71,6 +71,8 @@ public:
   void set_value(Word value);
 
 protected:
+  std::set<hdl::TickPhase> tick_phases() const override;
+
   void tick_write(Logger &logger) override final;
 
   void tick_read(Logger &logger) override final;
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <irata/sim/bytes/byte.hpp>
+#include <irata/sim/bytes/word.hpp>
+#include <irata/sim/components/memory/module.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace irata::sim::components::memory {
+
+// A MappedROM is a read-only memory module backed by a file that is mapped
+// into memory, so opening it doesn't read or copy the file and reads are
+// served straight from the mapping.
+// Addresses past the end of the file read as zero, as with a ROM loaded from
+// a stream.
+// Clones share the mapping, which is unmapped when the last of them is
+// destroyed. The file shouldn't be modified while it's mapped.
+class MappedROM : public Module {
+public:
+  // Creates a new ROM with the given size, mapping the file at the given path
+  // to its start.
+  // The size must be a power of 2.
+  // Throws std::invalid_argument if the file is larger than the ROM, or
+  // std::runtime_error if the file can't be opened or mapped.
+  MappedROM(size_t size, const std::string &path,
+            std::string_view name = "rom");
+  virtual ~MappedROM() = default;
+
+  // Returns the size of the ROM in bytes.
+  size_t size() const override;
+
+  // Returns the size of the mapped file in bytes.
+  size_t file_size() const;
+
+  // Returns the byte at the given address.
+  // Throws an exception if the address is out of range [0,size).
+  Byte read(Word address) const override;
+
+  // Read only.
+  bool can_write() const override { return false; }
+
+  // Throws an exception.
+  void write(Word address, Byte value) override;
+
+  // Returns a copy of the full contents of the ROM.
+  std::vector<uint8_t> dump() const override;
+
+  // Returns a new MappedROM with the same name, sharing this ROM's mapping.
+  std::unique_ptr<Module> clone() const override;
+
+private:
+  class Mapping;
+
+  MappedROM(size_t size, std::shared_ptr<const Mapping> mapping,
+            std::string_view name);
+
+  const std::shared_ptr<const Mapping> mapping_;
+  const size_t size_;
+  // The start of the mapping, cached for reads.
+  const uint8_t *const data_;
+  const size_t file_size_;
+};
+
+} // namespace irata::sim::components::memory
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <irata/sim/bytes/byte.hpp>
 #include <irata/sim/bytes/word.hpp>
 #include <irata/sim/components/bus.hpp>
@@ -9,6 +10,7 @@
 #include <irata/sim/components/memory/region.hpp>
 #include <irata/sim/components/memory/rom.hpp>
 #include <irata/sim/components/word_register.hpp>
+#include <irata/sim/profile/profile.hpp>
 #include <string_view>
 #include <vector>
 
@@ -18,6 +20,9 @@ namespace irata::sim::components::memory {
 // It contains a list of regions, each of which maps a contiguous range of
 // addresses to a module.
 // Regions must be non-overlapping and aligned.
+// Addresses are mapped to regions through a table of 256 byte pages built at
+// construction, so finding the region for an address takes constant time no
+// matter how many regions there are.
 class Memory : public Component {
 public:
   // Builds a memory component with the default irata machine memory layout.
@@ -69,7 +74,13 @@ public:
   // Returns the value at the given address.
   Byte value(Word address) const;
 
+  // Counts reads and writes of each region into the given profile, or stops
+  // counting if it's nullptr. The profile must outlive the counting.
+  void set_profile(profile::Profile *profile);
+
 protected:
+  std::set<hdl::TickPhase> tick_phases() const override;
+
   void tick_write(Logger &logger) override;
   void tick_read(Logger &logger) override;
 
@@ -80,6 +91,18 @@ private:
   Address address_;
   Control write_;
   Control read_;
+  profile::Profile *profile_ = nullptr;
+
+  // The number of low address bits that index into a page.
+  static constexpr size_t page_bits = 8;
+
+  // The region that maps each page of the address space, indexed by the high
+  // byte of the address, or null if the page isn't wholly mapped by one
+  // region.
+  std::array<Region *, 256> pages_ = {};
+  // Marks the pages that are partly mapped by regions smaller than a page.
+  // Addresses in these pages fall back to searching the regions.
+  std::array<bool, 256> partial_pages_ = {};
 
   // Returns the region that contains the given address.
   // Throws an exception if no region contains the given address.
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <cstdint>
 #include <irata/sim/bytes/byte.hpp>
 #include <irata/sim/bytes/word.hpp>
 #include <irata/sim/components/component.hpp>
+#include <memory>
+#include <stdexcept>
 #include <string_view>
+#include <vector>
 
 namespace irata::sim::components::memory {
 
@@ -35,6 +39,25 @@ public:
   // Returns true if the module can be written to.
   // Returns false by default.
   virtual bool can_write() const { return false; }
+
+  // Returns the full contents of the module as a flat buffer of size() bytes.
+  // The default implementation reads every address; modules with contiguous
+  // storage should override this with a bulk copy.
+  virtual std::vector<uint8_t> dump() const {
+    std::vector<uint8_t> bytes(size());
+    for (size_t address = 0; address < bytes.size(); ++address) {
+      bytes[address] = read(Word(address));
+    }
+    return bytes;
+  }
+
+  // Returns a new module with the same name and contents, for use in a forked
+  // machine. Read-only modules share their storage with the clone.
+  // Throws an exception for modules that can't be cloned, which is the
+  // default.
+  virtual std::unique_ptr<Module> clone() const {
+    throw std::logic_error("module " + path() + " can't be cloned");
+  }
 };
 
 } // namespace irata::sim::components::memory
@@ -1,16 +1,26 @@
 #pragma once
 
+#include <cstdint>
 #include <irata/sim/bytes/byte.hpp>
 #include <irata/sim/bytes/word.hpp>
 #include <irata/sim/components/memory/module.hpp>
 #include <map>
+#include <memory>
 #include <string_view>
+#include <vector>
 
 namespace irata::sim::components::memory {
 
 // A RAM module that can be read from and written to.
+// The contents are stored in fixed size pages, so reads and writes are a page
+// lookup and a direct indexed load or store.
+// Pages can be shared copy-on-write with other RAMs of the same size, so that a
+// forked machine only copies the pages it writes to.
 class RAM : public Module {
 public:
+  // The size of a page in bytes. RAMs smaller than this have a single page.
+  static constexpr size_t page_size = 0x100;
+
   // Creates a new RAM module with the given size in bytes.
   // The size must be a power of 2.
   // The data is a map from addresses to bytes. If an address is not in the
@@ -18,16 +28,30 @@ public:
   // Addresses must be in the range [0, size).
   explicit RAM(size_t size, std::string_view name = "ram",
                std::map<Word, Byte> data = {});
+
+  // Creates a new RAM module with the given size in bytes, initialized from
+  // a flat buffer starting at address 0. Bytes past the end of the buffer are
+  // zero.
+  // Throws an exception if the buffer is larger than the RAM.
+  RAM(size_t size, std::vector<uint8_t> bytes, std::string_view name = "ram");
   virtual ~RAM() = default;
 
   // Returns the size of the RAM in bytes.
   size_t size() const override;
 
-  // Returns the data in the RAM.
-  // This is a map from addresses to bytes. If an address is not in the map, it
-  // is assumed to be zero.
-  const std::map<Word, Byte> &data() const;
-  std::map<Word, Byte> &data();
+  // Returns a sparse view of the data in the RAM.
+  // This is a map from addresses to bytes containing every non-zero byte. If
+  // an address is not in the map, its value is zero.
+  // This builds a new map on every call and is intended for inspection and
+  // tests; use dump() for bulk access.
+  std::map<Word, Byte> data() const;
+
+  // Copies the given bytes into the RAM starting at the given address.
+  // Throws an exception if the bytes don't fit in [address, size).
+  void load(const std::vector<uint8_t> &bytes, Word address = Word(0x0000));
+
+  // Returns a copy of the full contents of the RAM.
+  std::vector<uint8_t> dump() const override;
 
   // Returns the byte at the given address.
   Byte read(Word address) const override;
@@ -38,9 +62,38 @@ public:
   // RAM is writable.
   bool can_write() const override { return true; }
 
+  // Makes this RAM share all of other's pages, discarding its own contents.
+  // Shared pages are copied by whichever RAM writes to them first, so neither
+  // RAM sees the other's later writes.
+  // Sharing is safe between RAMs used on different threads, but other must not
+  // be written to during the call.
+  // Throws an exception if the RAMs are different sizes.
+  void share(const RAM &other);
+
+  // Returns the number of pages that are currently shared with another RAM.
+  size_t num_shared_pages() const;
+
+protected:
+  void save_state(StateWriter &writer) const override;
+  void load_state(StateReader &reader) override;
+
+  // Shares the source's pages if it's a RAM.
+  bool share_state(const Component &source) override;
+
 private:
+  using Page = std::vector<uint8_t>;
+
   const size_t size_;
-  std::map<Word, Byte> data_;
+  // The number of low address bits that index into a page.
+  const size_t page_bits_;
+  std::vector<std::shared_ptr<Page>> pages_;
+
+  // Returns the page containing the given address, copying it first if it's
+  // shared so that it can be written to.
+  Page &writable_page(size_t address);
+
+  // Copies a flat buffer of size() bytes into fresh pages.
+  void set_pages(const std::vector<uint8_t> &bytes);
 };
 
-} // namespace irata::sim::components::memory
\ No newline at end of file
+} // namespace irata::sim::components::memory
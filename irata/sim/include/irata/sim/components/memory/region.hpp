@@ -42,6 +42,9 @@ public:
   // Returns true if the region can be written to.
   bool can_write() const;
 
+  // Returns the module mapped by this region.
+  const Module &module() const;
+
   // Returns true if this region overlaps with the given region.
   // This should never happen, as regions are required to be non-overlapping.
   bool overlaps(const Region &other) const;
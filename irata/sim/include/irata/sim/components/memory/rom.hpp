@@ -1,14 +1,21 @@
 #pragma once
 
+#include <cstdint>
 #include <irata/sim/bytes/byte.hpp>
 #include <irata/sim/bytes/word.hpp>
 #include <irata/sim/components/memory/module.hpp>
+#include <istream>
 #include <map>
+#include <memory>
 #include <string_view>
+#include <vector>
 
 namespace irata::sim::components::memory {
 
 // A ROM is a read-only memory module.
+// The contents are stored in a contiguous buffer of size() bytes, so reads are
+// direct indexed loads. The buffer is immutable, so clones of a ROM use the
+// same buffer, including from different threads.
 class ROM : public Module {
 public:
   // Creates a new ROM with the given size and data.
@@ -17,14 +24,41 @@ public:
   // Addresses must be within the range [0, size).
   explicit ROM(size_t size, std::string_view name = "rom",
                std::map<Word, Byte> data = {});
+
+  // Creates a new ROM with the given size, initialized from a flat buffer
+  // starting at address 0. Bytes past the end of the buffer are zero.
+  // Throws an exception if the buffer is larger than the ROM.
+  ROM(size_t size, std::vector<uint8_t> bytes, std::string_view name = "rom");
+
+  // Creates a new ROM with the given size, loading its contents from the
+  // given stream. Bytes past the end of the stream are zero.
+  // Throws an exception if the stream holds more than size bytes.
   ROM(size_t size, std::istream &is, std::string_view name = "rom");
+
+  // Creates a new ROM backed by the given buffer, which may be shared with
+  // other ROMs. The buffer's size must be a power of 2.
+  ROM(std::shared_ptr<const std::vector<uint8_t>> bytes,
+      std::string_view name = "rom");
   virtual ~ROM() = default;
 
+  // Returns a new ROM with the same name and contents, sharing this ROM's
+  // buffer.
+  std::unique_ptr<Module> clone() const override;
+
   // Returns the size of the ROM in bytes.
   size_t size() const override;
 
-  // Returns the data of the ROM.
-  const std::map<Word, Byte> &data() const;
+  // Returns a sparse view of the data of the ROM.
+  // This is a map from addresses to bytes containing every non-zero byte.
+  // This builds a new map on every call and is intended for inspection and
+  // tests; use bytes() for bulk access.
+  std::map<Word, Byte> data() const;
+
+  // Returns the contiguous backing store of the ROM, of size() bytes.
+  const std::vector<uint8_t> &bytes() const;
+
+  // Returns a copy of the full contents of the ROM.
+  std::vector<uint8_t> dump() const override;
 
   // Returns the byte at the given address.
   // Throws an exception if the address is out of range [0,size).
@@ -38,7 +72,9 @@ public:
 
 private:
   const size_t size_;
-  const std::map<Word, Byte> data_;
+  const std::shared_ptr<const std::vector<uint8_t>> bytes_;
+  // The start of bytes_, cached for reads.
+  const uint8_t *const data_;
 };
 
 } // namespace irata::sim::components::memory
@@ -59,6 +59,8 @@ public:
   void set_reset(bool value);
 
 protected:
+  std::set<hdl::TickPhase> tick_phases() const override;
+
   // Handle writing to the bus.
   void tick_write(Logger &logger) override;
   // Handle reading from the bus.
@@ -68,6 +70,9 @@ protected:
 
   void serialize(Serializer &serializer) const override;
 
+  void save_state(StateWriter &writer) const override;
+  void load_state(StateReader &reader) override;
+
 private:
   Byte value_;
   Bus<Byte> *const bus_;
@@ -23,6 +23,10 @@ public:
 
   hdl::ComponentType type() const override final;
 
+protected:
+  void save_state(StateWriter &writer) const override;
+  void load_state(StateReader &reader) override;
+
 private:
   bool value_ = false;
 };
@@ -46,6 +46,8 @@ public:
   const Control &clear_carry() const;
 
 protected:
+  std::set<hdl::TickPhase> tick_phases() const override;
+
   void tick_process(Logger &logger) override final;
 
   void tick_clear(Logger &logger) override final;
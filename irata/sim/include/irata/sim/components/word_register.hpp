@@ -76,6 +76,8 @@ public:
   void set_reset(bool reset);
 
 protected:
+  std::set<hdl::TickPhase> tick_phases() const override;
+
   // Writes to the bus if the register is connected to a bus and the write
   // control line is asserted.
   void tick_write(Logger &logger) override;
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <irata/sim/components/irata.hpp>
+#include <irata/sim/interpreter/interpreter.hpp>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace irata::sim::interpreter {
+
+// DifferentialChecker runs a cartridge on the Interpreter and on
+// components::Irata in lockstep and compares the two at every instruction
+// boundary, which for the simulated machine is whenever the controller's step
+// counter returns to 0.
+// At each boundary it compares the registers, the status register and lines,
+// the program result and the contents of RAM, and stops at the first
+// difference.
+class DifferentialChecker {
+public:
+  // A difference between the two engines at an instruction boundary.
+  struct Divergence {
+    // The number of instructions that both engines had executed when they
+    // diverged.
+    uint64_t instruction_count;
+    // The address of the last instruction executed, if any.
+    std::optional<Word> pc;
+    // The name of the last instruction executed, if it was a known opcode.
+    std::string instruction;
+    // A line per difference, in the form "<what>: interpreter=<x> sim=<y>".
+    std::vector<std::string> differences;
+  };
+
+  // Constructs a checker for the given cartridge. The cartridge is padded with
+  // zeros to a power of two so that both engines map the same bytes.
+  // Throws std::invalid_argument if the cartridge doesn't fit at 0x8000.
+  explicit DifferentialChecker(const std::vector<uint8_t> &cartridge);
+
+  const Interpreter &interpreter() const;
+  const components::Irata &irata() const;
+
+  // Runs both engines until they halt, crash or diverge.
+  // Returns the first divergence, or nullopt if the engines agreed all the
+  // way to the end of the program.
+  // An exception thrown by only one engine is reported as a divergence. If
+  // both engines throw, the interpreter's exception is rethrown.
+  // Throws std::runtime_error if max_instructions is non-negative and that
+  // many instructions are executed without halting.
+  std::optional<Divergence> run(int max_instructions = -1);
+
+  // Returns a random program of the given number of instructions followed by
+  // a hlt. The program only touches RAM, only jumps forwards and never calls
+  // subroutines, so it always runs to the hlt on a correct machine.
+  static std::vector<uint8_t> random_program(std::mt19937 &rng,
+                                             size_t num_instructions);
+
+private:
+  // The maximum number of ticks the simulated machine may take to get from one
+  // instruction boundary to the next.
+  static constexpr int max_ticks_per_instruction = 256;
+
+  // The padded cartridge that both engines run.
+  const std::vector<uint8_t> cartridge_;
+  Interpreter interpreter_;
+  components::Irata irata_;
+
+  // Ticks the simulated machine until it reaches the next instruction boundary
+  // or stops.
+  void step_irata();
+
+  // Returns the differences between the two engines' current states.
+  std::vector<std::string> compare() const;
+};
+
+std::ostream &operator<<(std::ostream &os,
+                         const DifferentialChecker::Divergence &divergence);
+
+} // namespace irata::sim::interpreter
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <irata/asm/instruction.hpp>
+#include <irata/sim/bytes/byte.hpp>
+#include <irata/sim/bytes/word.hpp>
+#include <irata/sim/hdl/alu_opcode.hpp>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+namespace irata::sim::interpreter {
+
+// Interpreter runs irata programs one instruction at a time against a flat 64K
+// memory image, without simulating the components of the machine.
+// It follows the register and status semantics of components::Cpu exactly, so
+// a program run by the interpreter ends in the same state as the same program
+// run by components::Irata, but with no visibility into individual ticks.
+// The memory layout matches components::memory::Memory::irata: 8K of RAM at
+// 0x0000 and the cartridge, if any, mapped read-only at 0x8000.
+class Interpreter {
+public:
+  enum class Result { Halt, Crash };
+
+  // A set of status flags.
+  struct Flags {
+    bool carry = false;
+    bool zero = false;
+    bool negative = false;
+    bool overflow = false;
+
+    bool operator==(const Flags &other) const;
+    bool operator!=(const Flags &other) const;
+  };
+
+  // Constructs an interpreter with the given cartridge mapped at 0x8000.
+  // Throws std::invalid_argument if the cartridge doesn't fit in the
+  // cartridge region.
+  explicit Interpreter(const std::vector<uint8_t> &cartridge = {});
+
+  // The address that the cartridge is mapped at, which is also the initial pc.
+  static constexpr uint16_t cartridge_address = 0x8000;
+  // The size of RAM, which is mapped at address 0x0000.
+  static constexpr uint16_t ram_size = 0x2000;
+
+  Byte a() const;
+  void set_a(Byte value);
+
+  Byte x() const;
+  void set_x(Byte value);
+
+  Byte y() const;
+  void set_y(Byte value);
+
+  Byte stack_pointer() const;
+  void set_stack_pointer(Byte value);
+
+  Word pc() const;
+  void set_pc(Word value);
+
+  // Returns the value of the status register.
+  Byte status_register() const;
+
+  // Returns the status lines driven by the status register. These are what
+  // branches test and what the alu reads its carry from.
+  const Flags &status() const;
+
+  // Returns the status flags last produced by the alu. These are latched into
+  // the status register by every alu operation, including address arithmetic,
+  // which doesn't update them.
+  const Flags &alu_flags() const;
+
+  // Reads a byte from memory. Throws std::runtime_error if the address isn't
+  // mapped.
+  Byte read(Word address) const;
+
+  // Writes a byte to memory. Throws std::runtime_error if the address isn't
+  // in RAM.
+  void write(Word address, Byte value);
+
+  // Returns the whole 64K memory image.
+  const std::vector<uint8_t> &memory() const;
+
+  // Returns the number of instructions executed so far.
+  uint64_t instruction_count() const;
+
+  // Returns the result of the program if it has halted or crashed.
+  std::optional<Result> result() const;
+
+  // Executes the instruction at pc. Does nothing if the program has already
+  // halted or crashed.
+  // Returns the result of the program if it has halted or crashed.
+  // Throws std::runtime_error if the opcode at pc isn't a known instruction.
+  std::optional<Result> step();
+
+  // Executes instructions until the program halts or crashes.
+  // Throws std::runtime_error if max_instructions is non-negative and that
+  // many instructions are executed without halting.
+  Result run(int max_instructions = -1);
+
+  // Serializes the registers and statuses to the given output stream.
+  void serialize(std::ostream &os) const;
+
+private:
+  std::vector<uint8_t> memory_;
+  uint32_t cartridge_end_;
+
+  uint8_t a_ = 0;
+  uint8_t x_ = 0;
+  uint8_t y_ = 0;
+  uint8_t stack_pointer_ = 0xFF;
+  uint16_t pc_ = cartridge_address;
+  uint8_t status_register_ = 0;
+  Flags status_;
+  Flags alu_flags_;
+
+  uint64_t instruction_count_ = 0;
+  std::optional<Result> result_;
+
+  uint8_t read_byte(uint16_t address) const;
+  void write_byte(uint16_t address, uint8_t value);
+
+  // Reads the byte at pc and increments pc.
+  uint8_t fetch();
+  // Reads the big-endian word at pc and advances pc past it.
+  uint16_t fetch_word();
+
+  // Returns the address of the operand of an instruction with the given
+  // addressing mode, advancing pc past the operand.
+  uint16_t operand_address(asm_::AddressingMode addressing_mode);
+
+  // Runs an alu operation, updating the alu flags and latching them into the
+  // status register. Returns the alu result.
+  uint8_t alu(hdl::AluOpcode opcode, uint8_t lhs, uint8_t rhs);
+
+  void push(uint8_t value);
+  uint8_t pop();
+
+  void set_carry(bool value);
+};
+
+std::ostream &operator<<(std::ostream &os, Interpreter::Result result);
+
+} // namespace irata::sim::interpreter
@@ -1,30 +1,131 @@
 #pragma once
 
+#include <cstdint>
+#include <irata/sim/microcode/compiler/ir/control_registry.hpp>
+#include <irata/sim/microcode/compiler/passes/instruction_pass.hpp>
 #include <irata/sim/microcode/compiler/passes/pass.hpp>
+#include <irata/sim/microcode/compiler/worker_pool.hpp>
 #include <irata/sim/microcode/dsl/instruction_set.hpp>
 #include <irata/sim/microcode/table/table.hpp>
+#include <istream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string_view>
 #include <vector>
 
 namespace irata::sim::microcode::compiler {
 
 class Compiler {
 public:
-  explicit Compiler(std::vector<std::unique_ptr<passes::Pass>> passes);
+  // Returns a hash of the sources of the compiler, its passes, the DSL and
+  // the HDL, generated by the build. Microcode images record it in their hash,
+  // so that an image compiled by different code isn't loaded.
+  static uint64_t fingerprint();
+
+  // Returns a hash of the sources in fingerprint() other than the irata
+  // instruction set, generated by the build. Compiled instruction caches record
+  // it, so that editing the instruction set keeps the cached results of the
+  // instructions that didn't change, while editing the passes discards them.
+  static uint64_t pass_fingerprint();
+
+  // Constructs a compiler that runs the given passes in order.
+  // Each run of consecutive passes::InstructionPasses is run on up to
+  // num_threads instructions at once, or on one per hardware thread if
+  // num_threads is 0, by a pool of worker threads that lives as long as the
+  // compiler. The compiler remembers what each run produced for each
+  // instruction in the last instruction set it compiled, so compiling an
+  // edited instruction set only reruns those passes on instructions that
+  // changed. save_cache and load_cache carry those results between processes.
+  explicit Compiler(std::vector<std::unique_ptr<passes::Pass>> passes,
+                    size_t num_threads = 0);
   Compiler(const Compiler &) = delete;
   Compiler &operator=(const Compiler &) = delete;
 
   static const Compiler &irata();
 
+  // Returns the passes used by irata(). Without list scheduling, steps are
+  // only merged with their neighbours, and without fetch overlap, each
+  // instruction's fetch starts after the previous instruction ends. Turning
+  // these off is useful as a baseline for measuring them. Microcode compiled
+  // with fetch overlap expects the machine to start with the pc in the memory
+  // address register.
+  static std::vector<std::unique_ptr<passes::Pass>>
+  irata_passes(bool list_schedule = true, bool overlap_fetch = true);
+
+  // Returns the registry to compile the given instruction set with, which
+  // holds the controls that its steps use and the controls that the passes
+  // add. The registry of the last instruction set compiled is reused if it
+  // holds all of those, and grown with them otherwise, so that the results for
+  // the last instruction set can be carried over.
+  std::shared_ptr<const ir::ControlRegistry>
+  registry(const dsl::InstructionSet &instruction_set) const;
+
+  // Compiles the given instruction set.
   ir::InstructionSet
   compile_to_ir(const dsl::InstructionSet &instruction_set) const;
 
+  // Writes the instruction pass results that the compiler remembers for the
+  // last instruction set it compiled, recording pass_fingerprint().
+  void save_cache(std::ostream &os) const;
+
+  // Replaces the instruction pass results that the compiler remembers with the
+  // results in a cache written by save_cache, resolving them against the given
+  // instruction set, which should be the next one compiled. Results for
+  // instructions that aren't in the instruction set are dropped.
+  // Returns false and leaves the results alone if the cache was written by
+  // other pass code or a compiler with other passes.
+  // Throws std::runtime_error if the cache is truncated or malformed.
+  bool load_cache(std::istream &is,
+                  const dsl::InstructionSet &instruction_set) const;
+
+  // Compiles the given instruction set to a table, as compile_to_ir does.
   table::Table compile(const dsl::InstructionSet &instruction_set) const;
 
   static table::Table compile_irata();
 
+  // Returns the irata microcode image that the build embeds in the library,
+  // generated by the microcode tool. It's empty in the microcode tool itself.
+  static std::string_view irata_image();
+
+  // Returns the irata microcode table, loading it from irata_image() if that
+  // matches the current instruction set and compiler and compiling it
+  // otherwise. The table is only loaded or compiled once per process.
+  static const table::Table &irata_table();
+
+  // Returns true if irata_table() was loaded from the microcode image rather
+  // than compiled, loading or compiling it if it hasn't been yet.
+  static bool irata_table_loaded_from_image();
+
+  size_t num_threads() const;
+
 private:
+  // Either a pass over the whole instruction set, or a run of consecutive
+  // instruction passes along with their results for the last instruction set,
+  // by input instruction, and the registry that those were compiled with.
+  struct Segment {
+    passes::Pass *pass = nullptr;
+    std::vector<const passes::InstructionPass *> instruction_passes;
+    std::map<ir::Instruction, ir::Instruction> results;
+    std::shared_ptr<const ir::ControlRegistry> registry;
+  };
+
   const std::vector<std::unique_ptr<passes::Pass>> passes_;
+  // Runs the instruction passes. Its workers are shared by concurrent
+  // compiles.
+  mutable WorkerPool pool_;
+  // The controls that the passes add.
+  std::set<const hdl::ControlDecl *> added_controls_;
+  // Guards registry_ and the results in segments_.
+  mutable std::mutex mutex_;
+  mutable std::shared_ptr<const ir::ControlRegistry> registry_;
+  mutable std::vector<Segment> segments_;
+
+  ir::InstructionSet
+  run_segment(Segment &segment, const ir::InstructionSet &instruction_set,
+              const std::shared_ptr<const ir::ControlRegistry> &registry) const;
 };
 
 } // namespace irata::sim::microcode::compiler
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <irata/sim/hdl/bus_decl.hpp>
+#include <irata/sim/hdl/control_decl.hpp>
+#include <irata/sim/hdl/tick_phase.hpp>
+#include <irata/sim/microcode/compiler/ir/control_set.hpp>
+#include <map>
+#include <optional>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace irata::sim::microcode::compiler::ir {
+
+// ControlRegistry assigns each control that can appear in a compiled
+// instruction a dense id, which is its bit in a ControlSet.
+// The compiler builds one from the controls of the instruction set it compiles
+// and the controls its passes add.
+// Ids are assigned in order of control path, so that they depend only on the
+// controls and not on where they happen to be allocated.
+// The registry also keeps the set of controls for each tick phase and each
+// bus, so that passes can check phases and bus usage with bit operations.
+class ControlRegistry {
+public:
+  // Constructs a registry of the given controls.
+  // The controls must be non-null and there can be at most
+  // ControlSet::max_controls of them.
+  explicit ControlRegistry(const std::set<const hdl::ControlDecl *> &controls);
+  ControlRegistry(const ControlRegistry &) = delete;
+  ControlRegistry &operator=(const ControlRegistry &) = delete;
+
+  // Returns the id of the given control, or nullopt if it isn't registered.
+  std::optional<size_t> id(const hdl::ControlDecl &control) const;
+
+  // Returns the control with the given id.
+  const hdl::ControlDecl &control(size_t id) const;
+
+  // Returns the number of registered controls.
+  size_t size() const;
+
+  // Returns the registered controls that run in the given phase.
+  const ControlSet &phase_controls(hdl::TickPhase phase) const;
+
+  // Returns the registered write controls.
+  const ControlSet &write_controls() const;
+
+  // Returns the registered read controls.
+  const ControlSet &read_controls() const;
+
+  // Returns the registered controls that write to or read from each bus.
+  const std::map<const hdl::BusDecl *, ControlSet> &bus_controls() const;
+
+private:
+  std::vector<const hdl::ControlDecl *> controls_;
+  std::unordered_map<const hdl::ControlDecl *, size_t> ids_;
+  std::map<hdl::TickPhase, ControlSet> phase_controls_;
+  ControlSet write_controls_;
+  ControlSet read_controls_;
+  std::map<const hdl::BusDecl *, ControlSet> bus_controls_;
+};
+
+} // namespace irata::sim::microcode::compiler::ir
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <irata/sim/hdl/control_decl.hpp>
+#include <iterator>
+
+namespace irata::sim::microcode::compiler::ir {
+
+class ControlRegistry;
+
+// ControlSet is a set of controls stored as a fixed width bitset, indexed by
+// the ids that a ControlRegistry assigns to controls.
+// Each set belongs to the registry it was constructed with, which must outlive
+// it. Sets can only be combined with sets of the same registry.
+// Unions, intersections and comparisons are word-wide bit operations, so steps
+// can be merged and compared without allocating.
+// Iterates over controls in id order, which is the order of their paths.
+// Trivially copyable.
+class ControlSet {
+public:
+  static constexpr size_t max_controls = 128;
+
+  using value_type = const hdl::ControlDecl *;
+
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = const hdl::ControlDecl *;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type *;
+    using reference = value_type;
+
+    value_type operator*() const;
+    const_iterator &operator++();
+    const_iterator operator++(int);
+
+    bool operator==(const const_iterator &other) const;
+    bool operator!=(const const_iterator &other) const;
+
+  private:
+    friend class ControlSet;
+
+    const_iterator(const ControlSet &set, size_t id);
+
+    const ControlSet *set_;
+    size_t id_;
+  };
+
+  using iterator = const_iterator;
+
+  // Constructs an empty set of the given registry's controls.
+  explicit ControlSet(const ControlRegistry &registry);
+
+  // Constructs a set of the given controls.
+  // Throws if any control is null or not registered in the given registry.
+  ControlSet(const ControlRegistry &registry,
+             std::initializer_list<const hdl::ControlDecl *> controls);
+
+  // Constructs a set of the given controls, which can be any range of
+  // controls, such as a std::set or a ControlSet of another registry.
+  // Throws if any control is null or not registered in the given registry.
+  template <typename Controls>
+  ControlSet(const ControlRegistry &registry, const Controls &controls)
+      : ControlSet(registry) {
+    for (const auto *control : controls) {
+      insert(control);
+    }
+  }
+
+  // Returns the registry that this set's controls are registered in.
+  const ControlRegistry &registry() const;
+
+  // Adds the given control to this set.
+  // Throws if the control is null or not registered.
+  void insert(const hdl::ControlDecl *control);
+
+  // Removes the given control from this set, if present.
+  void erase(const hdl::ControlDecl *control);
+
+  // Returns 1 if the control is in this set and 0 otherwise, like std::set.
+  size_t count(const hdl::ControlDecl *control) const;
+
+  // Returns the number of controls in this set.
+  size_t size() const;
+
+  bool empty() const;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  // Set union, intersection and difference.
+  // Throws if the sets belong to different registries.
+  ControlSet &operator|=(const ControlSet &other);
+  ControlSet &operator&=(const ControlSet &other);
+  ControlSet &operator-=(const ControlSet &other);
+  ControlSet operator|(const ControlSet &other) const;
+  ControlSet operator&(const ControlSet &other) const;
+  ControlSet operator-(const ControlSet &other) const;
+
+  // Sets are compared by their controls, so sets of different registries can
+  // be compared too, though more slowly. Sets are ordered by the last control,
+  // in path order, that is in only one of them.
+  bool operator==(const ControlSet &other) const;
+  bool operator!=(const ControlSet &other) const;
+  bool operator<(const ControlSet &other) const;
+
+private:
+  friend class ControlRegistry;
+
+  static constexpr size_t bits_per_word = 64;
+  static constexpr size_t num_words = max_controls / bits_per_word;
+
+  bool test(size_t id) const;
+  void set(size_t id);
+
+  // Returns the lowest id in this set that is at least id, or max_controls if
+  // there is none.
+  size_t next(size_t id) const;
+
+  // Throws if the other set belongs to a different registry.
+  void check_registry(const ControlSet &other) const;
+
+  const ControlRegistry *registry_;
+  std::array<uint64_t, num_words> words_{};
+};
+
+} // namespace irata::sim::microcode::compiler::ir
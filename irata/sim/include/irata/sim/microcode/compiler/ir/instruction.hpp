@@ -22,7 +22,10 @@ public:
               std::map<const hdl::StatusDecl *, bool> statuses);
 
   // Creates a new instruction based on the given dsl instruction.
-  explicit Instruction(const dsl::Instruction &instruction);
+  // Throws std::invalid_argument if the instruction uses a control that isn't
+  // registered in the given registry.
+  Instruction(const ControlRegistry &registry,
+              const dsl::Instruction &instruction);
 
   // Returns the instruction descriptor for this instruction.
   const asm_::Instruction &descriptor() const;
@@ -1,25 +1,44 @@
 #pragma once
 
+#include <irata/sim/microcode/compiler/ir/control_registry.hpp>
 #include <irata/sim/microcode/compiler/ir/instruction.hpp>
 #include <irata/sim/microcode/dsl/instruction_set.hpp>
+#include <memory>
 #include <set>
 
 namespace irata::sim::microcode::compiler::ir {
 
 class InstructionSet {
 public:
-  explicit InstructionSet(std::set<Instruction> instructions);
-
+  // Constructs an instruction set of the given instructions.
+  // If a registry is given, the instruction set keeps it alive for as long as
+  // its instructions are used, so it should be the registry their steps'
+  // controls are registered in.
+  explicit InstructionSet(
+      std::set<Instruction> instructions,
+      std::shared_ptr<const ControlRegistry> registry = nullptr);
+
+  // Converts the given dsl instruction set, with a registry of just the
+  // controls that it uses.
   explicit InstructionSet(const dsl::InstructionSet &instruction_set);
 
+  // Converts the given dsl instruction set, whose controls must be registered
+  // in the given registry.
+  InstructionSet(std::shared_ptr<const ControlRegistry> registry,
+                 const dsl::InstructionSet &instruction_set);
+
   const std::set<Instruction> &instructions() const;
 
+  // Returns the registry that this instruction set keeps alive, if any.
+  const std::shared_ptr<const ControlRegistry> &registry() const;
+
   bool operator==(const InstructionSet &other) const;
   bool operator!=(const InstructionSet &other) const;
   bool operator<(const InstructionSet &other) const;
 
 private:
   std::set<Instruction> instructions_;
+  std::shared_ptr<const ControlRegistry> registry_;
 };
 
 std::ostream &operator<<(std::ostream &os,
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <irata/sim/hdl/control_decl.hpp>
+#include <irata/sim/microcode/compiler/ir/control_registry.hpp>
+#include <irata/sim/microcode/compiler/ir/control_set.hpp>
 #include <irata/sim/microcode/dsl/step.hpp>
 #include <ostream>
 #include <set>
@@ -14,38 +16,47 @@ class Step {
 public:
   // Constructs a step from a set of controls, write controls, and read
   // controls.
-  // The controls must be non-null.
-  // The write controls and read controls must be a subset of the controls.
-  Step(std::set<const hdl::ControlDecl *> controls,
-       std::set<const hdl::WriteControlDecl *> write_controls,
-       std::set<const hdl::ReadControlDecl *> read_controls, int stage);
+  // The write controls and read controls must be a subset of the controls,
+  // and must be write and read controls respectively. All three sets must
+  // belong to the same registry.
+  Step(ControlSet controls, ControlSet write_controls,
+       ControlSet read_controls, int stage);
 
-  // Constructs a step from a DSL step.
-  explicit Step(const dsl::Step &step);
+  // Constructs a step from controls registered in the given registry.
+  // Throws if any control isn't registered.
+  Step(const ControlRegistry &registry,
+       const std::set<const hdl::ControlDecl *> &controls,
+       const std::set<const hdl::WriteControlDecl *> &write_controls,
+       const std::set<const hdl::ReadControlDecl *> &read_controls,
+       int stage);
+
+  // Constructs a step from a DSL step whose controls are registered in the
+  // given registry.
+  Step(const ControlRegistry &registry, const dsl::Step &step);
 
   bool operator==(const Step &other) const;
   bool operator!=(const Step &other) const;
   bool operator<(const Step &other) const;
 
   // Returns the controls in this step.
-  const std::set<const hdl::ControlDecl *> &controls() const;
+  const ControlSet &controls() const;
 
   // Returns the write controls in this step.
   // This is a subset of the controls in this step.
-  const std::set<const hdl::WriteControlDecl *> &write_controls() const;
+  const ControlSet &write_controls() const;
 
   // Returns the read controls in this step.
   // This is a subset of the controls in this step.
-  const std::set<const hdl::ReadControlDecl *> &read_controls() const;
+  const ControlSet &read_controls() const;
 
   // Returns the stage of this step.
   // Instruction stages are sets of steps that can be merged.
   int stage() const;
 
 private:
-  std::set<const hdl::ControlDecl *> controls_;
-  std::set<const hdl::WriteControlDecl *> write_controls_;
-  std::set<const hdl::ReadControlDecl *> read_controls_;
+  ControlSet controls_;
+  ControlSet write_controls_;
+  ControlSet read_controls_;
   int stage_;
 };
 
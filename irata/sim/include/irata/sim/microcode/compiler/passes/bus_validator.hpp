@@ -1,7 +1,7 @@
 #pragma once
 
 #include <irata/sim/microcode/compiler/ir/instruction_set.hpp>
-#include <irata/sim/microcode/compiler/passes/pass.hpp>
+#include <irata/sim/microcode/compiler/passes/instruction_pass.hpp>
 
 namespace irata::sim::microcode::compiler::passes {
 
@@ -11,9 +11,10 @@ namespace irata::sim::microcode::compiler::passes {
 // Note that this allows for multiple buses to be written and read in the same
 // step, as long as each bus is written by exactly one control and read by at
 // least one control.
-class BusValidator : public Pass {
+class BusValidator : public InstructionPass {
 public:
-  ir::InstructionSet run(const ir::InstructionSet &instruction_set) override;
+  ir::Instruction
+  run_instruction(const ir::Instruction &instruction) const override;
 };
 
 } // namespace irata::sim::microcode::compiler::passes
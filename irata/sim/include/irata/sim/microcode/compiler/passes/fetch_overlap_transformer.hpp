@@ -0,0 +1,33 @@
+#pragma once
+
+#include <irata/sim/microcode/compiler/passes/instruction_pass.hpp>
+
+namespace irata::sim::microcode::compiler::passes {
+
+// Overlaps the start of each instruction's fetch with the end of the previous
+// instruction.
+// The fetch stage starts by loading the memory address register from the pc,
+// and then reads the opcode at that address. This moves that first transfer
+// out of the fetch stage and to the end of each instruction, so that the next
+// instruction's fetch reads its opcode straight away. The transfer gets a step
+// of its own, which a later scheduling pass can pack into the instruction's
+// last steps where that doesn't introduce a hazard.
+// The machine must start with the pc in the memory address register, since
+// nothing runs the transfer before the first instruction.
+// Only the transfer is overlapped. The opcode read stays in the fetch stage,
+// because it can't share a step with the transfer: memory writes the opcode
+// to the data bus in the write phase, before the address register reads the
+// pc in the read phase. The transfer can't go earlier than the instruction's
+// last memory access or pc change, and in the irata instruction set that puts
+// it in the last step of every instruction, so an opcode read moved to the end
+// of the instruction would take a step of its own. That would save no ticks,
+// and would leave the pc past the next opcode at instruction boundaries.
+class FetchOverlapTransformer : public InstructionPass {
+public:
+  ir::Instruction
+  run_instruction(const ir::Instruction &instruction) const override;
+
+  std::set<const hdl::ControlDecl *> added_controls() const override;
+};
+
+} // namespace irata::sim::microcode::compiler::passes
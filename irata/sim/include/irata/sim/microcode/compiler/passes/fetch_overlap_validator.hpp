@@ -0,0 +1,18 @@
+#pragma once
+
+#include <irata/sim/microcode/compiler/passes/instruction_pass.hpp>
+
+namespace irata::sim::microcode::compiler::passes {
+
+// Verifies that each instruction loads the memory address register from the pc
+// after its fetch stage for the next instruction's fetch, and that nothing in
+// or after the step that does so conflicts with that transfer: nothing else
+// uses the address bus or changes the pc after the transfer reads it, and the
+// memory isn't accessed after the transfer changes its address.
+class FetchOverlapValidator : public InstructionPass {
+public:
+  ir::Instruction
+  run_instruction(const ir::Instruction &instruction) const override;
+};
+
+} // namespace irata::sim::microcode::compiler::passes
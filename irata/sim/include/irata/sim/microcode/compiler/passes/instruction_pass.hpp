@@ -0,0 +1,24 @@
+#pragma once
+
+#include <irata/sim/microcode/compiler/ir/instruction.hpp>
+#include <irata/sim/microcode/compiler/passes/pass.hpp>
+
+namespace irata::sim::microcode::compiler::passes {
+
+// A pass that transforms or validates each instruction on its own, without
+// looking at the rest of the instruction set.
+// The compiler runs these on many instructions at once, and skips instructions
+// that it has already run them on, so run_instruction must not change the pass
+// and its result must only depend on the given instruction.
+class InstructionPass : public Pass {
+public:
+  // Runs the pass on each instruction in turn.
+  ir::InstructionSet run(const ir::InstructionSet &instruction_set) final;
+
+  // Returns the instruction transformed by this pass.
+  // Throws an exception if the instruction is invalid.
+  virtual ir::Instruction
+  run_instruction(const ir::Instruction &instruction) const = 0;
+};
+
+} // namespace irata::sim::microcode::compiler::passes
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <irata/sim/hdl/component_decl.hpp>
+#include <irata/sim/microcode/compiler/passes/instruction_pass.hpp>
+#include <map>
+#include <memory>
+#include <set>
+
+namespace irata::sim::microcode::compiler::passes {
+
+// Reorders and packs the steps within each stage of each instruction so that
+// independent operations run in the same tick, reducing the step count.
+// Unlike StepMerger, which only merges adjacent steps, this builds a
+// dependency graph over the steps of a stage and list schedules them: each
+// step, in program order, is placed in the earliest tick that respects its
+// dependencies on earlier steps and doesn't share a bus with the steps
+// already placed there.
+//
+// Dependencies are found by treating each step as an operation on units of
+// state, such as a register or the memory:
+// - A write control reads its unit's state onto its bus.
+// - A read control writes its unit's state from its bus.
+// - Any other control reads and writes its unit's state.
+// Every control also reads the state of any units that its unit is wired to
+// read from during a tick, such as the status register latching the ALU's
+// flags.
+// Two steps depend on each other if one writes a unit that the other reads or
+// writes. A dependent step can share a tick with the step it depends on only
+// if each of its conflicting accesses runs in a later tick phase than the
+// earlier step's, so that the tick still performs them in order. A control
+// that doesn't belong to any unit is a barrier that every other step in its
+// stage depends on.
+//
+// Steps never move between stages, so stage boundaries are kept.
+// This must run before step index controls are added, since those belong to
+// the controller and would make every step depend on every other.
+class ListScheduler : public InstructionPass {
+public:
+  // A map from each unit to the units that its controls also read from.
+  using UnitReads =
+      std::map<const hdl::ComponentDecl *, std::set<const hdl::ComponentDecl *>>;
+
+  // Constructs a scheduler over the given units. A control belongs to the
+  // nearest of its ancestors that is a unit.
+  ListScheduler(std::set<const hdl::ComponentDecl *> units,
+                UnitReads unit_reads);
+
+  // Returns a scheduler over the units of the irata machine: each component
+  // of the cpu, the ALU's operands, and the memory and its address register.
+  static std::unique_ptr<ListScheduler> irata();
+
+  ir::Instruction
+  run_instruction(const ir::Instruction &instruction) const override;
+
+private:
+  const std::set<const hdl::ComponentDecl *> units_;
+  const UnitReads unit_reads_;
+};
+
+} // namespace irata::sim::microcode::compiler::passes
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <irata/sim/hdl/control_decl.hpp>
 #include <irata/sim/microcode/compiler/ir/instruction_set.hpp>
+#include <set>
 
 namespace irata::sim::microcode::compiler::passes {
 
+// A step of the microcode compiler, transforming or validating an instruction
+// set.
 class Pass {
 public:
   Pass() = default;
@@ -12,6 +16,10 @@ public:
   Pass &operator=(const Pass &) = delete;
 
   virtual ir::InstructionSet run(const ir::InstructionSet &instruction_set) = 0;
+
+  // Returns the controls that this pass adds to steps. The compiler registers
+  // them along with the controls of the instruction set that it compiles.
+  virtual std::set<const hdl::ControlDecl *> added_controls() const;
 };
 
 } // namespace irata::sim::microcode::compiler::passes
@@ -1,14 +1,17 @@
 #pragma once
 
-#include <irata/sim/microcode/compiler/passes/pass.hpp>
+#include <irata/sim/microcode/compiler/passes/instruction_pass.hpp>
 
 namespace irata::sim::microcode::compiler::passes {
 
 // Adds a step index reset to the last step of each instruction, and adds a
 // step index increment to all other steps.
-class StepIndexTransformer : public Pass {
+class StepIndexTransformer : public InstructionPass {
 public:
-  ir::InstructionSet run(const ir::InstructionSet &instruction_set) override;
+  ir::Instruction
+  run_instruction(const ir::Instruction &instruction) const override;
+
+  std::set<const hdl::ControlDecl *> added_controls() const override;
 };
 
 } // namespace irata::sim::microcode::compiler::passes
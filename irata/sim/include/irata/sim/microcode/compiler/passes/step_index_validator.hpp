@@ -1,14 +1,15 @@
 #pragma once
 
-#include <irata/sim/microcode/compiler/passes/pass.hpp>
+#include <irata/sim/microcode/compiler/passes/instruction_pass.hpp>
 
 namespace irata::sim::microcode::compiler::passes {
 
 // Verifies that the last step in each instruction resets the step index
 // counter, and all other steps increment it.
-class StepIndexValidator : public Pass {
+class StepIndexValidator : public InstructionPass {
 public:
-  ir::InstructionSet run(const ir::InstructionSet &instruction_set) override;
+  ir::Instruction
+  run_instruction(const ir::Instruction &instruction) const override;
 };
 
 } // namespace irata::sim::microcode::compiler::passes
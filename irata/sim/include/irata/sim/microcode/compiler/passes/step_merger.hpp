@@ -1,6 +1,6 @@
 #pragma once
 
-#include <irata/sim/microcode/compiler/passes/pass.hpp>
+#include <irata/sim/microcode/compiler/passes/instruction_pass.hpp>
 
 namespace irata::sim::microcode::compiler::passes {
 
@@ -11,9 +11,10 @@ namespace irata::sim::microcode::compiler::passes {
 // altering behavior.
 // This is valid because all steps in a given tick phase are assumed to be
 // executed in parallel.
-class StepMerger : public Pass {
+class StepMerger : public InstructionPass {
 public:
-  ir::InstructionSet run(const ir::InstructionSet &instruction_set) override;
+  ir::Instruction
+  run_instruction(const ir::Instruction &instruction) const override;
 };
 
 } // namespace irata::sim::microcode::compiler::passes
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace irata::sim::microcode::compiler {
+
+// WorkerPool is a fixed set of worker threads that run batches of jobs.
+// The threads are started when the pool is constructed and wait for batches
+// until it's destroyed, so running a batch never starts a thread.
+// Batches can be run from several threads at once, and the workers share
+// themselves between them.
+class WorkerPool {
+public:
+  // Constructs a pool that runs each batch on up to num_threads threads: the
+  // thread that runs the batch and num_threads - 1 workers.
+  explicit WorkerPool(size_t num_threads);
+  ~WorkerPool();
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  // Returns the number of threads that run each batch, including the caller.
+  size_t num_threads() const;
+
+  // Calls job with each index from 0 to num_jobs - 1, spread over the calling
+  // thread and the workers, and returns once every call has returned.
+  // The job must not throw.
+  void run(size_t num_jobs, const std::function<void(size_t)> &job);
+
+private:
+  // A call to run, which the workers take jobs from until all have started.
+  struct Batch {
+    const std::function<void(size_t)> &job;
+    const size_t num_jobs;
+    // The next job to start. Guarded by the pool's mutex.
+    size_t next = 0;
+    // The number of jobs that have returned. Guarded by the pool's mutex.
+    size_t num_done = 0;
+  };
+
+  const size_t num_threads_;
+  std::mutex mutex_;
+  // Signalled when a batch is added or the pool is stopping.
+  std::condition_variable work_added_;
+  // Signalled when a batch's last job returns.
+  std::condition_variable batch_done_;
+  // The batches with jobs that haven't started, oldest first.
+  std::deque<std::shared_ptr<Batch>> batches_;
+  bool stopping_ = false;
+  std::vector<std::thread> workers_;
+
+  // Runs jobs from the batch until all have started. The lock is held on
+  // entry and exit, and released while jobs run.
+  void work_on(Batch &batch, std::unique_lock<std::mutex> &lock);
+
+  void work();
+};
+
+} // namespace irata::sim::microcode::compiler
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <irata/asm/instruction.hpp>
+#include <irata/sim/hdl/control_decl.hpp>
 #include <irata/sim/hdl/status_decl.hpp>
 #include <map>
 #include <memory>
+#include <set>
 #include <vector>
 
 namespace irata::sim::microcode::dsl {
@@ -41,6 +43,10 @@ public:
   // Returns the instructions in the instruction set.
   const std::vector<std::unique_ptr<Instruction>> &instructions() const;
 
+  // Returns the controls used by the steps of the instructions in the
+  // instruction set.
+  std::set<const hdl::ControlDecl *> controls() const;
+
   // Returns the instruction with the given instruction descriptor.
   // If statuses are provided, the instruction must have the given statuses.
   // If no instruction is found, throws an exception.
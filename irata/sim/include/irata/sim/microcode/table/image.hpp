@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <irata/sim/microcode/dsl/instruction_set.hpp>
+#include <irata/sim/microcode/table/table.hpp>
+#include <istream>
+#include <optional>
+#include <ostream>
+
+namespace irata::sim::microcode::table {
+
+// A microcode image is a compiled microcode table serialized to a compact
+// binary form, so that processes can load the table instead of running the
+// compiler.
+// Controls and statuses are stored by path and resolved against the
+// instruction set when the image is read. Each image records a hash of the
+// instruction set and compiler it was compiled with, and reading an image
+// expecting a different hash fails, so a stale image is never used.
+
+// Returns a hash of everything in the instruction set that affects its
+// compiled table, along with the given fingerprint of the compiler that
+// compiles it.
+uint64_t image_hash(const dsl::InstructionSet &instruction_set,
+                    uint64_t compiler_fingerprint);
+
+// Writes the table to the image, recording the given hash.
+void write_image(std::ostream &os, const Table &table, uint64_t hash);
+
+// Reads a table from the image, resolving its controls and statuses against
+// the given instruction set.
+// Returns nullopt if the image doesn't record the given hash, or if it names
+// an opcode, control or status that the instruction set doesn't have.
+// Throws std::runtime_error if the image is truncated or malformed.
+std::optional<Table> read_image(std::istream &is,
+                                const dsl::InstructionSet &instruction_set,
+                                uint64_t hash);
+
+} // namespace irata::sim::microcode::table
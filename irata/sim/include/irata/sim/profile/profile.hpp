@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <irata/sim/hdl/alu_opcode.hpp>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+
+namespace irata::sim::profile {
+
+// A Profile counts what a machine does while running, to show where the time
+// of a cartridge goes and which microcode sequences are worth optimizing.
+// A machine only counts into a profile while one is attached to it, with
+// components::Irata::set_profile.
+class Profile {
+public:
+  // The counts for an opcode.
+  struct OpcodeCounts {
+    // The number of times an instruction with the opcode was loaded.
+    uint64_t instructions = 0;
+    // The number of ticks spent on those instructions, including fetching
+    // them.
+    uint64_t ticks = 0;
+  };
+
+  // The counts for a memory region.
+  struct RegionCounts {
+    // Reads from the region onto the data bus.
+    uint64_t reads = 0;
+    // Writes to the region from the data bus.
+    uint64_t writes = 0;
+  };
+
+  Profile() = default;
+  Profile(const Profile &) = delete;
+  Profile &operator=(const Profile &) = delete;
+
+  // Counts a tick that ran the given step of the microcode.
+  // Ticks from the start of a fetch up to the tick that loads an opcode are
+  // attributed to the loaded opcode, and later ticks are attributed to the
+  // last loaded opcode until the next fetch starts at step 0.
+  void count_tick(uint8_t step_counter, std::optional<uint8_t> loaded_opcode);
+
+  void count_region_read(const std::string &region);
+  void count_region_write(const std::string &region);
+  void count_bus_transfer(const std::string &bus);
+  void count_alu_operation(hdl::AluOpcode opcode);
+
+  // Returns the total number of ticks counted.
+  uint64_t ticks() const;
+
+  // Returns the total number of instructions loaded.
+  uint64_t instructions() const;
+
+  // Returns the counts for each opcode, indexed by opcode.
+  const std::array<OpcodeCounts, 256> &opcodes() const;
+
+  // Returns the counts for each memory region that was accessed, by region
+  // name.
+  const std::map<std::string, RegionCounts> &regions() const;
+
+  // Returns the number of values put on each bus, by bus name.
+  const std::map<std::string, uint64_t> &bus_transfers() const;
+
+  // Returns the number of times each ALU operation ran.
+  const std::map<hdl::AluOpcode, uint64_t> &alu_operations() const;
+
+private:
+  uint64_t ticks_ = 0;
+  uint64_t instructions_ = 0;
+  std::array<OpcodeCounts, 256> opcodes_ = {};
+  // The opcode of the running instruction, if any has been loaded.
+  std::optional<uint8_t> opcode_;
+  // Whether the next instruction is being fetched, and the ticks spent
+  // fetching it so far.
+  bool fetching_ = true;
+  uint64_t fetch_ticks_ = 0;
+  std::map<std::string, RegionCounts> regions_;
+  std::map<std::string, uint64_t> bus_transfers_;
+  std::map<hdl::AluOpcode, uint64_t> alu_operations_;
+};
+
+// Writes a summary of the profile, with the opcodes that took the most ticks
+// first and named from the irata instruction set.
+std::ostream &operator<<(std::ostream &os, const Profile &profile);
+
+} // namespace irata::sim::profile
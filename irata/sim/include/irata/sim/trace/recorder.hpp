@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <irata/sim/trace/trace.hpp>
+#include <ostream>
+#include <vector>
+
+namespace irata::sim::trace {
+
+// A Recorder collects a Record for every tick of a machine that it's attached
+// to, as a structured alternative to the text logged by a traced tick.
+// It either keeps the most recent records in a fixed size ring buffer, which
+// can be written out on demand, or streams every record to an output stream
+// as it's recorded.
+// Records are numbered in the order they're recorded, starting from 0.
+class Recorder {
+public:
+  // Constructs a recorder that keeps the last capacity records in memory.
+  // Throws std::invalid_argument if capacity is zero.
+  Recorder(Header header, size_t capacity);
+
+  // Constructs a recorder that writes the header and then every record to the
+  // given stream, which must outlive the recorder.
+  Recorder(Header header, std::ostream &os);
+
+  Recorder(const Recorder &) = delete;
+  Recorder &operator=(const Recorder &) = delete;
+
+  const Header &header() const;
+
+  // Records a tick, numbering it after the previous one.
+  void record(Record record);
+
+  // Returns the number of records recorded, including any that have been
+  // dropped from the ring buffer.
+  uint64_t num_recorded() const;
+
+  // Returns the records in the ring buffer, oldest first. Streaming recorders
+  // keep no records.
+  std::vector<Record> records() const;
+
+  // Writes the header and the records in the ring buffer, in the same format
+  // as a streaming recorder.
+  void write(std::ostream &os) const;
+
+private:
+  const Header header_;
+  std::ostream *const os_;
+  std::vector<Record> buffer_;
+  const size_t capacity_;
+  uint64_t num_recorded_ = 0;
+};
+
+} // namespace irata::sim::trace
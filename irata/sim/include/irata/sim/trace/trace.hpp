@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace irata::sim::components::controller {
+class InstructionEncoder;
+} // namespace irata::sim::components::controller
+
+namespace irata::sim::trace {
+
+// The state of the machine on a single tick.
+struct Record {
+  // The number of the tick in the trace, starting from 0.
+  uint64_t tick = 0;
+  // The instruction memory address read by the controller.
+  uint8_t opcode = 0;
+  uint8_t step_counter = 0;
+  uint32_t encoded_statuses = 0;
+  // The controls asserted by the controller, encoded by the ControlEncoder.
+  uint64_t encoded_controls = 0;
+  // The values on the buses, if anything was written to them.
+  std::optional<uint8_t> data_bus;
+  std::optional<uint16_t> address_bus;
+
+  // The size of an encoded record in bytes.
+  static constexpr size_t size = 26;
+
+  // Encodes the record into its fixed width little-endian form.
+  std::array<uint8_t, size> encode() const;
+
+  // Decodes a record from its fixed width form.
+  // Throws std::runtime_error if the record is malformed.
+  static Record decode(const std::array<uint8_t, size> &bytes);
+
+  bool operator==(const Record &other) const;
+  bool operator!=(const Record &other) const;
+};
+
+// Describes the machine that a trace was recorded from, so that traces can be
+// rendered without the microcode that produced them.
+struct Header {
+  // The paths of the statuses, indexed by bit in Record::encoded_statuses.
+  std::vector<std::string> statuses;
+  // The paths of the controls, indexed by bit in Record::encoded_controls.
+  std::vector<std::string> controls;
+
+  // Returns the header for controllers using the given encoder.
+  static Header from_encoder(
+      const components::controller::InstructionEncoder &encoder);
+
+  // Writes the header that starts a trace.
+  void write(std::ostream &os) const;
+
+  // Reads the header that starts a trace.
+  // Throws std::runtime_error if the stream doesn't start with a trace header.
+  static Header read(std::istream &is);
+
+  // Renders the given record as a line of text, naming its statuses and
+  // asserted controls.
+  std::string describe(const Record &record) const;
+
+  bool operator==(const Header &other) const;
+  bool operator!=(const Header &other) const;
+};
+
+// Reads a trace written by a Recorder, one record at a time, so that traces
+// of long runs needn't fit in memory.
+class Reader {
+public:
+  // Reads the trace header from the given stream.
+  // Throws std::runtime_error if the stream doesn't start with a trace header.
+  explicit Reader(std::istream &is);
+  Reader(const Reader &) = delete;
+  Reader &operator=(const Reader &) = delete;
+
+  const Header &header() const;
+
+  // Returns the next record, or nullopt at the end of the trace.
+  // Throws std::runtime_error if the trace ends part way through a record.
+  std::optional<Record> next();
+
+  // Reads all the remaining records.
+  std::vector<Record> read_all();
+
+private:
+  std::istream &is_;
+  const Header header_;
+};
+
+} // namespace irata::sim::trace
@@ -1,3 +1,4 @@
+#include <fstream>
 #include <iostream>
 #include <irata/common/strings/strings.hpp>
 #include <irata/sim/hdl/irata_decl.hpp>
@@ -8,6 +9,7 @@
 #include <irata/sim/microcode/dsl/instruction.hpp>
 #include <irata/sim/microcode/dsl/instruction_set.hpp>
 #include <irata/sim/microcode/dsl/step.hpp>
+#include <irata/sim/microcode/table/image.hpp>
 
 namespace irata::sim::microcode::compiler {
 
@@ -90,19 +92,148 @@ void report(const ir::InstructionSet &instruction_set) {
 
 void report() {
   const auto &dsl_instruction_set = dsl::InstructionSet::irata();
-  const auto uncompiled_instruction_set =
-      compiler::ir::InstructionSet(dsl_instruction_set);
+  const auto &compiler = compiler::Compiler::irata();
+  const auto uncompiled_instruction_set = compiler::ir::InstructionSet(
+      compiler.registry(dsl_instruction_set), dsl_instruction_set);
   const auto compiled_instruction_set =
-      compiler::Compiler::irata().compile_to_ir(dsl_instruction_set);
+      compiler.compile_to_ir(dsl_instruction_set);
   std::cout << "Uncompiled instruction set:\n";
   report(uncompiled_instruction_set);
   std::cout << "Compiled instruction set:\n";
   report(compiled_instruction_set);
 }
 
+// Returns the number of steps in each instruction, by opcode and statuses.
+std::map<std::pair<Byte, Statuses>, size_t>
+steps_by_instruction(const ir::InstructionSet &instruction_set) {
+  std::map<std::pair<Byte, Statuses>, size_t> steps;
+  for (const auto &instruction : instruction_set.instructions()) {
+    steps[{instruction.descriptor().opcode(), instruction.statuses()}] =
+        instruction.steps().size();
+  }
+  return steps;
+}
+
+// Reports the steps per instruction compiled without list scheduling or fetch
+// overlap, with list scheduling, and with both.
+void schedule_report() {
+  const auto &dsl_instruction_set = dsl::InstructionSet::irata();
+  const auto compiled = Compiler::irata().compile_to_ir(dsl_instruction_set);
+  const auto baseline_steps = steps_by_instruction(
+      Compiler(Compiler::irata_passes(/*list_schedule=*/false,
+                                      /*overlap_fetch=*/false))
+          .compile_to_ir(dsl_instruction_set));
+  const auto scheduled_steps = steps_by_instruction(
+      Compiler(Compiler::irata_passes(/*list_schedule=*/true,
+                                      /*overlap_fetch=*/false))
+          .compile_to_ir(dsl_instruction_set));
+  std::cout << "Steps per instruction: baseline -> list scheduled -> "
+               "overlapped fetch\n";
+  size_t total_baseline = 0, total_scheduled = 0, total_compiled = 0,
+         improved = 0;
+  for (const auto &[opcode, instructions] :
+       group_instructions_by_opcode(all_instructions(compiled))) {
+    for (const auto *instruction : instructions) {
+      const auto baseline =
+          baseline_steps.at({opcode, instruction->statuses()});
+      const auto scheduled =
+          scheduled_steps.at({opcode, instruction->statuses()});
+      const auto steps = instruction->steps().size();
+      total_baseline += baseline;
+      total_scheduled += scheduled;
+      total_compiled += steps;
+      if (steps < baseline) {
+        ++improved;
+      }
+      std::cout << "  " << instruction->descriptor().name() << " "
+                << instruction->descriptor().addressing_mode() << " ("
+                << opcode << ")";
+      if (!instruction->statuses().empty()) {
+        std::cout << " " << instruction->statuses();
+      }
+      std::cout << std::dec << ": " << baseline << " -> " << scheduled
+                << " -> " << steps << " steps\n";
+    }
+  }
+  std::cout << "  " << total_baseline << " -> " << total_scheduled << " -> "
+            << total_compiled << " total steps, " << improved << " of "
+            << compiled.instructions().size() << " instructions improved\n";
+}
+
+// Loads the compiled instruction cache at the given path into the irata
+// compiler, if there is one and it was written by the same passes.
+void load_cache(const std::string &path) {
+  std::ifstream is(path, std::ios::binary);
+  if (!is) {
+    return;
+  }
+  try {
+    Compiler::irata().load_cache(is, dsl::InstructionSet::irata());
+  } catch (const std::runtime_error &e) {
+    std::cerr << "Warning: ignoring compiled instruction cache " << path
+              << ": " << e.what() << std::endl;
+  }
+}
+
+int save_cache(const std::string &path) {
+  std::ofstream os(path, std::ios::binary);
+  if (!os) {
+    std::cerr << "Error: failed to open " << path << std::endl;
+    return 1;
+  }
+  Compiler::irata().save_cache(os);
+  return 0;
+}
+
+int write_image(const std::string &path, const std::string &cache_path) {
+  if (!cache_path.empty()) {
+    load_cache(cache_path);
+  }
+  const auto table = Compiler::compile_irata();
+  if (!cache_path.empty()) {
+    if (const int result = save_cache(cache_path); result != 0) {
+      return result;
+    }
+  }
+  std::ofstream os(path, std::ios::binary);
+  if (!os) {
+    std::cerr << "Error: failed to open " << path << std::endl;
+    return 1;
+  }
+  table::write_image(os, table,
+                     table::image_hash(dsl::InstructionSet::irata(),
+                                       Compiler::fingerprint()));
+  return 0;
+}
+
 } // namespace irata::sim::microcode::compiler
 
-int main() {
+int main(int argc, char **argv) {
+  if (argc == 3 && std::string(argv[1]) == "--write-image") {
+    return irata::sim::microcode::compiler::write_image(argv[2], "");
+  }
+  if (argc == 5 && std::string(argv[1]) == "--write-image" &&
+      std::string(argv[3]) == "--cache") {
+    return irata::sim::microcode::compiler::write_image(argv[2], argv[4]);
+  }
+  if (argc == 2 && std::string(argv[1]) == "--schedule-report") {
+    irata::sim::microcode::compiler::schedule_report();
+    return 0;
+  }
+  if (argc != 1) {
+    std::cerr << "usage: " << argv[0]
+              << " [--write-image PATH [--cache CACHE] | --schedule-report]"
+              << std::endl
+              << "Reports on the compiled microcode, or with --write-image "
+                 "writes the compiled microcode image to PATH. With --cache, "
+                 "only instructions that changed since CACHE was written are "
+                 "recompiled, and CACHE is updated. With "
+                 "--schedule-report, compares the steps of each instruction "
+                 "compiled with and without list scheduling and fetch "
+                 "overlap."
+              << std::endl;
+    return 2;
+  }
   irata::sim::microcode::compiler::report();
   return 0;
 }
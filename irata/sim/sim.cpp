@@ -1,29 +1,208 @@
 #include <fstream>
 #include <iostream>
 #include <irata/sim/components/irata.hpp>
+#include <irata/sim/components/memory/mapped_rom.hpp>
 #include <irata/sim/components/memory/rom.hpp>
 #include <irata/sim/hdl/irata_decl.hpp>
+#include <irata/sim/interpreter/differential_checker.hpp>
+#include <irata/sim/interpreter/interpreter.hpp>
+#include <irata/sim/profile/profile.hpp>
+#include <irata/sim/trace/recorder.hpp>
+#include <optional>
+#include <sstream>
+#include <string>
 
 using namespace irata::sim::components;
 
+namespace {
+
+// Redirects a stream to another buffer until it goes out of scope, so the
+// stream is restored even if something throws.
+class RedirectStream {
+public:
+  RedirectStream(std::ostream &stream, std::streambuf *buffer)
+      : stream_(stream), original_(stream.rdbuf(buffer)) {}
+  ~RedirectStream() { stream_.rdbuf(original_); }
+  RedirectStream(const RedirectStream &) = delete;
+  RedirectStream &operator=(const RedirectStream &) = delete;
+
+private:
+  std::ostream &stream_;
+  std::streambuf *const original_;
+};
+
+void usage(const char *program) {
+  std::cerr << "usage: " << program
+            << " [--quiet | --trace] [--record FILE] [--profile] "
+               "[--interpreter | --differential] [cartridge]"
+            << std::endl
+            << "  --quiet        don't log anything while running" << std::endl
+            << "  --trace        log the cpu state and component activity on "
+               "every tick (default)"
+            << std::endl
+            << "  --record FILE  write a binary trace of every tick to FILE, "
+               "which sim_trace renders as text, not with --interpreter or "
+               "--differential"
+            << std::endl
+            << "  --profile      count instructions, ticks, memory accesses, "
+               "bus transfers and ALU operations while running and print a "
+               "summary at the end, not with --interpreter or --differential"
+            << std::endl
+            << "  --interpreter  run the program with the instruction level "
+               "interpreter instead of simulating the machine"
+            << std::endl
+            << "  --differential run the program with both the interpreter and "
+               "the simulated machine and stop at the first instruction where "
+               "they differ"
+            << std::endl
+            << "Reads the cartridge from stdin if no path is given."
+            << std::endl;
+}
+
+int run_interpreter(const memory::Module &cartridge) {
+  using irata::sim::interpreter::Interpreter;
+  Interpreter interpreter(cartridge.dump());
+  Interpreter::Result result;
+  try {
+    result = interpreter.run();
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  switch (result) {
+  case Interpreter::Result::Halt:
+    std::cerr << "Interpreter complete. Final state:" << std::endl;
+    interpreter.serialize(std::cerr);
+    return 0;
+  case Interpreter::Result::Crash:
+    std::cerr << "Interpreter crashed. Final state:" << std::endl;
+    interpreter.serialize(std::cerr);
+    return 1;
+  }
+  return 1;
+}
+
+int run_differential(const memory::Module &cartridge) {
+  using irata::sim::interpreter::DifferentialChecker;
+  DifferentialChecker checker(cartridge.dump());
+  std::optional<DifferentialChecker::Divergence> divergence;
+  try {
+    divergence = checker.run();
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  if (divergence) {
+    std::cerr << "Interpreter and simulation diverged: " << *divergence;
+    return 1;
+  }
+  std::cerr << "Interpreter and simulation agree. Final state:" << std::endl;
+  checker.interpreter().serialize(std::cerr);
+  return checker.interpreter().result() ==
+                 irata::sim::interpreter::Interpreter::Result::Halt
+             ? 0
+             : 1;
+}
+
+} // namespace
+
 int main(int argc, char **argv) {
-  std::unique_ptr<memory::ROM> rom;
-  if (argc > 1) {
-    std::ifstream is(argv[1]);
-    rom = std::make_unique<memory::ROM>(0x1000, is);
-  } else {
-    rom = std::make_unique<memory::ROM>(0x1000, std::cin);
-  }
-  Irata irata(std::move(rom));
-  irata::sim::hdl::IrataDecl irata_decl;
-  irata_decl.verify(&irata);
+  Irata::LogLevel log_level = Irata::LogLevel::Trace;
+  bool interpreter = false;
+  bool differential = false;
+  std::string cartridge_path;
+  std::string record_path;
+  bool profile = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--quiet") {
+      log_level = Irata::LogLevel::Quiet;
+    } else if (arg == "--trace") {
+      log_level = Irata::LogLevel::Trace;
+    } else if (arg == "--record" && i + 1 < argc) {
+      record_path = argv[++i];
+    } else if (arg == "--profile") {
+      profile = true;
+    } else if (arg == "--interpreter") {
+      interpreter = true;
+    } else if (arg == "--differential") {
+      differential = true;
+    } else if (arg.rfind("--", 0) == 0 || !cartridge_path.empty()) {
+      usage(argv[0]);
+      return 2;
+    } else {
+      cartridge_path = arg;
+    }
+  }
+
+  // Cartridge files are mapped rather than read, so they're never copied.
+  std::unique_ptr<memory::Module> cartridge;
+  try {
+    if (!cartridge_path.empty()) {
+      cartridge = std::make_unique<memory::MappedROM>(0x1000, cartridge_path);
+    } else {
+      cartridge = std::make_unique<memory::ROM>(0x1000, std::cin);
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  if (interpreter && differential) {
+    usage(argv[0]);
+    return 2;
+  }
+  // Traces and profiles are only recorded from the simulated machine.
+  if ((!record_path.empty() || profile) && (interpreter || differential)) {
+    usage(argv[0]);
+    return 2;
+  }
+  if (interpreter) {
+    return run_interpreter(*cartridge);
+  }
+  if (differential) {
+    return run_differential(*cartridge);
+  }
+  Irata irata(std::move(cartridge));
+  {
+    // Verification reports every component it checks on stdout, which a quiet
+    // run shouldn't print.
+    std::ostringstream verify_log;
+    std::optional<RedirectStream> redirect_stdout;
+    if (log_level == Irata::LogLevel::Quiet) {
+      redirect_stdout.emplace(std::cout, verify_log.rdbuf());
+    }
+    irata::sim::hdl::IrataDecl irata_decl;
+    irata_decl.verify(&irata);
+  }
+  std::ofstream record_output;
+  std::unique_ptr<irata::sim::trace::Recorder> recorder;
+  if (!record_path.empty()) {
+    record_output.open(record_path, std::ios::binary | std::ios::trunc);
+    if (!record_output) {
+      std::cerr << "Error: failed to open " << record_path << std::endl;
+      return 1;
+    }
+    recorder = std::make_unique<irata::sim::trace::Recorder>(
+        irata.trace_header(), record_output);
+    irata.set_recorder(recorder.get());
+  }
+  irata::sim::profile::Profile run_profile;
+  if (profile) {
+    irata.set_profile(&run_profile);
+  }
   Irata::Result result;
   try {
-    result = irata.tick_until_halt();
+    result = irata.tick_until_halt(-1, log_level);
   } catch (const std::exception &e) {
     std::cerr << "Error: " << e.what() << std::endl;
+    if (profile) {
+      std::cerr << run_profile;
+    }
     return 1;
   }
+  if (profile) {
+    std::cerr << run_profile;
+  }
   switch (result) {
   case Irata::Result::Halt:
     std::cerr << "Simulation complete. Final state:" << std::endl;
@@ -0,0 +1,70 @@
+#include <cstdlib>
+#include <iostream>
+#include <irata/sim/batch/batch_runner.hpp>
+#include <irata/sim/components/memory/mapped_rom.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+using irata::sim::batch::BatchRunner;
+
+namespace {
+
+void usage(const char *program) {
+  std::cerr << "usage: " << program
+            << " [--threads N] [--max-ticks N] cartridge..." << std::endl
+            << "  --threads N    run on N worker threads (default: one per "
+               "hardware thread)"
+            << std::endl
+            << "  --max-ticks N  stop each cartridge with an error after N "
+               "ticks (default: no limit)"
+            << std::endl
+            << "Runs every cartridge to completion and reports the result of "
+               "each and the total throughput. Exits with 0 only if every "
+               "cartridge halted."
+            << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t num_threads = 0;
+  int64_t max_ticks = -1;
+  std::vector<std::string> cartridge_paths;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--threads" && i + 1 < argc) {
+      num_threads = std::strtoul(argv[++i], nullptr, 10);
+    } else if (arg == "--max-ticks" && i + 1 < argc) {
+      max_ticks = std::strtoll(argv[++i], nullptr, 10);
+    } else if (arg.rfind("--", 0) == 0) {
+      usage(argv[0]);
+      return 2;
+    } else {
+      cartridge_paths.push_back(arg);
+    }
+  }
+  if (cartridge_paths.empty()) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  // Cartridges are mapped rather than read, so starting a large batch costs
+  // next to nothing and no cartridge is ever copied.
+  std::vector<BatchRunner::Job> jobs;
+  for (const auto &path : cartridge_paths) {
+    try {
+      jobs.push_back(
+          {path, std::make_shared<irata::sim::components::memory::MappedROM>(
+                     0x1000, path)});
+    } catch (const std::exception &e) {
+      std::cerr << "Error: " << e.what() << std::endl;
+      return 1;
+    }
+  }
+
+  const BatchRunner runner(num_threads, max_ticks);
+  const auto report = runner.run(jobs);
+  std::cout << report;
+  return report.num_halted() == report.results.size() ? 0 : 1;
+}
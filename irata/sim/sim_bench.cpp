@@ -0,0 +1,469 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <irata/asm/instruction_set.hpp>
+#include <irata/sim/components/bus.hpp>
+#include <irata/sim/components/component.hpp>
+#include <irata/sim/components/irata.hpp>
+#include <irata/sim/components/memory/memory.hpp>
+#include <irata/sim/components/memory/ram.hpp>
+#include <irata/sim/components/memory/rom.hpp>
+#include <irata/sim/components/register.hpp>
+#include <irata/sim/components/status.hpp>
+#include <irata/sim/components/word_register.hpp>
+#include <irata/sim/interpreter/interpreter.hpp>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// sim_bench measures the simulator's hot paths and prints the results as JSON.
+// Every benchmark does a fixed amount of work with fixed inputs, so runs are
+// comparable across commits. Each benchmark is repeated and the min, median
+// and max time per operation are reported.
+
+using namespace irata::sim;
+using namespace irata::sim::components;
+
+namespace {
+
+// Results are folded into this so that the compiler can't drop the work being
+// measured.
+volatile uint64_t sink = 0;
+
+using Clock = std::chrono::steady_clock;
+
+// One timed repetition of a benchmark.
+struct Sample {
+  // The number of operations done.
+  uint64_t operations = 0;
+  // The time taken to do them.
+  double seconds = 0;
+  // Other things that were counted during the repetition, reported as rates.
+  std::map<std::string, uint64_t> counters;
+};
+
+// Times the given function, which does the given number of operations.
+Sample time(uint64_t operations, const std::function<void()> &f) {
+  const auto start = Clock::now();
+  f();
+  const auto end = Clock::now();
+  return {operations, std::chrono::duration<double>(end - start).count(), {}};
+}
+
+struct Options {
+  int repetitions = 5;
+  // Iteration counts are divided by this, for quick smoke runs.
+  uint64_t divisor = 1;
+  std::string filter;
+  std::string output;
+  std::vector<std::string> cartridges;
+};
+
+class Runner {
+public:
+  explicit Runner(const Options &options) : options_(options) {}
+
+  // Returns the number of iterations to do for a benchmark that does the given
+  // number of iterations in a full run.
+  uint64_t iterations(uint64_t full) const {
+    return std::max<uint64_t>(1, full / options_.divisor);
+  }
+
+  // Runs a benchmark if it matches the filter. The function is called once
+  // per repetition and does its own setup before timing its work.
+  void run(const std::string &name, const std::string &unit,
+           const std::function<Sample()> &f) {
+    if (!options_.filter.empty() &&
+        name.find(options_.filter) == std::string::npos) {
+      return;
+    }
+    std::cerr << "running " << name << std::endl;
+    std::vector<Sample> samples;
+    for (int i = 0; i < options_.repetitions; ++i) {
+      samples.push_back(f());
+    }
+    results_.push_back({name, unit, std::move(samples)});
+  }
+
+  void write_json(std::ostream &os) const {
+    os << "{\n  \"context\": {\n"
+       << "    \"repetitions\": " << options_.repetitions << ",\n"
+       << "    \"divisor\": " << options_.divisor << ",\n"
+       << "    \"phase_checks\": "
+#ifdef IRATA_DISABLE_PHASE_CHECKS
+       << "false"
+#else
+       << "true"
+#endif
+       << "\n  },\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results_.size(); ++i) {
+      os << (i == 0 ? "\n" : ",\n");
+      write_result(os, results_[i]);
+    }
+    os << "\n  ]\n}\n";
+  }
+
+private:
+  struct Result {
+    std::string name;
+    std::string unit;
+    std::vector<Sample> samples;
+  };
+
+  const Options options_;
+  std::vector<Result> results_;
+
+  static void write_result(std::ostream &os, const Result &result) {
+    std::vector<double> ns_per_op;
+    for (const auto &sample : result.samples) {
+      ns_per_op.push_back(sample.seconds * 1e9 /
+                          std::max<uint64_t>(1, sample.operations));
+    }
+    std::sort(ns_per_op.begin(), ns_per_op.end());
+    const double median = ns_per_op[ns_per_op.size() / 2];
+    // Rates are taken from the fastest repetition, which is the one least
+    // disturbed by the rest of the machine.
+    const auto &fastest = *std::min_element(
+        result.samples.begin(), result.samples.end(),
+        [](const Sample &a, const Sample &b) {
+          return a.seconds * b.operations < b.seconds * a.operations;
+        });
+    os << std::setprecision(6) << "    {\n"
+       << "      \"name\": \"" << result.name << "\",\n"
+       << "      \"unit\": \"" << result.unit << "\",\n"
+       << "      \"operations\": " << fastest.operations << ",\n"
+       << "      \"min_ns_per_op\": " << ns_per_op.front() << ",\n"
+       << "      \"median_ns_per_op\": " << median << ",\n"
+       << "      \"max_ns_per_op\": " << ns_per_op.back() << ",\n"
+       << "      \"operations_per_second\": "
+       << fastest.operations / fastest.seconds;
+    for (const auto &[counter, value] : fastest.counters) {
+      os << ",\n      \"" << counter << "\": " << value << ",\n"
+         << "      \"" << counter << "_per_second\": "
+         << value / fastest.seconds;
+    }
+    os << "\n    }";
+  }
+};
+
+uint8_t opcode(std::string_view name, irata::asm_::AddressingMode mode =
+                                          irata::asm_::AddressingMode::None) {
+  return irata::asm_::InstructionSet::irata()
+      .get_instruction(name, mode)
+      .opcode()
+      .unsigned_value();
+}
+
+// A program that loops forever, doing a memory read, an alu operation and a
+// memory write on every pass.
+std::vector<uint8_t> loop_program() {
+  using irata::asm_::AddressingMode;
+  return {
+      opcode("lda", AddressingMode::Immediate), 0x01, //
+      opcode("adc", AddressingMode::ZeroPage),  0x10, //
+      opcode("sta", AddressingMode::ZeroPage),  0x10, //
+      opcode("jmp", AddressingMode::Absolute),  0x80, 0x00,
+  };
+}
+
+std::unique_ptr<memory::ROM> cartridge(std::vector<uint8_t> bytes) {
+  return std::make_unique<memory::ROM>(0x1000, std::move(bytes), "cartridge");
+}
+
+// A simple linear congruential generator, so that the inputs don't depend on
+// the standard library's implementation of the random engines.
+class Lcg {
+public:
+  explicit Lcg(uint32_t seed) : state_(seed) {}
+  uint32_t next() {
+    state_ = state_ * 1664525u + 1013904223u;
+    return state_ >> 8;
+  }
+
+private:
+  uint32_t state_;
+};
+
+void bench_irata_tick(Runner &runner) {
+  const uint64_t ticks = runner.iterations(20000);
+  runner.run("irata/tick", "tick", [&] {
+    Irata irata(cartridge(loop_program()));
+    // The first tick builds the tick schedule, which isn't what's being
+    // measured.
+    irata.tick_quiet();
+    return time(ticks, [&] {
+      for (uint64_t i = 0; i < ticks; ++i) {
+        irata.tick_quiet();
+      }
+    });
+  });
+}
+
+// Compares building a machine from scratch with forking a running one.
+void bench_irata_fork(Runner &runner) {
+  const uint64_t machines = runner.iterations(200);
+  runner.run("irata/construct", "machine", [&] {
+    return time(machines, [&] {
+      for (uint64_t i = 0; i < machines; ++i) {
+        Irata irata(cartridge(loop_program()));
+      }
+    });
+  });
+  runner.run("irata/fork", "machine", [&] {
+    Irata irata(cartridge(loop_program()));
+    irata.tick_quiet();
+    return time(machines, [&] {
+      for (uint64_t i = 0; i < machines; ++i) {
+        irata.fork();
+      }
+    });
+  });
+}
+
+void bench_instruction_memory(Runner &runner) {
+  const Irata irata;
+  const auto &instruction_memory = irata.cpu().controller().instruction_memory();
+  const uint64_t reads = runner.iterations(10000000);
+  // Reads are generated up front so only the reads are timed. They're
+  // spread over the programmed steps of every opcode, as the controller reads
+  // them.
+  struct Read {
+    uint8_t opcode;
+    uint32_t encoded_statuses;
+    uint8_t step_index;
+  };
+  const auto &headers = instruction_memory.headers();
+  const size_t num_statuses = instruction_memory.encoder().num_statuses();
+  std::vector<Read> reads_by_index;
+  Lcg lcg(1);
+  while (reads_by_index.size() < 4096) {
+    const uint8_t opcode = lcg.next() % headers.size();
+    if (headers[opcode].num_steps == 0) {
+      continue;
+    }
+    reads_by_index.push_back(
+        {opcode, uint32_t(lcg.next() % (uint64_t(1) << num_statuses)),
+         uint8_t(lcg.next() % headers[opcode].num_steps)});
+  }
+  runner.run("instruction_memory/read", "read", [&] {
+    return time(reads, [&] {
+      uint64_t total = 0;
+      for (uint64_t i = 0; i < reads; ++i) {
+        const auto &read = reads_by_index[i % reads_by_index.size()];
+        total += instruction_memory.read_encoded(
+            read.opcode, read.encoded_statuses, read.step_index);
+      }
+      sink = sink + total;
+    });
+  });
+}
+
+void bench_status_encoder(Runner &runner) {
+  const Irata irata;
+  const auto &encoder =
+      irata.cpu().controller().instruction_memory().encoder().status_encoder();
+  std::vector<controller::CompleteStatuses> statuses;
+  for (uint32_t encoded = 0; encoded < (1u << encoder.num_statuses());
+       ++encoded) {
+    statuses.push_back(encoder.decode(encoded));
+  }
+  const uint64_t encodes = runner.iterations(1000000);
+  runner.run("status_encoder/encode", "encode", [&] {
+    return time(encodes, [&] {
+      uint64_t total = 0;
+      for (uint64_t i = 0; i < encodes; ++i) {
+        total += encoder.encode(statuses[i % statuses.size()]);
+      }
+      sink = sink + total;
+    });
+  });
+}
+
+// A minimal tree holding a memory and the registers that drive it, so that
+// memory ticks can be measured without the rest of the machine.
+class MemoryTree {
+public:
+  MemoryTree() {
+    std::vector<std::unique_ptr<memory::Region>> regions;
+    regions.emplace_back(std::make_unique<memory::Region>(
+        "ram", std::make_unique<memory::RAM>(0x2000), Word(0x0000)));
+    memory_ = std::make_unique<memory::Memory>(
+        "memory", std::move(regions), address_bus_, data_bus_, carry_, &root_);
+  }
+
+  Component &root() { return root_; }
+  memory::Memory &memory() { return *memory_; }
+  Register &data_register() { return data_register_; }
+
+private:
+  Component root_ = Component("root");
+  Bus<Word> address_bus_ = Bus<Word>("address_bus", &root_);
+  Bus<Byte> data_bus_ = Bus<Byte>("data_bus", &root_);
+  Register data_register_ = Register("data_register", &data_bus_, &root_);
+  Status carry_ = Status("carry", &root_);
+  std::unique_ptr<memory::Memory> memory_;
+};
+
+void bench_memory(Runner &runner) {
+  const uint64_t ticks = runner.iterations(200000);
+  // The memory's write control puts a byte on the data bus, which is a read
+  // of the memory's contents.
+  runner.run("memory/tick_read_from_ram", "tick", [&] {
+    MemoryTree tree;
+    tree.root().tick_quiet();
+    return time(ticks, [&] {
+      for (uint64_t i = 0; i < ticks; ++i) {
+        tree.memory().set_address(Word(i & 0x1FFF));
+        tree.memory().set_write(true);
+        tree.data_register().set_read(true);
+        tree.root().tick_quiet();
+      }
+      sink = sink + tree.data_register().value().unsigned_value();
+    });
+  });
+  runner.run("memory/tick_write_to_ram", "tick", [&] {
+    MemoryTree tree;
+    tree.root().tick_quiet();
+    return time(ticks, [&] {
+      for (uint64_t i = 0; i < ticks; ++i) {
+        tree.memory().set_address(Word(i & 0x1FFF));
+        tree.data_register().set_value(Byte(i & 0xFF));
+        tree.data_register().set_write(true);
+        tree.memory().set_read(true);
+        tree.root().tick_quiet();
+      }
+      sink = sink + tree.memory().value(Word(0x0000)).unsigned_value();
+    });
+  });
+}
+
+void bench_alu(Runner &runner) {
+  Irata irata;
+  const uint64_t applies = runner.iterations(1000000);
+  for (const auto &module : irata.cpu().alu().modules()) {
+    std::ostringstream name;
+    name << "alu/" << module->name();
+    runner.run(name.str(), "apply", [&] {
+      return time(applies, [&] {
+        uint64_t total = 0;
+        for (uint64_t i = 0; i < applies; ++i) {
+          const auto result =
+              module->apply(i & 0x10000, Byte(i & 0xFF), Byte((i >> 8) & 0xFF));
+          total += result.value.unsigned_value() + result.carry;
+        }
+        sink = sink + total;
+      });
+    });
+  }
+}
+
+// Runs a cartridge to completion on the simulated machine, reporting ticks
+// and instructions per second.
+void bench_program(Runner &runner, const std::string &path) {
+  std::ifstream is(path);
+  if (!is) {
+    throw std::runtime_error("failed to open cartridge " + path);
+  }
+  const memory::ROM rom(0x1000, is);
+  std::string program = path.substr(path.find_last_of('/') + 1);
+  program = program.substr(0, program.find('.'));
+
+  // The interpreter counts the instructions that the program executes, which
+  // the simulated machine doesn't track.
+  interpreter::Interpreter interpreter(rom.bytes());
+  interpreter.run(1000000);
+  const uint64_t instructions = interpreter.instruction_count();
+
+  runner.run("program/" + program + "/sim", "tick", [&] {
+    Irata irata(cartridge(rom.bytes()));
+    uint64_t ticks = 0;
+    auto sample = time(0, [&] {
+      while (!irata.result()) {
+        irata.tick_quiet();
+        ++ticks;
+      }
+    });
+    sample.operations = ticks;
+    sample.counters["instructions"] = instructions;
+    return sample;
+  });
+  runner.run("program/" + program + "/interpreter", "instruction", [&] {
+    interpreter::Interpreter interpreter(rom.bytes());
+    return time(instructions, [&] { interpreter.run(); });
+  });
+}
+
+void usage(const char *program) {
+  std::cerr << "usage: " << program
+            << " [--repetitions N] [--quick] [--filter NAME] [--output PATH] "
+               "[cartridge...]"
+            << std::endl
+            << "  --repetitions N  time each benchmark N times (default 5)"
+            << std::endl
+            << "  --quick          do a hundredth of the work, for smoke tests"
+            << std::endl
+            << "  --filter NAME    only run benchmarks whose names contain NAME"
+            << std::endl
+            << "  --output PATH    write the JSON results to PATH instead of "
+               "stdout"
+            << std::endl
+            << "Each cartridge is also run to completion and timed."
+            << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--repetitions" && i + 1 < argc) {
+      options.repetitions = std::max(1, std::stoi(argv[++i]));
+    } else if (arg == "--quick") {
+      options.divisor = 100;
+      options.repetitions = 1;
+    } else if (arg == "--filter" && i + 1 < argc) {
+      options.filter = argv[++i];
+    } else if (arg == "--output" && i + 1 < argc) {
+      options.output = argv[++i];
+    } else if (arg.rfind("--", 0) == 0) {
+      usage(argv[0]);
+      return 2;
+    } else {
+      options.cartridges.push_back(arg);
+    }
+  }
+
+  Runner runner(options);
+  try {
+    bench_irata_tick(runner);
+    bench_irata_fork(runner);
+    bench_instruction_memory(runner);
+    bench_status_encoder(runner);
+    bench_memory(runner);
+    bench_alu(runner);
+    for (const auto &cartridge : options.cartridges) {
+      bench_program(runner, cartridge);
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  if (options.output.empty()) {
+    runner.write_json(std::cout);
+  } else {
+    std::ofstream os(options.output);
+    runner.write_json(os);
+    if (!os) {
+      std::cerr << "Error: failed to write " << options.output << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,69 @@
+#include <fstream>
+#include <iostream>
+#include <irata/sim/trace/trace.hpp>
+#include <string>
+
+using irata::sim::trace::Reader;
+
+namespace {
+
+void usage(const char *program) {
+  std::cerr << "usage: " << program << " [--header] [trace]" << std::endl
+            << "  --header  also list the statuses and controls the trace "
+               "was recorded with"
+            << std::endl
+            << "Renders a binary trace written by sim --record as a line of "
+               "text per tick. Reads the trace from stdin if no path is given."
+            << std::endl;
+}
+
+int render(std::istream &is, bool show_header) {
+  try {
+    Reader reader(is);
+    if (show_header) {
+      for (size_t i = 0; i < reader.header().statuses.size(); ++i) {
+        std::cout << "status " << i << ": " << reader.header().statuses[i]
+                  << "\n";
+      }
+      for (size_t i = 0; i < reader.header().controls.size(); ++i) {
+        std::cout << "control " << i << ": " << reader.header().controls[i]
+                  << "\n";
+      }
+    }
+    while (const auto record = reader.next()) {
+      std::cout << reader.header().describe(*record) << "\n";
+    }
+  } catch (const std::exception &e) {
+    std::cout.flush();
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  bool show_header = false;
+  std::string trace_path;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--header") {
+      show_header = true;
+    } else if (arg.rfind("--", 0) == 0 || !trace_path.empty()) {
+      usage(argv[0]);
+      return 2;
+    } else {
+      trace_path = arg;
+    }
+  }
+  if (trace_path.empty()) {
+    return render(std::cin, show_header);
+  }
+  std::ifstream is(trace_path, std::ios::binary);
+  if (!is) {
+    std::cerr << "Error: failed to open " << trace_path << std::endl;
+    return 1;
+  }
+  return render(is, show_header);
+}
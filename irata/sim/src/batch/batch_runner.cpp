@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <irata/sim/batch/batch_runner.hpp>
+#include <irata/sim/components/controller/controller.hpp>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace irata::sim::batch {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// A queue of job indices per worker. Workers take jobs from the front of their
+// own queue and steal from the back of the others'.
+class WorkQueues {
+public:
+  WorkQueues(size_t num_queues, size_t num_jobs) : queues_(num_queues) {
+    for (size_t job = 0; job < num_jobs; ++job) {
+      queues_[job % num_queues].jobs.push_back(job);
+    }
+  }
+
+  // Returns the next job for the given worker, or nullopt if every queue is
+  // empty. Jobs never create more jobs, so once this returns nullopt there is
+  // no more work.
+  std::optional<size_t> next(size_t worker) {
+    {
+      auto &queue = queues_[worker];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (!queue.jobs.empty()) {
+        const size_t job = queue.jobs.front();
+        queue.jobs.pop_front();
+        return job;
+      }
+    }
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+      auto &victim = queues_[(worker + offset) % queues_.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.jobs.empty()) {
+        const size_t job = victim.jobs.back();
+        victim.jobs.pop_back();
+        return job;
+      }
+    }
+    return std::nullopt;
+  }
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<size_t> jobs;
+  };
+
+  std::vector<Queue> queues_;
+};
+
+} // namespace
+
+uint64_t BatchRunner::Report::total_ticks() const {
+  uint64_t ticks = 0;
+  for (const auto &result : results) {
+    ticks += result.ticks;
+  }
+  return ticks;
+}
+
+size_t BatchRunner::Report::num_halted() const {
+  return std::count_if(results.begin(), results.end(),
+                       [](const JobResult &result) {
+                         return result.result ==
+                                components::Irata::Result::Halt;
+                       });
+}
+
+BatchRunner::BatchRunner(size_t num_threads, int64_t max_ticks)
+    : num_threads_(num_threads > 0
+                       ? num_threads
+                       : std::max(1u, std::thread::hardware_concurrency())),
+      max_ticks_(max_ticks) {}
+
+size_t BatchRunner::num_threads() const { return num_threads_; }
+
+BatchRunner::JobResult BatchRunner::run_job(const Job &job) const {
+  JobResult result{job.name, std::nullopt, "", 0, 0};
+  try {
+    components::Irata irata(job.cartridge != nullptr ? job.cartridge->clone()
+                                                     : nullptr);
+    const auto start = Clock::now();
+    try {
+      while (!irata.result()) {
+        if (max_ticks_ >= 0 && result.ticks >= uint64_t(max_ticks_)) {
+          throw std::runtime_error("max ticks reached");
+        }
+        irata.tick_quiet();
+        ++result.ticks;
+      }
+    } catch (...) {
+      result.seconds = seconds_since(start);
+      throw;
+    }
+    result.seconds = seconds_since(start);
+    result.result = irata.result();
+  } catch (const std::exception &e) {
+    result.error = e.what();
+  }
+  return result;
+}
+
+BatchRunner::Report BatchRunner::run(const std::vector<Job> &jobs) const {
+  // Load the shared microcode before starting the workers, so that they all
+  // build their machines from it instead of racing to initialize it.
+  components::controller::Controller::irata_microcode();
+
+  const auto start = Clock::now();
+  const size_t num_workers = std::min(num_threads_, std::max<size_t>(
+                                                        1, jobs.size()));
+  WorkQueues queues(num_workers, jobs.size());
+  std::vector<JobResult> results(jobs.size());
+  const auto work = [&](size_t worker) {
+    while (const auto job = queues.next(worker)) {
+      // Each job writes only its own slot, so results needs no lock.
+      results[*job] = run_job(jobs[*job]);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t worker = 1; worker < num_workers; ++worker) {
+    threads.emplace_back(work, worker);
+  }
+  work(0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return {std::move(results), num_workers, seconds_since(start)};
+}
+
+std::ostream &operator<<(std::ostream &os, const BatchRunner::Report &report) {
+  for (const auto &result : report.results) {
+    os << result.name << ": ";
+    if (result.result) {
+      switch (*result.result) {
+      case components::Irata::Result::Halt:
+        os << "halt";
+        break;
+      case components::Irata::Result::Crash:
+        os << "crash";
+        break;
+      }
+    } else {
+      os << "error: " << result.error;
+    }
+    os << " (" << std::dec << result.ticks << " ticks, " << std::fixed
+       << std::setprecision(3) << result.seconds * 1000 << " ms)"
+       << std::endl;
+  }
+  const uint64_t ticks = report.total_ticks();
+  os << report.results.size() << " cartridges, " << report.num_halted()
+     << " halted, " << ticks << " ticks in " << std::fixed
+     << std::setprecision(3) << report.seconds << " s on "
+     << report.num_threads << " threads";
+  if (report.seconds > 0) {
+    os << " (" << std::setprecision(0) << ticks / report.seconds
+       << " ticks/s, " << std::setprecision(1)
+       << report.results.size() / report.seconds << " cartridges/s)";
+  }
+  os << std::endl;
+  return os;
+}
+
+} // namespace irata::sim::batch
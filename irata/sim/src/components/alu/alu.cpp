@@ -211,6 +211,10 @@ Module *ALU::module() { return module(opcode()); }
 
 const Module *ALU::module() const { return module(opcode()); }
 
+std::set<hdl::TickPhase> ALU::tick_phases() const {
+  return {hdl::TickPhase::Process};
+}
+
 void ALU::tick_process(Logger &logger) {
   if (auto *module = this->module(); module != nullptr) {
     const auto carry_in = this->carry_in();
@@ -224,9 +228,11 @@ void ALU::tick_process(Logger &logger) {
       set_negative(result.negative);
       set_overflow(result.overflow);
     }
-    logger << "ALU operation: " << module->name() << "(" << lhs << ", " << rhs
-           << ") = " << result
-           << ", address_add_carry = " << address_add_carry().value();
+    if (logger.enabled()) {
+      logger << "ALU operation: " << module->name() << "(" << lhs << ", "
+             << rhs << ") = " << result
+             << ", address_add_carry = " << address_add_carry().value();
+    }
   }
 }
 
@@ -10,25 +10,31 @@ Bus<T>::Bus(std::string_view name, Component *parent)
 
 template <typename T> std::optional<T> Bus<T>::value() const { return value_; }
 
-template <typename T> void Bus<T>::set_value(T value, Component &setter) {
-  const auto setter_name = setter.path();
-  if (setter_ != std::nullopt && setter_ != setter_name) {
+template <typename T>
+void Bus<T>::set_value(T value, const Component &setter) {
+  if (setter_ != nullptr && setter_ != &setter) {
     throw std::logic_error("write conflict: trying to write to bus by " +
-                           setter_name + " but bus was already written by " +
-                           *setter_);
+                           setter.path() + " but bus was already written by " +
+                           setter_->path());
   }
-  setter_ = setter_name;
+  setter_ = &setter;
   value_ = value;
 }
 
-template <typename T> std::optional<std::string> Bus<T>::setter() const {
+template <typename T> const Component *Bus<T>::setter() const {
   return setter_;
 }
 
+template <typename T> std::set<hdl::TickPhase> Bus<T>::tick_phases() const {
+  return {hdl::TickPhase::Clear};
+}
+
 template <typename T> void Bus<T>::tick_clear(Logger &logger) {
-  if (setter_ != std::nullopt) {
-    logger << "clearing bus value set by " << *setter_;
-    setter_ = std::nullopt;
+  if (setter_ != nullptr) {
+    if (logger.enabled()) {
+      logger << "clearing bus value set by " << setter_->path();
+    }
+    setter_ = nullptr;
     value_ = std::nullopt;
   }
 }
@@ -1,6 +1,10 @@
+#include <algorithm>
+#include <array>
 #include <iostream>
+#include <irata/common/serialization/serialization.hpp>
 #include <irata/sim/components/component.hpp>
 #include <map>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -8,8 +12,19 @@
 
 namespace irata::sim::components {
 
+namespace {
+
+// The tick phases in the order that they run in each tick.
+constexpr std::array<hdl::TickPhase, 5> tick_phase_order = {
+    hdl::TickPhase::Control, hdl::TickPhase::Write, hdl::TickPhase::Read,
+    hdl::TickPhase::Process, hdl::TickPhase::Clear,
+};
+
+} // namespace
+
 Component::Component(std::string_view name, Component *parent)
-    : name_(std::string(name)), parent_(nullptr) {
+    : name_(std::string(name)), parent_(nullptr), path_("/"),
+      own_context_{this}, context_(&own_context_) {
   if (parent != nullptr) {
     parent->add_child(this);
   }
@@ -39,10 +54,12 @@ void Component::add_child(Component *child) {
        << this->path() << " but a child with the same name already exists";
     throw std::invalid_argument(os.str());
   }
-  if (children_.find(child->name_) != children_.end()) {
-  }
   children_[child->name_] = child;
   child->parent_ = this;
+  child->attach(context_);
+  // The tree has changed, so any recorded tick schedule is out of date.
+  child->tick_schedule_.reset();
+  root()->tick_schedule_.reset();
 }
 
 std::map<std::string, Component *> Component::children() const {
@@ -72,91 +89,141 @@ Component *Component::child(std::string_view path) {
   return const_cast<Component *>(std::as_const(*this).child(path));
 }
 
-std::string Component::path() const {
+void Component::attach(Context *context) {
+  context_ = context;
   if (parent_ == nullptr) {
-    return "/";
+    path_ = "/";
   } else if (parent_->parent_ == nullptr) {
-    return "/" + name_;
+    path_ = "/" + name_;
   } else {
-    return parent_->path() + "/" + name_;
+    path_ = parent_->path_ + "/" + name_;
+  }
+  for (const auto &[_, child] : children_) {
+    child->attach(context);
   }
 }
 
-const Component *Component::root() const {
-  if (parent_ == nullptr) {
-    return this;
-  } else {
-    return parent_->root();
+const std::string &Component::path() const { return path_; }
+
+const Component *Component::root() const { return context_->root; }
+
+Component *Component::root() { return context_->root; }
+
+std::optional<hdl::TickPhase> Component::active_tick_phase() const {
+  for (const auto *component = context_->ticking; component != nullptr;
+       component = component->parent_) {
+    if (component == this) {
+      return context_->active_tick_phase;
+    }
   }
+  return std::nullopt;
 }
 
-Component *Component::root() {
-  if (parent_ == nullptr) {
-    return this;
-  } else {
-    return parent_->root();
+std::set<hdl::TickPhase> Component::tick_phases() const { return {}; }
+
+bool Component::tick_phase(std::ostream *log_output, hdl::TickPhase phase) {
+  Logger logger(log_output, phase, *this);
+  switch (phase) {
+  case hdl::TickPhase::Control:
+    tick_control(logger);
+    break;
+  case hdl::TickPhase::Write:
+    tick_write(logger);
+    break;
+  case hdl::TickPhase::Read:
+    tick_read(logger);
+    break;
+  case hdl::TickPhase::Process:
+    tick_process(logger);
+    break;
+  case hdl::TickPhase::Clear:
+    tick_clear(logger);
+    break;
+  default:
+    throw std::logic_error("unknown tick phase " + std::to_string(int(phase)));
   }
+  return !logger.unhandled_;
 }
 
-std::optional<hdl::TickPhase> Component::active_tick_phase() const {
-  return active_tick_phase_;
+void Component::schedule_traverse(TickSchedule &schedule) {
+  for (const auto phase : tick_phases()) {
+    schedule[size_t(phase)].push_back(this);
+  }
+  for (const auto &[_, child] : children_) {
+    child->schedule_traverse(schedule);
+  }
 }
 
-void Component::set_active_tick_phase(
-    std::optional<hdl::TickPhase> tick_phase) {
-  active_tick_phase_ = tick_phase;
+void Component::tick_and_schedule(std::ostream *log_output) {
+  auto *root = this->root();
+  TickSchedule schedule;
+  root->schedule_traverse(schedule);
+  std::vector<const Component *> components;
+  root->snapshot_traverse(components);
+  for (const auto phase : tick_phase_order) {
+    context_->active_tick_phase = phase;
+    for (const auto *const_component : components) {
+      // The components were collected through a const traversal of this
+      // non-const tree.
+      auto *component = const_cast<Component *>(const_component);
+      context_->ticking = component;
+      if (component->tick_phase(log_output, phase) &&
+          component->tick_phases().count(phase) == 0) {
+        context_->active_tick_phase = std::nullopt;
+        context_->ticking = nullptr;
+        std::ostringstream os;
+        os << component->path() << " has a tick handler for phase " << phase
+           << " that isn't in its tick_phases()";
+        throw std::logic_error(os.str());
+      }
+    }
+  }
+  context_->active_tick_phase = std::nullopt;
+  context_->ticking = nullptr;
+  root->tick_schedule_ = std::move(schedule);
 }
 
-void Component::tick_traverse(std::ostream &log_output, hdl::TickPhase phase) {
-  set_active_tick_phase(phase);
-  {
-    Logger logger(log_output, phase, *this);
-    switch (phase) {
-    case hdl::TickPhase::Control:
-      tick_control(logger);
-      break;
-    case hdl::TickPhase::Write:
-      tick_write(logger);
-      break;
-    case hdl::TickPhase::Read:
-      tick_read(logger);
-      break;
-    case hdl::TickPhase::Process:
-      tick_process(logger);
-      break;
-    case hdl::TickPhase::Clear:
-      tick_clear(logger);
-      break;
-    default:
-      throw std::logic_error("unknown tick phase " +
-                             std::to_string(int(phase)));
-    }
+void Component::tick(std::ostream &log_output) { tick_all(&log_output); }
+
+void Component::tick_quiet() { tick_all(nullptr); }
+
+void Component::tick_all(std::ostream *log_output) {
+  auto *root = this->root();
+  if (!root->tick_schedule_) {
+    tick_and_schedule(log_output);
+    return;
   }
-  for (const auto &[_, child] : children_) {
-    child->tick_traverse(log_output, phase);
+  for (const auto phase : tick_phase_order) {
+    context_->active_tick_phase = phase;
+    for (auto *component : (*root->tick_schedule_)[size_t(phase)]) {
+      context_->ticking = component;
+      component->tick_phase(log_output, phase);
+    }
   }
-  set_active_tick_phase(std::nullopt);
+  context_->active_tick_phase = std::nullopt;
+  context_->ticking = nullptr;
 }
 
-void Component::tick(std::ostream &log_output) {
-  auto *root = this->root();
-  root->tick_traverse(log_output, hdl::TickPhase::Control);
-  root->tick_traverse(log_output, hdl::TickPhase::Write);
-  root->tick_traverse(log_output, hdl::TickPhase::Read);
-  root->tick_traverse(log_output, hdl::TickPhase::Process);
-  root->tick_traverse(log_output, hdl::TickPhase::Clear);
+std::optional<std::vector<const Component *>>
+Component::tick_schedule(hdl::TickPhase tick_phase) const {
+  const auto *root = this->root();
+  if (!root->tick_schedule_) {
+    return std::nullopt;
+  }
+  const auto &schedule = (*root->tick_schedule_)[size_t(tick_phase)];
+  return std::vector<const Component *>(schedule.begin(), schedule.end());
 }
 
-Component::Logger::Logger(std::ostream &output, hdl::TickPhase tick_phase,
+Component::Logger::Logger(std::ostream *output, hdl::TickPhase tick_phase,
                           const Component &component)
     : tick_phase_(tick_phase), component_(component), output_(output) {}
 
 Component::Logger::~Logger() {
-  if (!logged_) {
+  if (output_ == nullptr || !os_) {
     return;
   }
-  output_ << "[" << tick_phase_ << "] " << component_.path() << ": "
-          << os_.str() << std::endl;
+  *output_ << "[" << tick_phase_ << "] " << component_.path() << ": "
+           << os_->str() << std::endl;
 }
 
 std::vector<Control *> Component::controls() {
@@ -214,6 +281,199 @@ void Component::serialize_all(std::ostream &os) const {
   this->root()->serialize_traverse(serializer);
 }
 
+namespace {
+
+using common::serialization::read_u32;
+using common::serialization::read_u64;
+using common::serialization::read_u8;
+using common::serialization::write_u32;
+using common::serialization::write_u64;
+using common::serialization::write_u8;
+
+// Identifies a component tree snapshot.
+constexpr char snapshot_magic[8] = {'I', 'R', 'A', 'T', 'A', 'S', 'S', '\0'};
+
+// Bumped whenever the layout of a snapshot changes.
+constexpr uint32_t snapshot_version = 1;
+
+// 64 bit FNV-1a of the paths of the given components, identifying the shape of
+// a tree.
+uint64_t layout_hash(const std::vector<const Component *> &components) {
+  common::serialization::Hasher hasher;
+  for (const auto *component : components) {
+    hasher.add(component->path());
+  }
+  return hasher.value();
+}
+
+} // namespace
+
+Component::StateWriter::StateWriter(std::ostream &os) : os_(os) {}
+
+void Component::StateWriter::write_bool(bool value) {
+  if (fields_ != nullptr) {
+    fields_->push_back({Field::Kind::Bool});
+  }
+  write_u8(os_, value);
+}
+
+void Component::StateWriter::write_byte(uint8_t value) {
+  if (fields_ != nullptr) {
+    fields_->push_back({Field::Kind::Byte});
+  }
+  write_u8(os_, value);
+}
+
+void Component::StateWriter::write_bytes(const std::vector<uint8_t> &bytes) {
+  if (fields_ != nullptr) {
+    fields_->push_back({Field::Kind::Bytes, bytes.size()});
+  }
+  write_u32(os_, bytes.size());
+  os_.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+}
+
+Component::StateReader::StateReader(std::istream &is) : is_(is) {}
+
+bool Component::StateReader::read_bool() {
+  const uint8_t value = read_byte();
+  if (value > 1) {
+    throw std::runtime_error("snapshot has a bad bool value");
+  }
+  return value;
+}
+
+uint8_t Component::StateReader::read_byte() { return read_u8(is_); }
+
+void Component::StateReader::read_bytes(std::vector<uint8_t> &bytes) {
+  if (read_u32(is_) != bytes.size()) {
+    throw std::runtime_error("snapshot has a buffer of the wrong size");
+  }
+  if (!is_.read(reinterpret_cast<char *>(bytes.data()), bytes.size())) {
+    throw std::runtime_error("snapshot is truncated");
+  }
+}
+
+void Component::save_snapshot(std::ostream &os) const {
+  if (tree_tick_phase()) {
+    throw std::logic_error("can't snapshot a tree during a tick");
+  }
+  std::vector<const Component *> components;
+  root()->snapshot_traverse(components);
+  std::ostringstream state;
+  StateWriter writer(state);
+  for (const auto *component : components) {
+    component->save_state(writer);
+  }
+  const std::string payload = state.str();
+
+  os.write(snapshot_magic, sizeof(snapshot_magic));
+  write_u32(os, snapshot_version);
+  write_u64(os, layout_hash(components));
+  write_u32(os, payload.size());
+  os.write(payload.data(), payload.size());
+  if (!os) {
+    throw std::runtime_error("failed to write snapshot");
+  }
+}
+
+void Component::load_snapshot(std::istream &is) {
+  if (tree_tick_phase()) {
+    throw std::logic_error("can't restore a tree during a tick");
+  }
+  char magic[sizeof(snapshot_magic)];
+  if (!is.read(magic, sizeof(magic)) ||
+      !std::equal(std::begin(snapshot_magic), std::end(snapshot_magic),
+                  magic)) {
+    throw std::runtime_error("not a snapshot");
+  }
+  if (read_u32(is) != snapshot_version) {
+    throw std::runtime_error("unsupported snapshot version");
+  }
+  std::vector<const Component *> components;
+  root()->snapshot_traverse(components);
+  if (read_u64(is) != layout_hash(components)) {
+    throw std::invalid_argument(
+        "snapshot was taken from a tree with different components");
+  }
+  std::string payload(read_u32(is), '\0');
+  if (!is.read(payload.data(), payload.size())) {
+    throw std::runtime_error("snapshot is truncated");
+  }
+
+  // Check the payload against the values this tree writes before restoring any
+  // of it, so that a malformed snapshot leaves the tree unchanged.
+  std::vector<StateWriter::Field> fields;
+  {
+    std::ostringstream scratch;
+    StateWriter writer(scratch);
+    writer.fields_ = &fields;
+    for (const auto *component : components) {
+      component->save_state(writer);
+    }
+  }
+  std::istringstream state(payload);
+  StateReader reader(state);
+  for (const auto &field : fields) {
+    switch (field.kind) {
+    case StateWriter::Field::Kind::Bool:
+      reader.read_bool();
+      break;
+    case StateWriter::Field::Kind::Byte:
+      reader.read_byte();
+      break;
+    case StateWriter::Field::Kind::Bytes: {
+      std::vector<uint8_t> bytes(field.size);
+      reader.read_bytes(bytes);
+      break;
+    }
+    }
+  }
+  if (state.peek() != std::char_traits<char>::eof()) {
+    throw std::runtime_error("snapshot has trailing state");
+  }
+
+  state.clear();
+  state.seekg(0);
+  for (const auto *component : components) {
+    // The components were collected through a const traversal of this
+    // non-const tree.
+    const_cast<Component *>(component)->load_state(reader);
+  }
+}
+
+void Component::copy_state_from(const Component &source) {
+  if (tree_tick_phase() || source.tree_tick_phase()) {
+    throw std::logic_error("can't copy state during a tick");
+  }
+  std::vector<const Component *> sources;
+  source.root()->snapshot_traverse(sources);
+  std::vector<const Component *> targets;
+  root()->snapshot_traverse(targets);
+  if (sources.size() != targets.size() ||
+      layout_hash(sources) != layout_hash(targets)) {
+    throw std::invalid_argument(
+        "can't copy state between trees with different components");
+  }
+  std::stringstream state;
+  StateWriter writer(state);
+  StateReader reader(state);
+  for (size_t i = 0; i < targets.size(); ++i) {
+    auto *target = const_cast<Component *>(targets[i]);
+    if (!target->share_state(*sources[i])) {
+      sources[i]->save_state(writer);
+      target->load_state(reader);
+    }
+  }
+}
+
+void Component::snapshot_traverse(
+    std::vector<const Component *> &components) const {
+  components.push_back(this);
+  for (const auto &[name, child] : children_) {
+    child->snapshot_traverse(components);
+  }
+}
+
 void Component::serialize_traverse(Serializer &serializer) const {
   serialize(serializer);
   for (const auto &[name, child] : children_) {
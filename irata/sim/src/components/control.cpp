@@ -54,24 +54,28 @@ bool Control::can_be_set_during_phase(
 }
 
 bool Control::value() const {
-  const auto active_tick_phase = root()->active_tick_phase();
+#ifndef IRATA_DISABLE_PHASE_CHECKS
+  const auto active_tick_phase = tree_tick_phase();
   if (!can_be_read_during_phase(active_tick_phase)) {
     std::ostringstream os;
     os << "Control " << path() << " is being read in phase "
        << *active_tick_phase;
     throw std::runtime_error(os.str());
   }
+#endif
   return value_;
 }
 
 void Control::set_value(bool value) {
-  const auto active_tick_phase = root()->active_tick_phase();
+#ifndef IRATA_DISABLE_PHASE_CHECKS
+  const auto active_tick_phase = tree_tick_phase();
   if (!can_be_set_during_phase(active_tick_phase)) {
     std::ostringstream os;
     os << "Control " << path() << " is being set in phase "
        << *active_tick_phase;
     throw std::runtime_error(os.str());
   }
+#endif
   value_ = value;
 }
 
@@ -85,6 +89,10 @@ void Control::set_clear(bool value) {
   }
 }
 
+std::set<hdl::TickPhase> Control::tick_phases() const {
+  return {hdl::TickPhase::Process, hdl::TickPhase::Clear};
+}
+
 void Control::tick_process(Logger &logger) {
   if (clear_ && clear_->value() && value_) {
     value_ = false;
@@ -111,4 +119,10 @@ bool Control::auto_clear() const { return auto_clear_; }
 
 hdl::ComponentType Control::type() const { return hdl::ComponentType::Control; }
 
+void Control::save_state(StateWriter &writer) const {
+  writer.write_bool(value_);
+}
+
+void Control::load_state(StateReader &reader) { value_ = reader.read_bool(); }
+
 } // namespace irata::sim::components
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <irata/common/strings/strings.hpp>
 #include <irata/sim/components/controller/control_encoder.hpp>
+#include <irata/sim/components/controller/path_indices.hpp>
 #include <map>
 #include <set>
 #include <sstream>
@@ -19,22 +20,11 @@ get_controls(const microcode::table::Table &table) {
   }
   return controls;
 }
-
-std::map<const hdl::ControlDecl *, size_t>
-build_indices(const microcode::table::Table &table) {
-  const auto controls = get_controls(table);
-  std::map<const hdl::ControlDecl *, size_t> indices;
-  size_t index = 0;
-  for (const auto &control : controls) {
-    indices[control] = index++;
-  }
-  return indices;
-}
-
 } // namespace
 
 ControlEncoder::ControlEncoder(const microcode::table::Table &table)
-    : indices_(build_indices(table)) {
+    : indices_(build_path_indices(get_controls(table), "controls")),
+      controls_(by_path_index(indices_)) {
   if (num_controls() > 64) {
     std::vector<std::string> control_names;
     for (const auto &[control, _] : indices_) {
@@ -66,9 +56,9 @@ uint64_t ControlEncoder::encode(
 std::set<const hdl::ControlDecl *>
 ControlEncoder::decode(uint64_t encoded_controls) const {
   std::set<const hdl::ControlDecl *> controls;
-  for (const auto &[control, index] : indices_) {
+  for (size_t index = 0; index < controls_.size(); ++index) {
     if (encoded_controls & (1ull << index)) {
-      controls.insert(control);
+      controls.insert(controls_[index]);
     }
   }
   return controls;
@@ -81,4 +71,9 @@ ControlEncoder::indices() const {
   return indices_;
 }
 
+const std::vector<const hdl::ControlDecl *> &
+ControlEncoder::controls() const {
+  return controls_;
+}
+
 } // namespace irata::sim::components::controller
\ No newline at end of file
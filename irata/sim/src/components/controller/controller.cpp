@@ -5,21 +5,35 @@
 #include <irata/sim/microcode/compiler/compiler.hpp>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
 
 namespace irata::sim::components::controller {
 
 Controller::Controller(const microcode::table::Table &table,
                        Bus<Byte> &data_bus, std::string_view name,
                        Component *parent)
+    : Controller(std::make_shared<const InstructionMemory::Contents>(table),
+                 data_bus, name, parent) {}
+
+Controller::Controller(
+    std::shared_ptr<const InstructionMemory::Contents> microcode,
+    Bus<Byte> &data_bus, std::string_view name, Component *parent)
     : Component(name, parent),
-      instruction_memory_(table, "instruction_memory", this),
+      instruction_memory_(std::move(microcode), "instruction_memory", this),
       opcode_("opcode", &data_bus, this),
       step_counter_("step_counter", &data_bus, this) {}
 
 Controller Controller::irata(ByteBus &data_bus, std::string_view name,
                              Component *parent) {
-  return Controller(microcode::compiler::Compiler::compile_irata(), data_bus,
-                    name, parent);
+  return Controller(irata_microcode(), data_bus, name, parent);
+}
+
+const std::shared_ptr<const InstructionMemory::Contents> &
+Controller::irata_microcode() {
+  static const auto contents =
+      std::make_shared<const InstructionMemory::Contents>(
+          microcode::compiler::Compiler::irata_table());
+  return contents;
 }
 
 const InstructionMemory &Controller::instruction_memory() const {
@@ -50,44 +64,99 @@ void Controller::set_step_counter(Byte step_counter) {
   step_counter_.set_value(step_counter);
 }
 
-CompleteStatuses Controller::status_values() const {
-  std::map<std::string, bool> status_values;
-  for (const auto &status : root()->statuses()) {
-    status_values[status->name()] = status->value();
+void Controller::bind() {
+  const auto &encoder = instruction_memory_.encoder();
+
+  std::map<std::string, Control *> controls_by_path;
+  for (auto *control : root()->controls()) {
+    controls_by_path[control->path()] = control;
+  }
+  const auto &control_indices = encoder.control_encoder().indices();
+  std::vector<Control *> controls(control_indices.size(), nullptr);
+  for (const auto &[control, index] : control_indices) {
+    if (const auto it = controls_by_path.find(control->path());
+        it != controls_by_path.end()) {
+      controls[index] = it->second;
+    }
+  }
+
+  std::map<std::string, const Status *> statuses_by_path;
+  for (const auto *status : std::as_const(*root()).statuses()) {
+    statuses_by_path[status->path()] = status;
   }
-  std::map<const hdl::StatusDecl *, bool> complete_status_values;
-  for (const auto &status :
-       instruction_memory_.encoder().status_encoder().statuses()) {
-    if (const auto it = status_values.find(status->name());
-        it != status_values.end()) {
-      complete_status_values[status] = it->second;
+  const auto &status_indices = encoder.status_encoder().indices();
+  std::vector<const Status *> statuses(status_indices.size(), nullptr);
+  for (const auto &[status, index] : status_indices) {
+    if (const auto it = statuses_by_path.find(status->path());
+        it != statuses_by_path.end()) {
+      statuses[index] = it->second;
     } else {
       std::ostringstream os;
-      os << "status " << status->name()
+      os << "status " << status->path()
          << " is required by the controller but was not found";
       throw std::invalid_argument(os.str());
     }
   }
-  return CompleteStatuses(instruction_memory_.encoder().status_encoder(),
-                          complete_status_values);
+
+  controls_ = std::move(controls);
+  statuses_ = std::move(statuses);
+  bound_ = true;
+}
+
+bool Controller::bound() const { return bound_; }
+
+const Controller::Read &Controller::last_read() const { return last_read_; }
+
+std::optional<size_t> Controller::control_index(const Control &control) const {
+  for (size_t index = 0; index < controls_.size(); ++index) {
+    if (controls_[index] == &control) {
+      return index;
+    }
+  }
+  return std::nullopt;
+}
+
+uint32_t Controller::encoded_status_values() const {
+  uint32_t encoded_statuses = 0;
+  for (size_t index = 0; index < statuses_.size(); ++index) {
+    if (statuses_[index]->value()) {
+      encoded_statuses |= uint32_t(1) << index;
+    }
+  }
+  return encoded_statuses;
+}
+
+std::set<hdl::TickPhase> Controller::tick_phases() const {
+  return {hdl::TickPhase::Control};
 }
 
 void Controller::tick_control(Logger &logger) {
+  if (!bound_) {
+    bind();
+  }
   const auto opcode = this->opcode();
   const auto step_counter = this->step_counter();
-  const auto complete_statuses = status_values();
-  const auto controls =
-      instruction_memory_.read(opcode.unsigned_value(), complete_statuses,
-                               step_counter.unsigned_value());
-  set_control_values(controls);
-
+  const auto encoded_statuses = encoded_status_values();
+  const auto encoded_controls = instruction_memory_.read_encoded(
+      opcode.unsigned_value(), encoded_statuses,
+      step_counter.unsigned_value());
+  last_read_ = {opcode.unsigned_value(), step_counter.unsigned_value(),
+                encoded_statuses, encoded_controls};
+  set_control_values(encoded_controls);
+
+  if (!logger.enabled()) {
+    return;
+  }
   std::vector<std::string> status_strings;
-  for (const auto &[status, value] : complete_statuses.statuses()) {
-    status_strings.push_back(status->name() + "=" + std::to_string(value));
+  for (size_t index = 0; index < statuses_.size(); ++index) {
+    status_strings.push_back(statuses_[index]->name() + "=" +
+                             std::to_string((encoded_statuses >> index) & 1));
   }
   std::vector<std::string> control_strings;
-  for (const auto &control : controls) {
-    control_strings.push_back(control->path());
+  for (size_t index = 0; index < controls_.size(); ++index) {
+    if (encoded_controls & (1ull << index)) {
+      control_strings.push_back(controls_[index]->path());
+    }
   }
   logger << "opcode=" << opcode << " step_counter=" << step_counter
          << " statuses=[" << common::strings::join(status_strings, ", ")
@@ -95,22 +164,21 @@ void Controller::tick_control(Logger &logger) {
          << "]";
 }
 
-void Controller::set_control_values(
-    const std::set<const hdl::ControlDecl *> &controls) {
-  std::map<std::string, Control *> controls_by_path;
-  for (const auto &control : root()->controls()) {
-    controls_by_path[control->path()] = control;
-  }
-  for (const auto &control : controls) {
-    if (const auto it = controls_by_path.find(control->path());
-        it != controls_by_path.end()) {
-      it->second->set_value(true);
-    } else {
-      std::ostringstream os;
-      os << "control " << control->path()
-         << " is required by the controller but was not found";
-      throw std::invalid_argument(os.str());
+void Controller::set_control_values(uint64_t encoded_controls) {
+  for (size_t index = 0; index < controls_.size(); ++index) {
+    if ((encoded_controls & (1ull << index)) == 0) {
+      continue;
+    }
+    if (auto *control = controls_[index]; control != nullptr) {
+      control->set_value(true);
+      continue;
     }
+    const auto *control =
+        instruction_memory_.encoder().control_encoder().controls()[index];
+    std::ostringstream os;
+    os << "control " << control->path()
+       << " is required by the controller but was not found";
+    throw std::invalid_argument(os.str());
   }
 }
 
@@ -42,15 +42,10 @@ InstructionEncoder::InstructionEncoder(const microcode::table::Table &table)
       max_opcode_(get_max_opcode(table)),
       num_opcode_bits_(num_bits_to_represent(max_opcode_)),
       max_step_index_(get_max_step_index(table)),
-      num_step_index_bits_(num_bits_to_represent(max_step_index_)) {
-  if (num_address_bits() > 16) {
-    throw std::invalid_argument("Too many address bits to encode");
-  }
-}
+      num_step_index_bits_(num_bits_to_represent(max_step_index_)) {}
 
-uint16_t InstructionEncoder::encode_address(uint8_t opcode,
-                                            const CompleteStatuses &statuses,
-                                            uint8_t step_index) const {
+void InstructionEncoder::check_bounds(uint8_t opcode,
+                                      uint8_t step_index) const {
   if (opcode >= (1 << num_opcode_bits())) {
     std::ostringstream os;
     os << "Opcode 0x" << std::hex << int(opcode) << " out of bounds 0x"
@@ -64,8 +59,26 @@ uint16_t InstructionEncoder::encode_address(uint8_t opcode,
        << int(opcode);
     throw std::invalid_argument(os.str());
   }
+}
+
+uint16_t InstructionEncoder::encode_address(uint8_t opcode,
+                                            const CompleteStatuses &statuses,
+                                            uint8_t step_index) const {
+  return encode_address(opcode, status_encoder_.encode(statuses), step_index);
+}
+
+uint16_t InstructionEncoder::encode_address(uint8_t opcode,
+                                            uint32_t encoded_statuses,
+                                            uint8_t step_index) const {
+  if (num_address_bits() > 16) {
+    std::ostringstream os;
+    os << "Too many address bits to encode a flat address: "
+       << num_address_bits();
+    throw std::invalid_argument(os.str());
+  }
+  check_bounds(opcode, step_index);
   return (opcode << (num_status_bits() + num_step_index_bits())) |
-         (status_encoder_.encode(statuses) << num_step_index_bits()) |
+         (encoded_statuses << num_step_index_bits()) |
          step_index;
 }
 
@@ -88,7 +101,7 @@ InstructionEncoder::encode_address(const microcode::table::Entry &entry) const {
 std::tuple<uint8_t, CompleteStatuses, uint8_t>
 InstructionEncoder::decode_address(uint16_t address) const {
   const uint8_t opcode = address >> (num_status_bits() + num_step_index_bits());
-  const uint8_t encoded_statuses =
+  const uint32_t encoded_statuses =
       (address >> num_step_index_bits()) & ((1 << num_status_bits()) - 1);
   const auto statuses = status_encoder_.decode(encoded_statuses);
   const uint8_t step_index = address & ((1 << num_step_index_bits()) - 1);
@@ -1,64 +1,198 @@
+#include <algorithm>
 #include <irata/common/strings/strings.hpp>
 #include <irata/sim/components/controller/instruction_memory.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
 
 namespace irata::sim::components::controller {
 
 namespace {
 
-memory::ROM encode_rom(const InstructionEncoder &encoder,
-                       const microcode::table::Table &table, size_t rom_index) {
-  std::map<Word, Byte> data;
+// Packs the encoded status bits selected by the mask into the low bits, in
+// order, giving the block of an opcode's steps for those statuses.
+size_t status_block(uint32_t encoded_statuses, uint32_t status_mask) {
+  size_t block = 0;
+  for (size_t bit = 0; status_mask != 0;
+       status_mask >>= 1, encoded_statuses >>= 1) {
+    if (status_mask & 1) {
+      block |= size_t(encoded_statuses & 1) << bit++;
+    }
+  }
+  return block;
+}
+
+size_t num_blocks(const InstructionMemory::Header &header) {
+  return size_t(1) << __builtin_popcount(header.status_mask);
+}
+
+// Returns the encoded status bits that the entry specifies, and their values.
+std::pair<uint32_t, uint32_t> encode_entry_statuses(
+    const InstructionEncoder &encoder, const microcode::table::Entry &entry) {
+  const auto &indices = encoder.status_encoder().indices();
+  uint32_t mask = 0;
+  uint32_t values = 0;
+  for (const auto &[status, value] : entry.statuses) {
+    const uint32_t bit = uint32_t(1) << indices.at(status);
+    mask |= bit;
+    if (value) {
+      values |= bit;
+    }
+  }
+  return {mask, values};
+}
+
+std::vector<InstructionMemory::Header>
+encode_headers(const InstructionEncoder &encoder,
+               const microcode::table::Table &table) {
+  std::vector<InstructionMemory::Header> headers(size_t(encoder.max_opcode()) +
+                                                 1);
+  for (const auto &entry : table.entries) {
+    auto &header = headers[entry.instruction.opcode().unsigned_value()];
+    header.status_mask |= encode_entry_statuses(encoder, entry).first;
+    header.num_steps = std::max<uint16_t>(
+        header.num_steps, entry.step_index.unsigned_value() + 1);
+  }
+  size_t offset = 0;
+  for (auto &header : headers) {
+    header.offset = offset;
+    offset += num_blocks(header) * header.num_steps;
+  }
+  return headers;
+}
+
+std::vector<uint64_t>
+encode_steps(const InstructionEncoder &encoder,
+             const std::vector<InstructionMemory::Header> &headers,
+             const microcode::table::Table &table) {
+  size_t num_steps = 0;
+  for (const auto &header : headers) {
+    num_steps += num_blocks(header) * header.num_steps;
+  }
+  std::vector<uint64_t> steps(num_steps, 0);
+  std::vector<bool> programmed(steps.size(), false);
   for (const auto &entry : table.entries) {
-    for (const auto &address : encoder.encode_address(entry)) {
-      const auto value = encoder.encode_value(entry);
-      if (data.find(address) != data.end()) {
+    const auto value = encoder.encode_value(entry);
+    const auto &header = headers[entry.instruction.opcode().unsigned_value()];
+    const auto [mask, values] = encode_entry_statuses(encoder, entry);
+    // The entry covers every combination of the statuses that its opcode
+    // branches on but that it leaves unset.
+    const uint32_t unset = header.status_mask & ~mask;
+    for (uint32_t subset = unset;; subset = (subset - 1) & unset) {
+      const size_t index =
+          header.offset +
+          status_block(values | subset, header.status_mask) *
+              header.num_steps +
+          entry.step_index.unsigned_value();
+      if (programmed[index]) {
         std::ostringstream os;
-        os << "Duplicate address " << std::hex << address << " for entry "
-           << entry << " in instruction memory";
+        os << "Duplicate step " << index << " for entry " << entry
+           << " in instruction memory";
         throw std::logic_error(os.str());
       }
-      data[address] = Byte((value >> (8 * rom_index)) & 0xFF);
+      programmed[index] = true;
+      steps[index] = value;
+      if (subset == 0) {
+        break;
+      }
     }
   }
-  return memory::ROM(1 << 16, "rom_" + std::to_string(rom_index), data);
+  return steps;
 }
 
-std::array<memory::ROM, 8> encode_roms(const InstructionEncoder &encoder,
-                                       const microcode::table::Table &table) {
+std::shared_ptr<const std::vector<uint8_t>>
+encode_rom(const std::vector<uint64_t> &steps, size_t rom_index) {
+  size_t size = 1;
+  while (size < steps.size()) {
+    size <<= 1;
+  }
+  auto bytes = std::make_shared<std::vector<uint8_t>>(size, 0);
+  for (size_t index = 0; index < steps.size(); ++index) {
+    (*bytes)[index] = (steps[index] >> (8 * rom_index)) & 0xFF;
+  }
+  return bytes;
+}
+
+std::array<std::shared_ptr<const std::vector<uint8_t>>, 8>
+encode_roms(const std::vector<uint64_t> &steps) {
   return {
-      encode_rom(encoder, table, 0), encode_rom(encoder, table, 1),
-      encode_rom(encoder, table, 2), encode_rom(encoder, table, 3),
-      encode_rom(encoder, table, 4), encode_rom(encoder, table, 5),
-      encode_rom(encoder, table, 6), encode_rom(encoder, table, 7),
+      encode_rom(steps, 0), encode_rom(steps, 1), encode_rom(steps, 2),
+      encode_rom(steps, 3), encode_rom(steps, 4), encode_rom(steps, 5),
+      encode_rom(steps, 6), encode_rom(steps, 7),
   };
 }
 
 } // namespace
 
+InstructionMemory::Contents::Contents(const microcode::table::Table &table)
+    : encoder(table), headers(encode_headers(encoder, table)),
+      steps(encode_steps(encoder, headers, table)), roms(encode_roms(steps)) {}
+
 InstructionMemory::InstructionMemory(const microcode::table::Table &table,
                                      std::string_view name, Component *parent)
-    : Component(name, parent), encoder_(table),
-      roms_(encode_roms(encoder_, table)) {
+    : InstructionMemory(std::make_shared<const Contents>(table), name,
+                        parent) {}
+
+InstructionMemory::InstructionMemory(std::shared_ptr<const Contents> contents,
+                                     std::string_view name, Component *parent)
+    : Component(name, parent), contents_(std::move(contents)),
+      encoder_(contents_->encoder), headers_(contents_->headers),
+      steps_(contents_->steps),
+      roms_{
+          memory::ROM(contents_->roms[0], "rom_0"),
+          memory::ROM(contents_->roms[1], "rom_1"),
+          memory::ROM(contents_->roms[2], "rom_2"),
+          memory::ROM(contents_->roms[3], "rom_3"),
+          memory::ROM(contents_->roms[4], "rom_4"),
+          memory::ROM(contents_->roms[5], "rom_5"),
+          memory::ROM(contents_->roms[6], "rom_6"),
+          memory::ROM(contents_->roms[7], "rom_7"),
+      } {
   for (auto &rom : roms_) {
     add_child(&rom);
   }
 }
 
 uint64_t InstructionMemory::read(uint16_t address) const {
-  uint64_t value = 0;
-  for (size_t rom_index = 0; rom_index < roms_.size(); rom_index++) {
-    const uint64_t rom_value = roms_[rom_index].read(address);
-    const uint64_t shifted_rom_value = rom_value << (8 * rom_index);
-    value |= shifted_rom_value;
+  const size_t num_step_index_bits = encoder_.num_step_index_bits();
+  const size_t num_status_bits = encoder_.num_status_bits();
+  if (encoder_.num_address_bits() > 16) {
+    std::ostringstream os;
+    os << "Too many address bits to read by flat address: "
+       << encoder_.num_address_bits();
+    throw std::invalid_argument(os.str());
   }
-  return value;
+  if ((address >> encoder_.num_address_bits()) != 0) {
+    return 0;
+  }
+  const uint8_t opcode = address >> (num_status_bits + num_step_index_bits);
+  const uint32_t encoded_statuses =
+      (address >> num_step_index_bits) & ((1 << num_status_bits) - 1);
+  const uint8_t step_index = address & ((1 << num_step_index_bits) - 1);
+  return read_encoded(opcode, encoded_statuses, step_index);
+}
+
+uint64_t InstructionMemory::read_encoded(uint8_t opcode,
+                                         uint32_t encoded_statuses,
+                                         uint8_t step_index) const {
+  if (opcode < headers_.size()) {
+    const auto &header = headers_[opcode];
+    if (step_index < header.num_steps) {
+      return steps_[header.offset +
+                    status_block(encoded_statuses, header.status_mask) *
+                        header.num_steps +
+                    step_index];
+    }
+  }
+  encoder_.check_bounds(opcode, step_index);
+  return 0;
 }
 
 std::set<const hdl::ControlDecl *>
 InstructionMemory::read(uint8_t opcode, const CompleteStatuses &statuses,
                         uint8_t step_index) const {
-  const auto address = encoder_.encode_address(opcode, statuses, step_index);
-  return encoder_.decode_value(read(address));
+  return encoder_.decode_value(read_encoded(
+      opcode, encoder_.status_encoder().encode(statuses), step_index));
 }
 
 std::set<const hdl::ControlDecl *>
@@ -72,4 +206,31 @@ const InstructionEncoder &InstructionMemory::encoder() const {
   return encoder_;
 }
 
+const std::vector<InstructionMemory::Header> &
+InstructionMemory::headers() const {
+  return headers_;
+}
+
+const std::vector<uint64_t> &InstructionMemory::steps() const {
+  return steps_;
+}
+
+const std::array<memory::ROM, 8> &InstructionMemory::roms() const {
+  return roms_;
+}
+
+uint64_t InstructionMemory::read_roms(size_t index) const {
+  if (index >= steps_.size()) {
+    std::ostringstream os;
+    os << "Step " << index << " out of range for instruction memory with "
+       << steps_.size() << " steps";
+    throw std::out_of_range(os.str());
+  }
+  uint64_t value = 0;
+  for (size_t rom_index = 0; rom_index < roms_.size(); ++rom_index) {
+    value |= uint64_t(roms_[rom_index].bytes()[index]) << (8 * rom_index);
+  }
+  return value;
+}
+
 } // namespace irata::sim::components::controller
@@ -1,8 +1,13 @@
+#include <algorithm>
 #include <irata/sim/components/controller/complete_statuses.hpp>
 #include <irata/sim/components/controller/partial_statuses.hpp>
+#include <irata/sim/components/controller/path_indices.hpp>
 #include <irata/sim/components/controller/status_encoder.hpp>
 #include <sstream>
 #include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace irata::sim::components::controller {
 
@@ -18,28 +23,17 @@ get_statuses(const microcode::table::Table &table) {
   }
   return statuses;
 }
-
-std::map<const hdl::StatusDecl *, size_t>
-build_indices(const microcode::table::Table &table) {
-  const auto statuses = get_statuses(table);
-  std::map<const hdl::StatusDecl *, size_t> indices;
-  size_t index = 0;
-  for (const auto &status : statuses) {
-    indices[status] = index++;
-  }
-  return indices;
-}
-
 } // namespace
 
 StatusEncoder::StatusEncoder(const microcode::table::Table &table)
-    : indices_(build_indices(table)) {
-  if (indices_.size() > 8) {
+    : indices_(build_path_indices(get_statuses(table), "statuses")),
+      statuses_(by_path_index(indices_)) {
+  if (indices_.size() > max_statuses) {
     throw std::invalid_argument("Too many statuses to encode");
   }
 }
 
-uint8_t StatusEncoder::encode(const CompleteStatuses &statuses) const {
+uint32_t StatusEncoder::encode(const CompleteStatuses &statuses) const {
   const auto &status_values = statuses.statuses();
   // Throw an error if any statuses are not set.
   for (const auto &[status, _] : indices_) {
@@ -47,11 +41,11 @@ uint8_t StatusEncoder::encode(const CompleteStatuses &statuses) const {
       throw std::invalid_argument("Missing status: " + status->path());
     }
   }
-  uint8_t encoded_statuses = 0;
+  uint32_t encoded_statuses = 0;
   for (const auto &[status, value] : status_values) {
     if (const auto it = indices_.find(status); it != indices_.end()) {
       if (value) {
-        encoded_statuses |= (1 << it->second);
+        encoded_statuses |= uint32_t(1) << it->second;
       }
     } else {
       std::ostringstream os;
@@ -62,19 +56,19 @@ uint8_t StatusEncoder::encode(const CompleteStatuses &statuses) const {
   return encoded_statuses;
 }
 
-std::vector<uint8_t>
+std::vector<uint32_t>
 StatusEncoder::encode(const PartialStatuses &statuses) const {
-  std::vector<uint8_t> encoded_statuses;
+  std::vector<uint32_t> encoded_statuses;
   for (const auto &permuted_statuses : permute(statuses)) {
     encoded_statuses.push_back(encode(permuted_statuses));
   }
   return encoded_statuses;
 }
 
-CompleteStatuses StatusEncoder::decode(uint8_t encoded_statuses) const {
+CompleteStatuses StatusEncoder::decode(uint32_t encoded_statuses) const {
   std::map<const hdl::StatusDecl *, bool> statuses;
   for (const auto &[status, index] : indices_) {
-    statuses[status] = (encoded_statuses & (1 << index)) != 0;
+    statuses[status] = (encoded_statuses >> index) & 1;
   }
   return CompleteStatuses(*this, statuses);
 }
@@ -85,7 +79,7 @@ StatusEncoder::permute(const PartialStatuses &partial_statuses) const {
 
   // Gather all known statuses
   std::vector<const hdl::StatusDecl *> unset_statuses;
-  for (const auto &[status, _] : indices_) {
+  for (const auto *status : statuses_) {
     if (partial_status_values.find(status) == partial_status_values.end()) {
       unset_statuses.push_back(status);
     }
@@ -116,4 +110,14 @@ std::set<const hdl::StatusDecl *> StatusEncoder::statuses() const {
   return statuses;
 }
 
+const std::vector<const hdl::StatusDecl *> &
+StatusEncoder::statuses_by_index() const {
+  return statuses_;
+}
+
+const std::map<const hdl::StatusDecl *, size_t> &
+StatusEncoder::indices() const {
+  return indices_;
+}
+
 } // namespace irata::sim::components::controller
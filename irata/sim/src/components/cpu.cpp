@@ -5,8 +5,15 @@ namespace irata::sim::components {
 
 Cpu::Cpu(microcode::table::Table microcode_table, ByteBus &data_bus,
          WordBus &address_bus, Component *parent)
+    : Cpu(std::make_shared<const controller::InstructionMemory::Contents>(
+              microcode_table),
+          data_bus, address_bus, parent) {}
+
+Cpu::Cpu(
+    std::shared_ptr<const controller::InstructionMemory::Contents> microcode,
+    ByteBus &data_bus, WordBus &address_bus, Component *parent)
     : Component("cpu", parent),
-      controller_(microcode_table, data_bus, "controller", this),
+      controller_(std::move(microcode), data_bus, "controller", this),
       a_("a", &data_bus, this), x_("x", &data_bus, this),
       y_("y", &data_bus, this), pc_("pc", &address_bus, &data_bus, this),
       carry_("carry", this), alu_(*this, data_bus, carry_),
@@ -19,8 +26,8 @@ Cpu::Cpu(microcode::table::Table microcode_table, ByteBus &data_bus,
 }
 
 Cpu Cpu::irata(ByteBus &data_bus, WordBus &address_bus, Component *parent) {
-  return Cpu(microcode::compiler::Compiler::compile_irata(), data_bus,
-             address_bus, parent);
+  return Cpu(controller::Controller::irata_microcode(), data_bus, address_bus,
+             parent);
 }
 
 hdl::ComponentType Cpu::type() const { return hdl::ComponentType::Cpu; }
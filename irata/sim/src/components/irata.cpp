@@ -2,7 +2,7 @@
 
 namespace irata::sim::components {
 
-Irata::Irata(std::unique_ptr<memory::ROM> cartridge)
+Irata::Irata(std::unique_ptr<memory::Module> cartridge)
     : Component("irata", nullptr), data_bus_("data_bus", this),
       address_bus_("address_bus", this),
       cpu_(Cpu::irata(data_bus_, address_bus_, this)),
@@ -12,6 +12,13 @@ Irata::Irata(std::unique_ptr<memory::ROM> cartridge)
       halt_("halt", hdl::TickPhase::Process, this),
       crash_("crash", hdl::TickPhase::Process, this) {
   cpu_.pc().set_value(Word(0x8000));
+  // The microcode loads the memory address register from the pc at the end of
+  // each instruction for the next fetch, so start with it loaded for the
+  // first.
+  memory_.set_address(cpu_.pc().value());
+  // The tree is complete, so resolve the controller's controls and statuses
+  // up front rather than on the first tick.
+  cpu_.controller().bind();
 }
 
 hdl::ComponentType Irata::type() const { return hdl::ComponentType::Irata; }
@@ -34,7 +41,19 @@ Control &Irata::halt() { return halt_; }
 const Control &Irata::crash() const { return crash_; }
 Control &Irata::crash() { return crash_; }
 
+std::set<hdl::TickPhase> Irata::tick_phases() const {
+  return {hdl::TickPhase::Process};
+}
+
 void Irata::tick_process(Logger &logger) {
+  // Irata is the root, so this runs before any other component processes and
+  // after every bus has been written.
+  if (recorder_ != nullptr) {
+    record_tick();
+  }
+  if (profile_ != nullptr) {
+    profile_tick();
+  }
   if (halt_.value()) {
     logger << "halted";
     halt_received_ = true;
@@ -45,15 +64,32 @@ void Irata::tick_process(Logger &logger) {
   }
 }
 
-Irata::Result Irata::tick_until_halt(int max_ticks) {
+std::optional<Irata::Result> Irata::result() const {
+  if (crash_received_) {
+    return Result::Crash;
+  }
+  if (halt_received_) {
+    return Result::Halt;
+  }
+  return std::nullopt;
+}
+
+Irata::Result Irata::tick_until_halt(int max_ticks, LogLevel log_level) {
   int tick = 0;
   while (!halt_received_ && !crash_received_ &&
          (max_ticks < 0 || tick++ < max_ticks)) {
-    std::cout << "ticking irata:\n  pc = " << cpu_.pc().value()
-              << "\n  opcode = " << cpu_.controller().opcode()
-              << "\n  step counter = " << cpu_.controller().step_counter()
-              << "\n";
-    this->tick();
+    switch (log_level) {
+    case LogLevel::Quiet:
+      this->tick_quiet();
+      break;
+    case LogLevel::Trace:
+      std::cout << "ticking irata:\n  pc = " << cpu_.pc().value()
+                << "\n  opcode = " << cpu_.controller().opcode()
+                << "\n  step counter = " << cpu_.controller().step_counter()
+                << "\n";
+      this->tick();
+      break;
+    }
   }
   if (max_ticks > 0 && tick >= max_ticks) {
     throw std::runtime_error("max ticks reached");
@@ -64,4 +100,98 @@ Irata::Result Irata::tick_until_halt(int max_ticks) {
   return Result::Halt;
 }
 
+std::unique_ptr<Irata> Irata::fork() const {
+  std::unique_ptr<memory::Module> cartridge;
+  for (const auto &region : memory_.regions()) {
+    if (region->name() == "cartridge") {
+      cartridge = region->module().clone();
+    }
+  }
+  auto fork = std::make_unique<Irata>(std::move(cartridge));
+  fork->copy_state_from(*this);
+  return fork;
+}
+
+void Irata::set_recorder(trace::Recorder *recorder) { recorder_ = recorder; }
+
+trace::Recorder *Irata::recorder() const { return recorder_; }
+
+trace::Header Irata::trace_header() const {
+  return trace::Header::from_encoder(
+      cpu_.controller().instruction_memory().encoder());
+}
+
+void Irata::record_tick() {
+  const auto &read = cpu_.controller().last_read();
+  trace::Record record;
+  record.opcode = read.opcode;
+  record.step_counter = read.step_counter;
+  record.encoded_statuses = read.encoded_statuses;
+  record.encoded_controls = read.encoded_controls;
+  if (const auto value = data_bus_.value()) {
+    record.data_bus = value->unsigned_value();
+  }
+  if (const auto value = address_bus_.value()) {
+    record.address_bus = value->value();
+  }
+  recorder_->record(record);
+}
+
+void Irata::set_profile(profile::Profile *profile) {
+  profile_ = profile;
+  memory_.set_profile(profile);
+  const auto &controller = cpu_.controller();
+  opcode_read_bit_ = std::nullopt;
+  if (const auto *read = dynamic_cast<const Control *>(
+          controller.opcode_register().child("read"))) {
+    opcode_read_bit_ = controller.control_index(*read);
+  }
+  alu_opcode_bits_.clear();
+  for (const auto &control : cpu_.alu().opcode_controls()) {
+    alu_opcode_bits_.push_back(controller.control_index(*control));
+  }
+}
+
+profile::Profile *Irata::profile() const { return profile_; }
+
+void Irata::profile_tick() {
+  const auto &controller = cpu_.controller();
+  const auto encoded_controls = controller.last_read().encoded_controls;
+  const auto asserted = [encoded_controls](std::optional<size_t> bit) {
+    return bit && (encoded_controls & (1ull << *bit)) != 0;
+  };
+  std::optional<uint8_t> loaded_opcode;
+  // The opcode register reads in the read phase, so by now it holds the
+  // opcode it loaded this tick.
+  if (asserted(opcode_read_bit_)) {
+    loaded_opcode = controller.opcode().unsigned_value();
+  }
+  profile_->count_tick(controller.last_read().step_counter, loaded_opcode);
+  if (data_bus_.value()) {
+    profile_->count_bus_transfer(data_bus_.name());
+  }
+  if (address_bus_.value()) {
+    profile_->count_bus_transfer(address_bus_.name());
+  }
+  uint8_t alu_opcode = 0;
+  for (size_t i = 0; i < alu_opcode_bits_.size(); ++i) {
+    if (asserted(alu_opcode_bits_[i])) {
+      alu_opcode |= 1 << i;
+    }
+  }
+  if (alu_opcode != 0) {
+    profile_->count_alu_operation(static_cast<hdl::AluOpcode>(alu_opcode));
+  }
+}
+
+void Irata::save_state(StateWriter &writer) const {
+  writer.write_bool(halt_received_);
+  writer.write_bool(crash_received_);
+}
+
+void Irata::load_state(StateReader &reader) {
+  halt_received_ = reader.read_bool();
+  crash_received_ = reader.read_bool();
+}
+
 } // namespace irata::sim::components
@@ -80,11 +80,17 @@ void Address::set_value(Word value) {
   set_low(low);
 }
 
+std::set<hdl::TickPhase> Address::tick_phases() const {
+  return {hdl::TickPhase::Write, hdl::TickPhase::Read, hdl::TickPhase::Process};
+}
+
 void Address::tick_write(Logger &logger) {
   if (write()) {
     const auto value = this->value();
     address_bus_.set_value(value, *this);
-    logger << "Wrote " << value << " to " << address_bus_.path();
+    if (logger.enabled()) {
+      logger << "Wrote " << value << " to " << address_bus_.path();
+    }
   }
 }
 
@@ -92,7 +98,9 @@ void Address::tick_read(Logger &logger) {
   if (read()) {
     if (const auto value = address_bus_.value(); value != std::nullopt) {
       set_value(*value);
-      logger << "Read " << *value << " from " << address_bus_.path();
+      if (logger.enabled()) {
+        logger << "Read " << *value << " from " << address_bus_.path();
+      }
     } else {
       std::ostringstream os;
       os << path() << " reading from open bus " << address_bus_.path();
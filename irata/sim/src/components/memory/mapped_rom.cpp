@@ -0,0 +1,122 @@
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <irata/sim/components/memory/mapped_rom.hpp>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace irata::sim::components::memory {
+
+// Owns a read-only mapping of a whole file. Empty files aren't mapped, since
+// mmap rejects zero length mappings.
+class MappedROM::Mapping {
+public:
+  explicit Mapping(const std::string &path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw error("failed to open", path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      const auto e = error("failed to stat", path);
+      ::close(fd);
+      throw e;
+    }
+    size_ = st.st_size;
+    if (size_ > 0) {
+      void *data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        const auto e = error("failed to map", path);
+        ::close(fd);
+        throw e;
+      }
+      data_ = static_cast<const uint8_t *>(data);
+    }
+    // The mapping stays valid after the file is closed.
+    ::close(fd);
+  }
+
+  Mapping(const Mapping &) = delete;
+  Mapping &operator=(const Mapping &) = delete;
+
+  ~Mapping() {
+    if (data_ != nullptr) {
+      ::munmap(const_cast<uint8_t *>(data_), size_);
+    }
+  }
+
+  const uint8_t *data() const { return data_; }
+  size_t size() const { return size_; }
+
+private:
+  const uint8_t *data_ = nullptr;
+  size_t size_ = 0;
+
+  static std::runtime_error error(std::string_view what,
+                                  const std::string &path) {
+    return std::runtime_error(std::string(what) + " cartridge " + path + ": " +
+                              std::strerror(errno));
+  }
+};
+
+namespace {
+
+void validate_size(size_t size, size_t file_size, const std::string &path) {
+  // Throw an exception if the size is not a power of 2.
+  if ((size & (size - 1)) != 0) {
+    throw std::invalid_argument("size " + std::to_string(size) +
+                                " is not a power of 2");
+  }
+  if (file_size > size) {
+    throw std::invalid_argument("cartridge " + path + " size " +
+                                std::to_string(file_size) +
+                                " larger than rom size " +
+                                std::to_string(size));
+  }
+}
+
+} // namespace
+
+MappedROM::MappedROM(size_t size, const std::string &path,
+                     std::string_view name)
+    : MappedROM(size, std::make_shared<const Mapping>(path), name) {
+  validate_size(size_, file_size_, path);
+}
+
+MappedROM::MappedROM(size_t size, std::shared_ptr<const Mapping> mapping,
+                     std::string_view name)
+    : Module(name), mapping_(std::move(mapping)), size_(size),
+      data_(mapping_->data()), file_size_(mapping_->size()) {}
+
+size_t MappedROM::size() const { return size_; }
+
+size_t MappedROM::file_size() const { return file_size_; }
+
+Byte MappedROM::read(Word address) const {
+  if (address.value() >= size_) {
+    throw std::out_of_range("address " + std::to_string(address.value()) +
+                            " out of range for ROM " + path());
+  }
+  if (address.value() >= file_size_) {
+    return Byte(0x00);
+  }
+  return data_[address.value()];
+}
+
+void MappedROM::write(Word address, Byte value) {
+  throw std::runtime_error("ROM " + path() + " is read-only");
+}
+
+std::vector<uint8_t> MappedROM::dump() const {
+  std::vector<uint8_t> bytes(data_, data_ + file_size_);
+  bytes.resize(size_, 0x00);
+  return bytes;
+}
+
+std::unique_ptr<Module> MappedROM::clone() const {
+  return std::unique_ptr<Module>(new MappedROM(size_, mapping_, name()));
+}
+
+} // namespace irata::sim::components::memory
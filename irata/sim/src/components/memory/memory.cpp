@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <irata/sim/components/memory/memory.hpp>
 #include <irata/sim/components/memory/ram.hpp>
 #include <irata/sim/components/memory/rom.hpp>
@@ -49,6 +50,20 @@ Memory::Memory(std::string_view name,
   for (auto &region : regions_) {
     add_child(region.get());
   }
+  // Regions are aligned to their size, so a region either covers whole pages
+  // or lies within a single page.
+  for (auto &region : regions_) {
+    const size_t first_page = region->offset().value() >> page_bits;
+    if (region->size() < (size_t(1) << page_bits)) {
+      partial_pages_[first_page] = true;
+      continue;
+    }
+    const size_t end_page =
+        std::min(pages_.size(), first_page + (region->size() >> page_bits));
+    for (size_t page = first_page; page < end_page; ++page) {
+      pages_[page] = region.get();
+    }
+  }
 }
 
 hdl::ComponentType Memory::type() const { return hdl::ComponentType::Memory; }
@@ -76,20 +91,19 @@ bool Memory::read() const { return read_.value(); }
 void Memory::set_read(bool read) { read_.set_value(read); }
 
 Region &Memory::region(Word address) {
-  for (auto &region : regions_) {
-    if (region->contains_address(address)) {
-      return *region;
-    }
-  }
-  std::ostringstream os;
-  os << "memory " << path() << " using unmapped address " << address;
-  throw std::runtime_error(os.str());
+  return const_cast<Region &>(std::as_const(*this).region(address));
 }
 
 const Region &Memory::region(Word address) const {
-  for (const auto &region : regions_) {
-    if (region->contains_address(address)) {
-      return *region;
+  const size_t page = address.value() >> page_bits;
+  if (const auto *region = pages_[page]; region != nullptr) {
+    return *region;
+  }
+  if (partial_pages_[page]) {
+    for (const auto &region : regions_) {
+      if (region->contains_address(address)) {
+        return *region;
+      }
     }
   }
   std::ostringstream os;
@@ -99,6 +113,12 @@ const Region &Memory::region(Word address) const {
 
 Byte Memory::value(Word address) const { return region(address).read(address); }
 
+void Memory::set_profile(profile::Profile *profile) { profile_ = profile; }
+
+std::set<hdl::TickPhase> Memory::tick_phases() const {
+  return {hdl::TickPhase::Write, hdl::TickPhase::Read};
+}
+
 void Memory::tick_write(Logger &logger) {
   if (write()) {
     // During tick_write, bus devices write their value to the bus. So we need
@@ -107,8 +127,14 @@ void Memory::tick_write(Logger &logger) {
     auto &region = this->region(address);
     const auto data = region.read(address);
     data_bus_.set_value(data, *this);
-    logger << "Read " << data << " from address " << address << " in region "
-           << region.path() << ", writing it to " << data_bus_.path();
+    if (profile_ != nullptr) {
+      profile_->count_region_read(region.name());
+    }
+    if (logger.enabled()) {
+      logger << "Read " << data << " from address " << address
+             << " in region " << region.path() << ", writing it to "
+             << data_bus_.path();
+    }
   }
 }
 
@@ -127,9 +153,14 @@ void Memory::tick_read(Logger &logger) {
                                " but no data was written to the bus");
     }
     region.write(address, *data);
-    logger << "Read " << *data << " from " << data_bus_.path()
-           << " and wrote it to address " << address << " in region "
-           << region.path();
+    if (profile_ != nullptr) {
+      profile_->count_region_write(region.name());
+    }
+    if (logger.enabled()) {
+      logger << "Read " << *data << " from " << data_bus_.path()
+             << " and wrote it to address " << address << " in region "
+             << region.path();
+    }
   }
 }
 
@@ -1,39 +1,100 @@
+#include <algorithm>
+#include <atomic>
 #include <irata/sim/components/memory/ram.hpp>
 #include <stdexcept>
 
 namespace irata::sim::components::memory {
 
-RAM::RAM(size_t size, std::string_view name, std::map<Word, Byte> data)
-    : Module(name), size_(size), data_(data) {
+namespace {
+
+void validate_size(size_t size) {
   // Throw an exception if the size is not a power of 2.
   if ((size & (size - 1)) != 0) {
     throw std::invalid_argument("size " + std::to_string(size) +
                                 " is not a power of 2");
   }
+}
+
+// Returns the number of address bits within a page of a RAM of the given size.
+size_t page_bits(size_t size) {
+  validate_size(size);
+  size_t bits = 0;
+  while ((size_t(1) << bits) < std::min(size, RAM::page_size)) {
+    ++bits;
+  }
+  return bits;
+}
+
+} // namespace
+
+RAM::RAM(size_t size, std::string_view name, std::map<Word, Byte> data)
+    : Module(name), size_(size), page_bits_(page_bits(size)) {
+  std::vector<uint8_t> bytes(size, 0x00);
   // Throw an exception if the data is not within the range of the RAM.
-  for (const auto &[address, _] : data) {
+  for (const auto &[address, value] : data) {
     if (address.value() >= size) {
       throw std::out_of_range("address " + std::to_string(address.value()) +
                               " out of range for RAM " + path());
     }
+    bytes[address.value()] = value;
+  }
+  set_pages(bytes);
+}
+
+RAM::RAM(size_t size, std::vector<uint8_t> bytes, std::string_view name)
+    : Module(name), size_(size), page_bits_(page_bits(size)) {
+  if (bytes.size() > size_) {
+    throw std::invalid_argument("loaded data size " +
+                                std::to_string(bytes.size()) +
+                                " larger than ram size " +
+                                std::to_string(size_));
   }
+  bytes.resize(size_, 0x00);
+  set_pages(bytes);
 }
 
 size_t RAM::size() const { return size_; }
 
-const std::map<Word, Byte> &RAM::data() const { return data_; }
-std::map<Word, Byte> &RAM::data() { return data_; }
+std::map<Word, Byte> RAM::data() const {
+  std::map<Word, Byte> data;
+  const auto bytes = dump();
+  for (size_t address = 0; address < bytes.size(); ++address) {
+    if (const auto value = bytes[address]; value != 0) {
+      data.emplace(Word(address), Byte(value));
+    }
+  }
+  return data;
+}
+
+void RAM::load(const std::vector<uint8_t> &bytes, Word address) {
+  if (address.value() + bytes.size() > size_) {
+    throw std::out_of_range("loading " + std::to_string(bytes.size()) +
+                            " bytes at address " +
+                            std::to_string(address.value()) +
+                            " out of range for RAM " + path());
+  }
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    const size_t target = address.value() + i;
+    writable_page(target)[target & ((size_t(1) << page_bits_) - 1)] = bytes[i];
+  }
+}
+
+std::vector<uint8_t> RAM::dump() const {
+  std::vector<uint8_t> bytes;
+  bytes.reserve(size_);
+  for (const auto &page : pages_) {
+    bytes.insert(bytes.end(), page->begin(), page->end());
+  }
+  return bytes;
+}
 
 Byte RAM::read(Word address) const {
   if (address.value() >= size_) {
     throw std::out_of_range("address " + std::to_string(address.value()) +
                             " out of range for RAM " + path());
   }
-  if (const auto it = data_.find(address); it != data_.end()) {
-    return it->second;
-  } else {
-    return Byte(0x00);
-  }
+  return (*pages_[address.value() >> page_bits_])
+      [address.value() & ((size_t(1) << page_bits_) - 1)];
 }
 
 void RAM::write(Word address, Byte value) {
@@ -41,7 +102,62 @@ void RAM::write(Word address, Byte value) {
     throw std::out_of_range("address " + std::to_string(address.value()) +
                             " out of range for RAM " + path());
   }
-  data_[address] = value;
+  writable_page(address.value())[address.value() &
+                                 ((size_t(1) << page_bits_) - 1)] = value;
+}
+
+void RAM::share(const RAM &other) {
+  if (other.size_ != size_) {
+    throw std::invalid_argument("can't share pages of RAM " + other.path() +
+                                " of size " + std::to_string(other.size_) +
+                                " with RAM " + path() + " of size " +
+                                std::to_string(size_));
+  }
+  pages_ = other.pages_;
+}
+
+size_t RAM::num_shared_pages() const {
+  return std::count_if(pages_.begin(), pages_.end(),
+                       [](const auto &page) { return page.use_count() > 1; });
+}
+
+RAM::Page &RAM::writable_page(size_t address) {
+  auto &page = pages_[address >> page_bits_];
+  if (page.use_count() > 1) {
+    page = std::make_shared<Page>(*page);
+  } else {
+    // Another RAM may have just copied this page and dropped its reference.
+    // The fence pairs with the release in that RAM's reference drop, so its
+    // reads of the page happen before this RAM's writes to it.
+    std::atomic_thread_fence(std::memory_order_acquire);
+  }
+  return *page;
+}
+
+void RAM::set_pages(const std::vector<uint8_t> &bytes) {
+  const size_t page_size = size_t(1) << page_bits_;
+  pages_.clear();
+  for (size_t offset = 0; offset < size_; offset += page_size) {
+    pages_.push_back(std::make_shared<Page>(bytes.begin() + offset,
+                                            bytes.begin() + offset + page_size));
+  }
+}
+
+void RAM::save_state(StateWriter &writer) const { writer.write_bytes(dump()); }
+
+void RAM::load_state(StateReader &reader) {
+  std::vector<uint8_t> bytes(size_);
+  reader.read_bytes(bytes);
+  set_pages(bytes);
+}
+
+bool RAM::share_state(const Component &source) {
+  const auto *ram = dynamic_cast<const RAM *>(&source);
+  if (ram == nullptr || ram->size_ != size_) {
+    return false;
+  }
+  pages_ = ram->pages_;
+  return true;
 }
 
 } // namespace irata::sim::components::memory
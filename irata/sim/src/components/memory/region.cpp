@@ -46,7 +46,10 @@ size_t Region::size() const { return module_->size(); }
 Word Region::offset() const { return offset_; }
 
 bool Region::contains_address(Word address) const {
-  return address >= offset_ && address < offset_ + size();
+  // Compare as integers, since offset_ + size() wraps for a region that ends
+  // at the top of the address space.
+  return address.value() >= offset_.value() &&
+         address.value() < offset_.value() + size();
 }
 
 Byte Region::read(Word address) const {
@@ -70,6 +73,8 @@ void Region::write(Word address, Byte value) {
 
 bool Region::can_write() const { return module_->can_write(); }
 
+const Module &Region::module() const { return *module_; }
+
 Word Region::module_address(Word address) const {
   return Word(address.value() - offset_.value());
 }
@@ -1,17 +1,12 @@
 #include <irata/sim/components/memory/rom.hpp>
+#include <iterator>
 #include <stdexcept>
 
 namespace irata::sim::components::memory {
 
-ROM::ROM(size_t size, std::string_view name, std::map<Word, Byte> data)
-    : Module(name), size_(size), data_(std::move(data)) {
-  // Throw an exception if any data is outside [0,size).
-  for (const auto &[address, _] : data_) {
-    if (address.value() >= size) {
-      throw std::invalid_argument("address " + std::to_string(address.value()) +
-                                  " out of range for ROM " + path());
-    }
-  }
+namespace {
+
+void validate_size(size_t size) {
   // Throw an exception if the size is not a power of 2.
   if ((size & (size - 1)) != 0) {
     throw std::invalid_argument("size " + std::to_string(size) +
@@ -19,44 +14,93 @@ ROM::ROM(size_t size, std::string_view name, std::map<Word, Byte> data)
   }
 }
 
-namespace {
+// Flattens sparse data into a buffer of the given size.
+std::vector<uint8_t> flatten(size_t size, const std::map<Word, Byte> &data,
+                             const Component &rom) {
+  // Throw an exception if any data is outside [0,size).
+  for (const auto &[address, _] : data) {
+    if (address.value() >= size) {
+      throw std::invalid_argument("address " + std::to_string(address.value()) +
+                                  " out of range for ROM " + rom.path());
+    }
+  }
+  validate_size(size);
+  std::vector<uint8_t> bytes(size, 0x00);
+  for (const auto &[address, value] : data) {
+    bytes[address.value()] = value;
+  }
+  return bytes;
+}
 
-std::map<Word, Byte> load(size_t size, std::istream &is) {
-  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(is)),
-                             (std::istreambuf_iterator<char>()));
-  if (bytes.size() >= size) {
-    throw std::invalid_argument("loaded data size " + std::to_string(size) +
+// Pads a buffer with zeros to the given size.
+std::vector<uint8_t> pad(size_t size, std::vector<uint8_t> bytes) {
+  validate_size(size);
+  if (bytes.size() > size) {
+    throw std::invalid_argument("loaded data size " +
+                                std::to_string(bytes.size()) +
                                 " larger than rom size " +
                                 std::to_string(size));
   }
-  std::map<Word, Byte> data;
-  for (size_t i = 0; i < bytes.size(); ++i) {
-    if (const auto byte = bytes[i]; byte != 0) {
-      data[Word(i)] = byte;
-    }
-  }
-  return data;
+  bytes.resize(size, 0x00);
+  return bytes;
+}
+
+// Reads a whole stream. The ROM constructor pads and checks its size.
+std::vector<uint8_t> load(std::istream &is) {
+  return std::vector<uint8_t>((std::istreambuf_iterator<char>(is)),
+                              (std::istreambuf_iterator<char>()));
 }
 
 } // namespace
 
+ROM::ROM(size_t size, std::string_view name, std::map<Word, Byte> data)
+    : Module(name), size_(size),
+      bytes_(std::make_shared<const std::vector<uint8_t>>(
+          flatten(size, data, *this))),
+      data_(bytes_->data()) {}
+
+ROM::ROM(size_t size, std::vector<uint8_t> bytes, std::string_view name)
+    : Module(name), size_(size),
+      bytes_(std::make_shared<const std::vector<uint8_t>>(
+          pad(size, std::move(bytes)))),
+      data_(bytes_->data()) {}
+
 ROM::ROM(size_t size, std::istream &is, std::string_view name)
-    : ROM(size, name, load(size, is)) {}
+    : ROM(size, load(is), name) {}
+
+ROM::ROM(std::shared_ptr<const std::vector<uint8_t>> bytes,
+         std::string_view name)
+    : Module(name), size_(bytes->size()), bytes_(std::move(bytes)),
+      data_(bytes_->data()) {
+  validate_size(size_);
+}
+
+std::unique_ptr<Module> ROM::clone() const {
+  return std::make_unique<ROM>(bytes_, name());
+}
 
 size_t ROM::size() const { return size_; }
 
-const std::map<Word, Byte> &ROM::data() const { return data_; }
+std::map<Word, Byte> ROM::data() const {
+  std::map<Word, Byte> data;
+  for (size_t address = 0; address < size_; ++address) {
+    if (const auto value = data_[address]; value != 0) {
+      data.emplace(Word(address), Byte(value));
+    }
+  }
+  return data;
+}
+
+const std::vector<uint8_t> &ROM::bytes() const { return *bytes_; }
+
+std::vector<uint8_t> ROM::dump() const { return *bytes_; }
 
 Byte ROM::read(Word address) const {
   if (address.value() >= size_) {
     throw std::out_of_range("address " + std::to_string(address.value()) +
                             " out of range for ROM " + path());
   }
-  if (auto it = data_.find(address); it != data_.end()) {
-    return it->second;
-  } else {
-    return Byte(0x00);
-  }
+  return data_[address.value()];
 }
 
 void ROM::write(Word address, Byte value) {
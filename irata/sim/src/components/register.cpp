@@ -46,10 +46,16 @@ void Register::set_read(bool value) {
 bool Register::reset() const { return reset_.value(); }
 void Register::set_reset(bool value) { reset_.set_value(value); }
 
+std::set<hdl::TickPhase> Register::tick_phases() const {
+  return {hdl::TickPhase::Write, hdl::TickPhase::Read, hdl::TickPhase::Process};
+}
+
 void Register::tick_write(Logger &logger) {
   if (const auto write = this->write(); write && *write) {
     bus_->set_value(value_, *this);
-    logger << "wrote " << value_ << " to " << bus_->path();
+    if (logger.enabled()) {
+      logger << "wrote " << value_ << " to " << bus_->path();
+    }
   }
 }
 
@@ -57,7 +63,9 @@ void Register::tick_read(Logger &logger) {
   if (const auto read = this->read(); read && *read) {
     if (const auto value = bus_->value(); value) {
       set_value(*value);
-      logger << "read " << value_ << " from " << bus_->path();
+      if (logger.enabled()) {
+        logger << "read " << value_ << " from " << bus_->path();
+      }
     } else {
       throw std::logic_error(path() + " reading from open bus");
     }
@@ -74,6 +82,14 @@ void Register::serialize(Serializer &serializer) const {
   serializer.property("value", value());
 }
 
+void Register::save_state(StateWriter &writer) const {
+  writer.write_byte(value_.unsigned_value());
+}
+
+void Register::load_state(StateReader &reader) {
+  value_ = Byte(reader.read_byte());
+}
+
 hdl::ComponentType Register::type() const {
   return hdl::ComponentType::Register;
 }
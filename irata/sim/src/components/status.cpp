@@ -17,4 +17,10 @@ std::vector<Status *> Status::statuses() {
 
 hdl::ComponentType Status::type() const { return hdl::ComponentType::Status; }
 
+void Status::save_state(StateWriter &writer) const {
+  writer.write_bool(value_);
+}
+
+void Status::load_state(StateReader &reader) { value_ = reader.read_bool(); }
+
 } // namespace irata::sim::components
@@ -60,6 +60,12 @@ const Control &StatusRegister::clear_carry() const { return clear_carry_; }
 
 Control &StatusRegister::clear_carry() { return clear_carry_; }
 
+std::set<hdl::TickPhase> StatusRegister::tick_phases() const {
+  auto phases = Register::tick_phases();
+  phases.insert(hdl::TickPhase::Clear);
+  return phases;
+}
+
 void StatusRegister::tick_process(Logger &logger) {
   const bool set_carry = set_carry_.value();
   const bool clear_carry = clear_carry_.value();
@@ -83,7 +89,9 @@ void StatusRegister::tick_clear(Logger &logger) {
     // Latch the status values into the register.`
     uint8_t value = 0x00;
     for (const auto &[status, index] : status_indices_) {
-      logger << ", " << status->name() << " = " << status->value();
+      if (logger.enabled()) {
+        logger << ", " << status->name() << " = " << status->value();
+      }
       value |= status->value() << index;
     }
     set_value(value);
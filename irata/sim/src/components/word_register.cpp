@@ -63,6 +63,10 @@ bool WordRegister::reset() const { return reset_.value(); }
 
 void WordRegister::set_reset(bool value) { reset_.set_value(value); }
 
+std::set<hdl::TickPhase> WordRegister::tick_phases() const {
+  return {hdl::TickPhase::Write, hdl::TickPhase::Read, hdl::TickPhase::Process};
+}
+
 void WordRegister::tick_write(Logger &logger) {
   if (const auto write = this->write(); write && *write) {
     logger << "writing " << value();
@@ -0,0 +1,316 @@
+#include <algorithm>
+#include <irata/asm/instruction_set.hpp>
+#include <irata/sim/components/memory/rom.hpp>
+#include <irata/sim/interpreter/differential_checker.hpp>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace irata::sim::interpreter {
+
+namespace {
+
+// Pads the cartridge with zeros to the next power of two, which is the
+// smallest ROM that the simulated machine can map.
+std::vector<uint8_t> pad_cartridge(std::vector<uint8_t> cartridge) {
+  if (cartridge.size() > 0x8000) {
+    std::ostringstream os;
+    os << "cartridge of size " << cartridge.size()
+       << " doesn't fit in the cartridge region";
+    throw std::invalid_argument(os.str());
+  }
+  size_t size = 1;
+  while (size < cartridge.size()) {
+    size <<= 1;
+  }
+  cartridge.resize(size, 0);
+  return cartridge;
+}
+
+std::optional<Interpreter::Result>
+interpreter_result(std::optional<components::Irata::Result> result) {
+  if (!result) {
+    return std::nullopt;
+  }
+  switch (*result) {
+  case components::Irata::Result::Halt:
+    return Interpreter::Result::Halt;
+  case components::Irata::Result::Crash:
+    return Interpreter::Result::Crash;
+  }
+  throw std::logic_error("unknown irata result");
+}
+
+std::string result_string(std::optional<Interpreter::Result> result) {
+  if (!result) {
+    return "running";
+  }
+  std::ostringstream os;
+  os << *result;
+  return os.str();
+}
+
+template <typename T>
+void compare_value(std::vector<std::string> &differences,
+                   std::string_view what, const T &interpreter,
+                   const T &sim) {
+  if (interpreter != sim) {
+    std::ostringstream os;
+    os << what << ": interpreter=" << interpreter << " sim=" << sim;
+    differences.push_back(os.str());
+  }
+}
+
+// The instructions that random programs are built from, which is every
+// instruction that doesn't stop the program or transfer control.
+std::vector<const asm_::Instruction *> straight_line_instructions() {
+  static const std::set<std::string> excluded = {"HLT", "CRS", "JMP", "JNE",
+                                                 "JEQ", "JSR", "RTS"};
+  std::vector<const asm_::Instruction *> instructions;
+  for (const auto &instruction : asm_::InstructionSet::irata().instructions()) {
+    if (excluded.count(instruction.name()) == 0) {
+      instructions.push_back(&instruction);
+    }
+  }
+  return instructions;
+}
+
+size_t operand_size(asm_::AddressingMode addressing_mode) {
+  switch (addressing_mode) {
+  case asm_::AddressingMode::None:
+    return 0;
+  case asm_::AddressingMode::Immediate:
+  case asm_::AddressingMode::ZeroPage:
+  case asm_::AddressingMode::ZeroPageX:
+  case asm_::AddressingMode::ZeroPageY:
+    return 1;
+  case asm_::AddressingMode::Absolute:
+  case asm_::AddressingMode::AbsoluteX:
+  case asm_::AddressingMode::AbsoluteY:
+    return 2;
+  }
+  throw std::logic_error("unknown addressing mode");
+}
+
+} // namespace
+
+DifferentialChecker::DifferentialChecker(const std::vector<uint8_t> &cartridge)
+    : cartridge_(pad_cartridge(cartridge)), interpreter_(cartridge_),
+      irata_(std::make_unique<components::memory::ROM>(
+          cartridge_.size(), cartridge_, "cartridge")) {}
+
+const Interpreter &DifferentialChecker::interpreter() const {
+  return interpreter_;
+}
+
+const components::Irata &DifferentialChecker::irata() const { return irata_; }
+
+void DifferentialChecker::step_irata() {
+  for (int tick = 0; tick < max_ticks_per_instruction; ++tick) {
+    irata_.tick_quiet();
+    if (irata_.result() ||
+        irata_.cpu().controller().step_counter() == Byte(0)) {
+      return;
+    }
+  }
+  std::ostringstream os;
+  os << "sim didn't reach an instruction boundary within "
+     << max_ticks_per_instruction << " ticks";
+  throw std::runtime_error(os.str());
+}
+
+std::vector<std::string> DifferentialChecker::compare() const {
+  std::vector<std::string> differences;
+  const auto &cpu = irata_.cpu();
+  const auto &status_register = cpu.status_register();
+  compare_value(differences, "result", result_string(interpreter_.result()),
+                result_string(interpreter_result(irata_.result())));
+  compare_value(differences, "a", interpreter_.a(), cpu.a().value());
+  compare_value(differences, "x", interpreter_.x(), cpu.x().value());
+  compare_value(differences, "y", interpreter_.y(), cpu.y().value());
+  compare_value(differences, "stack_pointer", interpreter_.stack_pointer(),
+                cpu.stack_pointer().value());
+  compare_value(differences, "pc", interpreter_.pc(), cpu.pc().value());
+  compare_value(differences, "status_register",
+                interpreter_.status_register(), status_register.value());
+  const auto &status = interpreter_.status();
+  compare_value(differences, "carry", status.carry,
+                status_register.carry_out().value());
+  compare_value(differences, "zero", status.zero,
+                status_register.zero_out().value());
+  compare_value(differences, "negative", status.negative,
+                status_register.negative_out().value());
+  compare_value(differences, "overflow", status.overflow,
+                status_register.overflow_out().value());
+
+  // RAM is small enough that comparing all of it is cheaper than tracking
+  // which addresses each engine wrote, and it also catches stray writes.
+  const auto &regions = irata_.memory().regions();
+  const auto ram = std::find_if(
+      regions.begin(), regions.end(),
+      [](const auto &region) { return region->offset() == Word(0x0000); });
+  if (ram == regions.end()) {
+    throw std::logic_error("sim has no ram region");
+  }
+  const auto sim_ram = (*ram)->module().dump();
+  const auto &interpreter_memory = interpreter_.memory();
+  if (!std::equal(sim_ram.begin(), sim_ram.end(), interpreter_memory.begin())) {
+    for (size_t address = 0; address < sim_ram.size(); ++address) {
+      if (sim_ram[address] != interpreter_memory[address]) {
+        std::ostringstream os;
+        os << "memory[" << Word(address) << "]";
+        compare_value(differences, os.str(), Byte(interpreter_memory[address]),
+                      Byte(sim_ram[address]));
+      }
+    }
+  }
+  return differences;
+}
+
+std::optional<DifferentialChecker::Divergence>
+DifferentialChecker::run(int max_instructions) {
+  if (auto differences = compare(); !differences.empty()) {
+    return Divergence{0, std::nullopt, "", std::move(differences)};
+  }
+  while (!interpreter_.result()) {
+    if (max_instructions >= 0 &&
+        interpreter_.instruction_count() >=
+            static_cast<uint64_t>(max_instructions)) {
+      throw std::runtime_error("max instructions reached");
+    }
+    const Word pc = interpreter_.pc();
+    std::string instruction;
+    try {
+      const auto &decoded =
+          asm_::InstructionSet::irata().get_instruction(interpreter_.read(pc));
+      std::ostringstream os;
+      os << decoded.name() << " " << decoded.addressing_mode();
+      instruction = os.str();
+    } catch (const std::exception &) {
+      // Unknown opcodes and unmapped pcs are reported by step() below.
+    }
+    const uint64_t instruction_count = interpreter_.instruction_count();
+
+    std::exception_ptr interpreter_error;
+    std::optional<std::string> irata_error;
+    try {
+      interpreter_.step();
+    } catch (const std::exception &) {
+      interpreter_error = std::current_exception();
+    }
+    try {
+      step_irata();
+    } catch (const std::exception &e) {
+      irata_error = e.what();
+    }
+    if (interpreter_error && irata_error) {
+      std::rethrow_exception(interpreter_error);
+    }
+    std::vector<std::string> differences;
+    if (interpreter_error) {
+      try {
+        std::rethrow_exception(interpreter_error);
+      } catch (const std::exception &e) {
+        differences.push_back(std::string("interpreter threw: ") + e.what());
+      }
+    } else if (irata_error) {
+      differences.push_back("sim threw: " + *irata_error);
+    } else {
+      differences = compare();
+    }
+    if (!differences.empty()) {
+      return Divergence{instruction_count, pc, std::move(instruction),
+                        std::move(differences)};
+    }
+  }
+  return std::nullopt;
+}
+
+std::vector<uint8_t>
+DifferentialChecker::random_program(std::mt19937 &rng,
+                                    size_t num_instructions) {
+  static const auto instructions = straight_line_instructions();
+  static const auto jumps = [] {
+    const auto &instruction_set = asm_::InstructionSet::irata();
+    return std::vector<const asm_::Instruction *>{
+        &instruction_set.get_instruction("jmp", asm_::AddressingMode::Absolute),
+        &instruction_set.get_instruction("jne", asm_::AddressingMode::Absolute),
+        &instruction_set.get_instruction("jeq", asm_::AddressingMode::Absolute),
+    };
+  }();
+  std::uniform_int_distribution<int> byte(0x00, 0xFF);
+  // Absolute operands leave room for an index of up to 0xFF without leaving
+  // RAM.
+  std::uniform_int_distribution<int> absolute_page(
+      0x00, (Interpreter::ram_size >> 8) - 2);
+  std::uniform_int_distribution<size_t> instruction_index(
+      0, instructions.size() - 1);
+  std::uniform_int_distribution<size_t> jump_index(0, jumps.size() - 1);
+  std::uniform_int_distribution<int> percent(0, 99);
+
+  // Lay out the instructions first, leaving jump targets to be filled in once
+  // the address of every instruction is known.
+  std::vector<uint8_t> program;
+  std::vector<uint16_t> instruction_addresses;
+  std::vector<std::pair<size_t, size_t>> jump_fixups;
+  for (size_t i = 0; i < num_instructions; ++i) {
+    instruction_addresses.push_back(Interpreter::cartridge_address +
+                                    program.size());
+    if (percent(rng) < 10) {
+      program.push_back(
+          jumps[jump_index(rng)]->opcode().unsigned_value());
+      jump_fixups.emplace_back(program.size(), i);
+      program.push_back(0);
+      program.push_back(0);
+      continue;
+    }
+    const auto &instruction = *instructions[instruction_index(rng)];
+    program.push_back(instruction.opcode().unsigned_value());
+    switch (operand_size(instruction.addressing_mode())) {
+    case 0:
+      break;
+    case 1:
+      program.push_back(byte(rng));
+      break;
+    case 2:
+      program.push_back(absolute_page(rng));
+      program.push_back(byte(rng));
+      break;
+    }
+  }
+  instruction_addresses.push_back(Interpreter::cartridge_address +
+                                  program.size());
+  program.push_back(asm_::InstructionSet::irata()
+                        .get_instruction("hlt", asm_::AddressingMode::None)
+                        .opcode()
+                        .unsigned_value());
+
+  // Each jump targets a random later instruction or the final hlt.
+  for (const auto &[operand, index] : jump_fixups) {
+    std::uniform_int_distribution<size_t> target_index(index + 1,
+                                                       num_instructions);
+    const uint16_t target = instruction_addresses[target_index(rng)];
+    program[operand] = target >> 8;
+    program[operand + 1] = target & 0xFF;
+  }
+  return program;
+}
+
+std::ostream &operator<<(std::ostream &os,
+                         const DifferentialChecker::Divergence &divergence) {
+  os << "divergence after " << std::dec << divergence.instruction_count
+     << " instructions";
+  if (divergence.pc) {
+    os << " at " << *divergence.pc;
+  }
+  if (!divergence.instruction.empty()) {
+    os << " (" << divergence.instruction << ")";
+  }
+  os << ":" << std::endl;
+  for (const auto &difference : divergence.differences) {
+    os << "  " << difference << std::endl;
+  }
+  return os;
+}
+
+} // namespace irata::sim::interpreter
@@ -0,0 +1,530 @@
+#include <array>
+#include <iomanip>
+#include <irata/asm/instruction_set.hpp>
+#include <irata/common/strings/strings.hpp>
+#include <irata/sim/interpreter/interpreter.hpp>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace irata::sim::interpreter {
+
+namespace {
+
+// The operations that the interpreter knows how to execute. Each opcode in the
+// instruction set maps to one of these plus an addressing mode.
+enum class Operation {
+  Nop,
+  Hlt,
+  Crs,
+  Lda,
+  Ldx,
+  Ldy,
+  Sta,
+  Stx,
+  Sty,
+  Tax,
+  Txa,
+  Tay,
+  Tya,
+  Inx,
+  Dex,
+  Iny,
+  Dey,
+  Cmp,
+  Adc,
+  Sbc,
+  And,
+  Ora,
+  Eor,
+  Asl,
+  Lsr,
+  Rol,
+  Ror,
+  Jmp,
+  Jne,
+  Jeq,
+  Sec,
+  Clc,
+  Pha,
+  Pla,
+  Phx,
+  Plx,
+  Phy,
+  Ply,
+  Php,
+  Plp,
+  Jsr,
+  Rts,
+};
+
+Operation operation_for_name(const std::string &name) {
+  static const std::map<std::string, Operation> operations = {
+      {"NOP", Operation::Nop}, {"HLT", Operation::Hlt}, {"CRS", Operation::Crs},
+      {"LDA", Operation::Lda}, {"LDX", Operation::Ldx}, {"LDY", Operation::Ldy},
+      {"STA", Operation::Sta}, {"STX", Operation::Stx}, {"STY", Operation::Sty},
+      {"TAX", Operation::Tax}, {"TXA", Operation::Txa}, {"TAY", Operation::Tay},
+      {"TYA", Operation::Tya}, {"INX", Operation::Inx}, {"DEX", Operation::Dex},
+      {"INY", Operation::Iny}, {"DEY", Operation::Dey}, {"CMP", Operation::Cmp},
+      {"ADC", Operation::Adc}, {"SBC", Operation::Sbc}, {"AND", Operation::And},
+      {"ORA", Operation::Ora}, {"EOR", Operation::Eor}, {"ASL", Operation::Asl},
+      {"LSR", Operation::Lsr}, {"ROL", Operation::Rol}, {"ROR", Operation::Ror},
+      {"JMP", Operation::Jmp}, {"JNE", Operation::Jne}, {"JEQ", Operation::Jeq},
+      {"SEC", Operation::Sec}, {"CLC", Operation::Clc}, {"PHA", Operation::Pha},
+      {"PLA", Operation::Pla}, {"PHX", Operation::Phx}, {"PLX", Operation::Plx},
+      {"PHY", Operation::Phy}, {"PLY", Operation::Ply}, {"PHP", Operation::Php},
+      {"PLP", Operation::Plp}, {"JSR", Operation::Jsr}, {"RTS", Operation::Rts},
+  };
+  if (const auto it = operations.find(common::strings::to_upper(name));
+      it != operations.end()) {
+    return it->second;
+  }
+  throw std::logic_error("interpreter doesn't support instruction " + name);
+}
+
+struct DecodedInstruction {
+  Operation operation;
+  asm_::AddressingMode addressing_mode;
+};
+
+using DecodeTable = std::array<std::optional<DecodedInstruction>, 256>;
+
+DecodeTable build_decode_table() {
+  DecodeTable table;
+  for (const auto &instruction :
+       asm_::InstructionSet::irata().instructions()) {
+    table[instruction.opcode().unsigned_value()] = DecodedInstruction{
+        operation_for_name(instruction.name()),
+        instruction.addressing_mode(),
+    };
+  }
+  return table;
+}
+
+// Returns the decoded instruction for every opcode in the irata instruction
+// set, indexed by opcode.
+const DecodeTable &decode_table() {
+  static const DecodeTable table = build_decode_table();
+  return table;
+}
+
+// Computes the flags of an arithmetic or logical alu result, matching
+// components::alu::Module::Result::for_result.
+Interpreter::Flags flags_for_result(uint8_t lhs, uint8_t rhs,
+                                    unsigned int result) {
+  const uint8_t value = result & 0xFF;
+  return {
+      .carry = result > 0xFF,
+      .zero = value == 0,
+      .negative = (value & 0x80) != 0,
+      .overflow = ((~(lhs ^ rhs) & (lhs ^ value) & 0x80) != 0),
+  };
+}
+
+// Computes the flags of a shift or rotate alu result, matching the shift and
+// rotate alu modules.
+Interpreter::Flags flags_for_shift(bool carry, unsigned int result) {
+  return {
+      .carry = carry,
+      .zero = (result & 0xFF) == 0,
+  };
+}
+
+std::string hex(uint16_t value, int width) {
+  std::ostringstream os;
+  os << "0x" << std::uppercase << std::hex << std::setw(width)
+     << std::setfill('0') << value;
+  return os.str();
+}
+
+} // namespace
+
+bool Interpreter::Flags::operator==(const Flags &other) const {
+  return carry == other.carry && zero == other.zero &&
+         negative == other.negative && overflow == other.overflow;
+}
+
+bool Interpreter::Flags::operator!=(const Flags &other) const {
+  return !(*this == other);
+}
+
+Interpreter::Interpreter(const std::vector<uint8_t> &cartridge)
+    : memory_(0x10000, 0),
+      cartridge_end_(cartridge_address + uint32_t(cartridge.size())) {
+  if (cartridge_end_ > memory_.size()) {
+    throw std::invalid_argument("cartridge of size " +
+                                std::to_string(cartridge.size()) +
+                                " doesn't fit at address " +
+                                hex(cartridge_address, 4));
+  }
+  std::copy(cartridge.begin(), cartridge.end(),
+            memory_.begin() + cartridge_address);
+}
+
+Byte Interpreter::a() const { return a_; }
+void Interpreter::set_a(Byte value) { a_ = value; }
+
+Byte Interpreter::x() const { return x_; }
+void Interpreter::set_x(Byte value) { x_ = value; }
+
+Byte Interpreter::y() const { return y_; }
+void Interpreter::set_y(Byte value) { y_ = value; }
+
+Byte Interpreter::stack_pointer() const { return stack_pointer_; }
+void Interpreter::set_stack_pointer(Byte value) { stack_pointer_ = value; }
+
+Word Interpreter::pc() const { return pc_; }
+void Interpreter::set_pc(Word value) { pc_ = value; }
+
+Byte Interpreter::status_register() const { return status_register_; }
+
+const Interpreter::Flags &Interpreter::status() const { return status_; }
+
+const Interpreter::Flags &Interpreter::alu_flags() const { return alu_flags_; }
+
+Byte Interpreter::read(Word address) const { return read_byte(address); }
+
+void Interpreter::write(Word address, Byte value) {
+  write_byte(address, value);
+}
+
+const std::vector<uint8_t> &Interpreter::memory() const { return memory_; }
+
+uint64_t Interpreter::instruction_count() const { return instruction_count_; }
+
+std::optional<Interpreter::Result> Interpreter::result() const {
+  return result_;
+}
+
+uint8_t Interpreter::read_byte(uint16_t address) const {
+  if (address < ram_size ||
+      (address >= cartridge_address && address < cartridge_end_)) {
+    return memory_[address];
+  }
+  throw std::runtime_error("interpreter read from unmapped address " +
+                           hex(address, 4));
+}
+
+void Interpreter::write_byte(uint16_t address, uint8_t value) {
+  if (address >= ram_size) {
+    throw std::runtime_error("interpreter write to non-ram address " +
+                             hex(address, 4));
+  }
+  memory_[address] = value;
+}
+
+uint8_t Interpreter::fetch() { return read_byte(pc_++); }
+
+uint16_t Interpreter::fetch_word() {
+  const uint8_t high = fetch();
+  const uint8_t low = fetch();
+  return (high << 8) | low;
+}
+
+uint16_t Interpreter::operand_address(asm_::AddressingMode addressing_mode) {
+  switch (addressing_mode) {
+  case asm_::AddressingMode::Immediate:
+    return pc_++;
+  case asm_::AddressingMode::Absolute:
+    return fetch_word();
+  case asm_::AddressingMode::ZeroPage:
+    return fetch();
+  case asm_::AddressingMode::ZeroPageX:
+    return alu(hdl::AluOpcode::AddressAdd, fetch(), x_);
+  case asm_::AddressingMode::ZeroPageY:
+    return alu(hdl::AluOpcode::AddressAdd, fetch(), y_);
+  case asm_::AddressingMode::AbsoluteX:
+  case asm_::AddressingMode::AbsoluteY: {
+    const uint16_t base = fetch_word();
+    const uint8_t index =
+        addressing_mode == asm_::AddressingMode::AbsoluteX ? x_ : y_;
+    // The low byte goes through the alu and a carry increments the high byte,
+    // so this is a plain 16 bit add.
+    const uint8_t low = alu(hdl::AluOpcode::AddressAdd, base & 0xFF, index);
+    const uint8_t high = (base >> 8) + (((base & 0xFF) + index) > 0xFF);
+    return (high << 8) | low;
+  }
+  case asm_::AddressingMode::None:
+    break;
+  }
+  std::ostringstream os;
+  os << "addressing mode " << addressing_mode << " has no operand";
+  throw std::logic_error(os.str());
+}
+
+uint8_t Interpreter::alu(hdl::AluOpcode opcode, uint8_t lhs, uint8_t rhs) {
+  const bool carry_in = status_.carry;
+  unsigned int result = 0;
+  std::optional<Flags> flags;
+  switch (opcode) {
+  case hdl::AluOpcode::Add:
+    result = lhs + rhs + carry_in;
+    flags = flags_for_result(lhs, rhs, result);
+    break;
+  case hdl::AluOpcode::Subtract:
+    result = int(lhs) - int(rhs) - (1 - int(carry_in));
+    flags = flags_for_result(lhs, rhs, result);
+    break;
+  case hdl::AluOpcode::And:
+    result = lhs & rhs;
+    flags = flags_for_result(lhs, rhs, result);
+    break;
+  case hdl::AluOpcode::Or:
+    result = lhs | rhs;
+    flags = flags_for_result(lhs, rhs, result);
+    break;
+  case hdl::AluOpcode::Xor:
+    result = lhs ^ rhs;
+    flags = flags_for_result(lhs, rhs, result);
+    break;
+  case hdl::AluOpcode::ShiftLeft:
+    result = lhs << 1;
+    flags = flags_for_shift(lhs & 0x80, result);
+    break;
+  case hdl::AluOpcode::ShiftRight:
+    result = lhs >> 1;
+    flags = flags_for_shift(lhs & 0x01, result);
+    break;
+  case hdl::AluOpcode::RotateLeft:
+    result = (lhs << 1) | carry_in;
+    flags = flags_for_shift(lhs & 0x80, result);
+    break;
+  case hdl::AluOpcode::RotateRight:
+    result = (lhs >> 1) | (carry_in << 7);
+    flags = flags_for_shift(lhs & 0x01, result);
+    break;
+  case hdl::AluOpcode::AddressAdd:
+    // Address arithmetic doesn't update the alu flags.
+    result = lhs + rhs;
+    break;
+  case hdl::AluOpcode::Nop:
+    throw std::logic_error("alu nop has no result");
+  }
+  if (flags) {
+    alu_flags_ = *flags;
+  }
+  // Every alu operation latches the alu flags into the status register.
+  status_register_ = (alu_flags_.carry << 0) | (alu_flags_.zero << 1) |
+                     (alu_flags_.overflow << 6) | (alu_flags_.negative << 7);
+  status_ = alu_flags_;
+  return result & 0xFF;
+}
+
+void Interpreter::push(uint8_t value) {
+  write_byte(0x0100 | stack_pointer_, value);
+  --stack_pointer_;
+}
+
+uint8_t Interpreter::pop() {
+  ++stack_pointer_;
+  return read_byte(0x0100 | stack_pointer_);
+}
+
+void Interpreter::set_carry(bool value) {
+  status_.carry = value;
+  if (value) {
+    status_register_ |= 0x01;
+  } else {
+    status_register_ &= ~0x01;
+  }
+}
+
+std::optional<Interpreter::Result> Interpreter::step() {
+  if (result_) {
+    return result_;
+  }
+  const uint16_t instruction_address = pc_;
+  const uint8_t opcode = fetch();
+  const auto &instruction = decode_table()[opcode];
+  if (!instruction) {
+    pc_ = instruction_address;
+    throw std::runtime_error("unknown opcode " + hex(opcode, 2) +
+                             " at address " + hex(instruction_address, 4));
+  }
+  ++instruction_count_;
+  const auto mode = instruction->addressing_mode;
+  switch (instruction->operation) {
+  case Operation::Nop:
+    break;
+  case Operation::Hlt:
+    result_ = Result::Halt;
+    break;
+  case Operation::Crs:
+    result_ = Result::Crash;
+    break;
+  case Operation::Lda:
+    a_ = read_byte(operand_address(mode));
+    break;
+  case Operation::Ldx:
+    x_ = read_byte(operand_address(mode));
+    break;
+  case Operation::Ldy:
+    y_ = read_byte(operand_address(mode));
+    break;
+  case Operation::Sta:
+    write_byte(operand_address(mode), a_);
+    break;
+  case Operation::Stx:
+    write_byte(operand_address(mode), x_);
+    break;
+  case Operation::Sty:
+    write_byte(operand_address(mode), y_);
+    break;
+  case Operation::Tax:
+    x_ = a_;
+    break;
+  case Operation::Txa:
+    a_ = x_;
+    break;
+  case Operation::Tay:
+    y_ = a_;
+    break;
+  case Operation::Tya:
+    a_ = y_;
+    break;
+  case Operation::Inx:
+    ++x_;
+    break;
+  case Operation::Dex:
+    --x_;
+    break;
+  case Operation::Iny:
+    ++y_;
+    break;
+  case Operation::Dey:
+    --y_;
+    break;
+  case Operation::Cmp: {
+    // cmp subtracts a from the operand with the carry set, discarding the
+    // result.
+    const uint8_t value = read_byte(operand_address(mode));
+    set_carry(true);
+    alu(hdl::AluOpcode::Subtract, value, a_);
+    break;
+  }
+  case Operation::Adc:
+    a_ = alu(hdl::AluOpcode::Add, a_, read_byte(operand_address(mode)));
+    break;
+  case Operation::Sbc:
+    a_ = alu(hdl::AluOpcode::Subtract, a_, read_byte(operand_address(mode)));
+    break;
+  case Operation::And:
+    a_ = alu(hdl::AluOpcode::And, a_, read_byte(operand_address(mode)));
+    break;
+  case Operation::Ora:
+    a_ = alu(hdl::AluOpcode::Or, a_, read_byte(operand_address(mode)));
+    break;
+  case Operation::Eor:
+    a_ = alu(hdl::AluOpcode::Xor, a_, read_byte(operand_address(mode)));
+    break;
+  case Operation::Asl:
+    a_ = alu(hdl::AluOpcode::ShiftLeft, a_, 0);
+    break;
+  case Operation::Lsr:
+    a_ = alu(hdl::AluOpcode::ShiftRight, a_, 0);
+    break;
+  case Operation::Rol:
+    a_ = alu(hdl::AluOpcode::RotateLeft, a_, 0);
+    break;
+  case Operation::Ror:
+    a_ = alu(hdl::AluOpcode::RotateRight, a_, 0);
+    break;
+  case Operation::Jmp:
+    pc_ = fetch_word();
+    break;
+  case Operation::Jne:
+    if (!status_.zero) {
+      pc_ = fetch_word();
+    } else {
+      pc_ += 2;
+    }
+    break;
+  case Operation::Jeq:
+    if (status_.zero) {
+      pc_ = fetch_word();
+    } else {
+      pc_ += 2;
+    }
+    break;
+  case Operation::Sec:
+    set_carry(true);
+    break;
+  case Operation::Clc:
+    set_carry(false);
+    break;
+  case Operation::Pha:
+    push(a_);
+    break;
+  case Operation::Pla:
+    a_ = pop();
+    break;
+  case Operation::Phx:
+    push(x_);
+    break;
+  case Operation::Plx:
+    x_ = pop();
+    break;
+  case Operation::Phy:
+    push(y_);
+    break;
+  case Operation::Ply:
+    y_ = pop();
+    break;
+  case Operation::Php:
+    push(status_register_);
+    break;
+  case Operation::Plp:
+    // Like the status register component, this only loads the register value
+    // and leaves the status lines alone until the next latch.
+    status_register_ = pop();
+    break;
+  case Operation::Jsr: {
+    const uint16_t target = fetch_word();
+    push(pc_ >> 8);
+    push(pc_ & 0xFF);
+    pc_ = target;
+    break;
+  }
+  case Operation::Rts: {
+    const uint8_t low = pop();
+    const uint8_t high = pop();
+    pc_ = (high << 8) | low;
+    break;
+  }
+  }
+  return result_;
+}
+
+Interpreter::Result Interpreter::run(int max_instructions) {
+  int instructions = 0;
+  while (!result_) {
+    if (max_instructions >= 0 && instructions++ >= max_instructions) {
+      throw std::runtime_error("max instructions reached");
+    }
+    step();
+  }
+  return *result_;
+}
+
+void Interpreter::serialize(std::ostream &os) const {
+  os << "a: " << a() << std::endl
+     << "x: " << x() << std::endl
+     << "y: " << y() << std::endl
+     << "stack_pointer: " << stack_pointer() << std::endl
+     << "pc: " << pc() << std::endl
+     << "status_register: " << status_register() << std::endl
+     << "instruction_count: " << std::dec << instruction_count() << std::endl;
+}
+
+std::ostream &operator<<(std::ostream &os, Interpreter::Result result) {
+  switch (result) {
+  case Interpreter::Result::Halt:
+    return os << "Halt";
+  case Interpreter::Result::Crash:
+    return os << "Crash";
+  }
+  return os << "Unknown";
+}
+
+} // namespace irata::sim::interpreter
@@ -1,21 +1,274 @@
+#include <algorithm>
+#include <exception>
+#include <irata/common/serialization/serialization.hpp>
 #include <irata/sim/microcode/compiler/compiler.hpp>
 #include <irata/sim/microcode/compiler/passes/bus_validator.hpp>
+#include <irata/sim/microcode/compiler/passes/fetch_overlap_transformer.hpp>
+#include <irata/sim/microcode/compiler/passes/fetch_overlap_validator.hpp>
 #include <irata/sim/microcode/compiler/passes/fetch_stage_validator.hpp>
 #include <irata/sim/microcode/compiler/passes/instruction_coverage_validator.hpp>
+#include <irata/sim/microcode/compiler/passes/list_scheduler.hpp>
 #include <irata/sim/microcode/compiler/passes/status_completeness_validator.hpp>
 #include <irata/sim/microcode/compiler/passes/step_index_transformer.hpp>
 #include <irata/sim/microcode/compiler/passes/step_index_validator.hpp>
 #include <irata/sim/microcode/compiler/passes/step_merger.hpp>
+#include <irata/sim/microcode/dsl/instruction.hpp>
+#include <irata/sim/microcode/table/image.hpp>
+#include <optional>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <typeinfo>
 
 namespace irata::sim::microcode::compiler {
 
 namespace {
 
-ir::InstructionSet convert_input(const dsl::InstructionSet &instruction_set) {
-  return ir::InstructionSet(instruction_set);
+// Returns true if the registry holds all of the given controls.
+bool is_superset(const ir::ControlRegistry &registry,
+                 const std::set<const hdl::ControlDecl *> &controls) {
+  return std::all_of(controls.begin(), controls.end(),
+                     [&registry](const hdl::ControlDecl *control) {
+                       return registry.id(*control).has_value();
+                     });
 }
 
+ir::Instruction rebind(const ir::Instruction &instruction,
+                       const ir::ControlRegistry &registry) {
+  std::vector<ir::Step> steps;
+  for (const auto &step : instruction.steps()) {
+    steps.emplace_back(ir::ControlSet(registry, step.controls()),
+                       ir::ControlSet(registry, step.write_controls()),
+                       ir::ControlSet(registry, step.read_controls()),
+                       step.stage());
+  }
+  return ir::Instruction(instruction.descriptor(), std::move(steps),
+                         instruction.statuses());
+}
+
+// Returns the results compiled with one registry moved to another, or no
+// results if the other registry doesn't hold all of the first's controls.
+std::map<ir::Instruction, ir::Instruction>
+rebind(std::map<ir::Instruction, ir::Instruction> results,
+       const ir::ControlRegistry *from, const ir::ControlRegistry &to) {
+  if (from == nullptr) {
+    return {};
+  }
+  std::set<const hdl::ControlDecl *> from_controls;
+  for (size_t id = 0; id < from->size(); ++id) {
+    from_controls.insert(&from->control(id));
+  }
+  if (!is_superset(to, from_controls)) {
+    return {};
+  }
+  std::map<ir::Instruction, ir::Instruction> rebound;
+  for (const auto &[input, output] : results) {
+    rebound.emplace(rebind(input, to), rebind(output, to));
+  }
+  return rebound;
+}
+
+using common::serialization::Hasher;
+using common::serialization::read_u16;
+using common::serialization::read_u32;
+using common::serialization::read_u64;
+using common::serialization::read_u8;
+using common::serialization::write_u16;
+using common::serialization::write_u32;
+using common::serialization::write_u64;
+using common::serialization::write_u8;
+
+// Identifies a compiled instruction cache.
+constexpr char cache_magic[8] = {'I', 'R', 'A', 'T', 'A', 'C', 'C', '\0'};
+
+// Bumped whenever the layout of the cache changes.
+constexpr uint32_t cache_version = 1;
+
+// Flags stored with each control of a cached step.
+constexpr uint8_t write_control_flag = 1;
+constexpr uint8_t read_control_flag = 2;
+
+void write_string(std::ostream &os, const std::string &s) {
+  write_u16(os, s.size());
+  os.write(s.data(), s.size());
+}
+
+std::string read_string(std::istream &is) {
+  std::string s(read_u16(is), '\0');
+  if (!is.read(s.data(), s.size())) {
+    throw std::runtime_error("compiled instruction cache is truncated");
+  }
+  return s;
+}
+
+// Returns a hash of the types of the given passes, in order, so that a cache
+// is only loaded by a compiler with the same passes.
+uint64_t passes_hash(const std::vector<std::unique_ptr<passes::Pass>> &passes) {
+  Hasher hasher;
+  for (const auto &pass : passes) {
+    hasher.add(typeid(*pass).name());
+  }
+  return hasher.value();
+}
+
+// Writes cached instructions with controls and statuses stored by their index
+// in a table of paths, which is written first.
+class CacheWriter {
+public:
+  void add(const ir::Instruction &instruction) {
+    for (const auto &[status, _] : instruction.statuses()) {
+      path_index(status->path());
+    }
+    for (const auto &step : instruction.steps()) {
+      for (const auto *control : step.controls()) {
+        path_index(control->path());
+      }
+    }
+  }
+
+  void write_paths(std::ostream &os) const {
+    write_u16(os, paths_.size());
+    for (const auto &path : paths_) {
+      write_string(os, path);
+    }
+  }
+
+  void write(std::ostream &os, const ir::Instruction &instruction) const {
+    write_u8(os, instruction.descriptor().opcode().unsigned_value());
+    write_u8(os, instruction.statuses().size());
+    for (const auto &[status, value] : instruction.statuses()) {
+      write_u16(os, path_indices_.at(status->path()));
+      write_u8(os, value);
+    }
+    write_u16(os, instruction.steps().size());
+    for (const auto &step : instruction.steps()) {
+      write_u32(os, static_cast<uint32_t>(step.stage()));
+      write_u16(os, step.controls().size());
+      for (const auto *control : step.controls()) {
+        uint8_t flags = 0;
+        if (step.write_controls().count(control)) {
+          flags |= write_control_flag;
+        }
+        if (step.read_controls().count(control)) {
+          flags |= read_control_flag;
+        }
+        write_u16(os, path_indices_.at(control->path()));
+        write_u8(os, flags);
+      }
+    }
+  }
+
+private:
+  std::map<std::string, uint16_t> path_indices_;
+  std::vector<std::string> paths_;
+
+  void path_index(const std::string &path) {
+    if (path_indices_.emplace(path, paths_.size()).second) {
+      paths_.push_back(path);
+    }
+  }
+};
+
+// Reads cached instructions, resolving their opcodes, statuses and controls
+// against an instruction set and the registry it's compiled with.
+class CacheReader {
+public:
+  CacheReader(std::istream &is, const dsl::InstructionSet &instruction_set,
+              const ir::ControlRegistry &registry)
+      : is_(is), registry_(registry) {
+    for (const auto &instruction : instruction_set.instructions()) {
+      descriptors_.emplace(
+          instruction->descriptor().opcode().unsigned_value(),
+          &instruction->descriptor());
+      for (const auto &[status, _] : instruction->statuses()) {
+        statuses_.emplace(status->path(), status);
+      }
+    }
+    for (size_t id = 0; id < registry.size(); ++id) {
+      controls_.emplace(registry.control(id).path(), &registry.control(id));
+    }
+  }
+
+  void read_paths() {
+    paths_.resize(read_u16(is_));
+    for (auto &path : paths_) {
+      path = read_string(is_);
+    }
+  }
+
+  // Reads an instruction, or returns nullopt if it names an opcode, status or
+  // control that the instruction set and registry don't have.
+  std::optional<ir::Instruction> read() {
+    bool resolved = true;
+    const auto descriptor = descriptors_.find(read_u8(is_));
+    resolved &= descriptor != descriptors_.end();
+    std::map<const hdl::StatusDecl *, bool> statuses;
+    for (uint8_t num_statuses = read_u8(is_); num_statuses > 0;
+         --num_statuses) {
+      const auto status = statuses_.find(path(read_u16(is_)));
+      const bool value = read_u8(is_);
+      if (status == statuses_.end()) {
+        resolved = false;
+      } else {
+        statuses.emplace(status->second, value);
+      }
+    }
+    std::vector<ir::Step> steps;
+    for (uint16_t num_steps = read_u16(is_); num_steps > 0; --num_steps) {
+      const int stage = static_cast<int32_t>(read_u32(is_));
+      ir::ControlSet controls(registry_), write_controls(registry_),
+          read_controls(registry_);
+      for (uint16_t num_controls = read_u16(is_); num_controls > 0;
+           --num_controls) {
+        const auto control = controls_.find(path(read_u16(is_)));
+        const uint8_t flags = read_u8(is_);
+        if (control == controls_.end()) {
+          resolved = false;
+          continue;
+        }
+        controls.insert(control->second);
+        if (flags & write_control_flag) {
+          write_controls.insert(control->second);
+        }
+        if (flags & read_control_flag) {
+          read_controls.insert(control->second);
+        }
+      }
+      if (resolved) {
+        try {
+          steps.emplace_back(controls, write_controls, read_controls, stage);
+        } catch (const std::invalid_argument &e) {
+          throw std::runtime_error(
+              std::string("compiled instruction cache has a bad step: ") +
+              e.what());
+        }
+      }
+    }
+    if (!resolved) {
+      return std::nullopt;
+    }
+    return ir::Instruction(*descriptor->second, std::move(steps),
+                           std::move(statuses));
+  }
+
+private:
+  std::istream &is_;
+  const ir::ControlRegistry &registry_;
+  std::map<uint8_t, const asm_::Instruction *> descriptors_;
+  std::map<std::string, const hdl::StatusDecl *> statuses_;
+  std::map<std::string, const hdl::ControlDecl *> controls_;
+  std::vector<std::string> paths_;
+
+  const std::string &path(uint16_t index) const {
+    if (index >= paths_.size()) {
+      throw std::runtime_error(
+          "compiled instruction cache has a bad path index");
+    }
+    return paths_[index];
+  }
+};
+
 table::Table convert_output(const ir::InstructionSet &instruction_set) {
   std::vector<table::Entry> entries;
   std::set<Byte> opcodes;
@@ -27,7 +280,8 @@ table::Table convert_output(const ir::InstructionSet &instruction_set) {
           .instruction = instruction.descriptor(),
           .step_index = Byte(step_index),
           .statuses = instruction.statuses(),
-          .controls = step.controls(),
+          .controls = std::set<const hdl::ControlDecl *>(
+              step.controls().begin(), step.controls().end()),
       });
       opcodes.insert(instruction.descriptor().opcode());
     }
@@ -37,13 +291,183 @@ table::Table convert_output(const ir::InstructionSet &instruction_set) {
 
 } // namespace
 
-Compiler::Compiler(std::vector<std::unique_ptr<passes::Pass>> passes)
-    : passes_(std::move(passes)) {
+Compiler::Compiler(std::vector<std::unique_ptr<passes::Pass>> passes,
+                   size_t num_threads)
+    : passes_(std::move(passes)),
+      pool_(num_threads > 0
+                ? num_threads
+                : std::max(1u, std::thread::hardware_concurrency())) {
   for (const auto &pass : passes_) {
     if (pass == nullptr) {
       throw std::invalid_argument("Passes must not be null");
     }
+    const auto added_controls = pass->added_controls();
+    added_controls_.insert(added_controls.begin(), added_controls.end());
+    if (const auto *instruction_pass =
+            dynamic_cast<const passes::InstructionPass *>(pass.get())) {
+      if (segments_.empty() || segments_.back().pass != nullptr) {
+        segments_.emplace_back();
+      }
+      segments_.back().instruction_passes.push_back(instruction_pass);
+    } else {
+      segments_.emplace_back().pass = pass.get();
+    }
+  }
+}
+
+size_t Compiler::num_threads() const { return pool_.num_threads(); }
+
+std::shared_ptr<const ir::ControlRegistry>
+Compiler::registry(const dsl::InstructionSet &instruction_set) const {
+  std::set<const hdl::ControlDecl *> controls = instruction_set.controls();
+  controls.insert(added_controls_.begin(), added_controls_.end());
+  std::lock_guard lock(mutex_);
+  if (registry_ != nullptr) {
+    if (is_superset(*registry_, controls)) {
+      return registry_;
+    }
+    std::set<const hdl::ControlDecl *> grown = controls;
+    for (size_t id = 0; id < registry_->size(); ++id) {
+      grown.insert(&registry_->control(id));
+    }
+    if (grown.size() <= ir::ControlSet::max_controls) {
+      controls = std::move(grown);
+    }
   }
+  registry_ = std::make_shared<const ir::ControlRegistry>(controls);
+  return registry_;
+}
+
+ir::InstructionSet Compiler::run_segment(
+    Segment &segment, const ir::InstructionSet &instruction_set,
+    const std::shared_ptr<const ir::ControlRegistry> &registry) const {
+  std::set<ir::Instruction> instructions;
+  std::vector<const ir::Instruction *> misses;
+  // The results for this instruction set, which replace the segment's results
+  // once it's done.
+  std::map<ir::Instruction, ir::Instruction> results;
+  {
+    std::lock_guard lock(mutex_);
+    if (segment.registry != registry) {
+      segment.results =
+          rebind(std::move(segment.results), segment.registry.get(), *registry);
+    }
+    for (const auto &instruction : instruction_set.instructions()) {
+      if (const auto it = segment.results.find(instruction);
+          it != segment.results.end()) {
+        auto result = segment.results.extract(it);
+        instructions.insert(result.mapped());
+        results.insert(std::move(result));
+      } else {
+        misses.push_back(&instruction);
+      }
+    }
+  }
+
+  // Each job writes only the slots of its own instruction, so the outputs and
+  // errors need no lock.
+  std::vector<std::optional<ir::Instruction>> outputs(misses.size());
+  std::vector<std::exception_ptr> errors(misses.size());
+  pool_.run(misses.size(), [&](size_t i) {
+    try {
+      std::optional<ir::Instruction> instruction = *misses[i];
+      for (const auto *pass : segment.instruction_passes) {
+        instruction.emplace(pass->run_instruction(*instruction));
+      }
+      outputs[i] = std::move(instruction);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  });
+  // Report the same error that running the instructions in order would.
+  std::exception_ptr error;
+  for (const auto &instruction_error : errors) {
+    if (instruction_error != nullptr) {
+      error = instruction_error;
+      break;
+    }
+  }
+
+  std::lock_guard lock(mutex_);
+  if (error == nullptr) {
+    for (size_t i = 0; i < misses.size(); ++i) {
+      results.emplace(*misses[i], *outputs[i]);
+      instructions.insert(std::move(*outputs[i]));
+    }
+  }
+  // Only keep the results for the last instruction set, so that compiling
+  // many different instruction sets doesn't grow the cache without bound.
+  segment.results = std::move(results);
+  segment.registry = registry;
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+  return ir::InstructionSet(std::move(instructions), registry);
+}
+
+void Compiler::save_cache(std::ostream &os) const {
+  std::lock_guard lock(mutex_);
+  CacheWriter writer;
+  for (const auto &segment : segments_) {
+    for (const auto &[input, output] : segment.results) {
+      writer.add(input);
+      writer.add(output);
+    }
+  }
+  os.write(cache_magic, sizeof(cache_magic));
+  write_u32(os, cache_version);
+  write_u64(os, pass_fingerprint());
+  write_u64(os, passes_hash(passes_));
+  writer.write_paths(os);
+  write_u16(os, segments_.size());
+  for (const auto &segment : segments_) {
+    write_u32(os, segment.results.size());
+    for (const auto &[input, output] : segment.results) {
+      writer.write(os, input);
+      writer.write(os, output);
+    }
+  }
+  if (!os) {
+    throw std::runtime_error("failed to write compiled instruction cache");
+  }
+}
+
+bool Compiler::load_cache(std::istream &is,
+                          const dsl::InstructionSet &instruction_set) const {
+  char magic[sizeof(cache_magic)];
+  if (!is.read(magic, sizeof(magic)) ||
+      !std::equal(std::begin(cache_magic), std::end(cache_magic), magic)) {
+    throw std::runtime_error("not a compiled instruction cache");
+  }
+  if (read_u32(is) != cache_version || read_u64(is) != pass_fingerprint() ||
+      read_u64(is) != passes_hash(passes_)) {
+    return false;
+  }
+  const auto registry = this->registry(instruction_set);
+  CacheReader reader(is, instruction_set, *registry);
+  reader.read_paths();
+  if (read_u16(is) != segments_.size()) {
+    throw std::runtime_error(
+        "compiled instruction cache has the wrong number of segments");
+  }
+  std::vector<std::map<ir::Instruction, ir::Instruction>> results(
+      segments_.size());
+  for (auto &segment_results : results) {
+    for (uint32_t num_results = read_u32(is); num_results > 0;
+         --num_results) {
+      auto input = reader.read();
+      auto output = reader.read();
+      if (input && output) {
+        segment_results.emplace(std::move(*input), std::move(*output));
+      }
+    }
+  }
+  std::lock_guard lock(mutex_);
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    segments_[i].results = std::move(results[i]);
+    segments_[i].registry = registry;
+  }
+  return true;
 }
 
 table::Table
@@ -51,7 +475,8 @@ Compiler::compile(const dsl::InstructionSet &instruction_set) const {
   return convert_output(compile_to_ir(instruction_set));
 }
 
-const Compiler &Compiler::irata() {
+std::vector<std::unique_ptr<passes::Pass>>
+Compiler::irata_passes(bool list_schedule, bool overlap_fetch) {
   std::vector<std::unique_ptr<passes::Pass>> passes;
 
   // Phase 1: validators for raw microcode.
@@ -61,6 +486,20 @@ const Compiler &Compiler::irata() {
   passes.push_back(passes::InstructionCoverageValidator::irata());
 
   // Phase 2: transformers
+  // Move the start of the fetch stage to the end of the previous instruction,
+  // for the scheduler to overlap with its last steps.
+  if (overlap_fetch) {
+    passes.push_back(std::make_unique<passes::FetchOverlapTransformer>());
+  }
+  // Pack independent steps into the same tick. This runs before step index
+  // controls are added, since they would make every step depend on every
+  // other.
+  if (list_schedule) {
+    passes.push_back(passes::ListScheduler::irata());
+  }
+  if (overlap_fetch) {
+    passes.push_back(std::make_unique<passes::FetchOverlapValidator>());
+  }
   // First step index pass: add step index controls.
   passes.push_back(std::make_unique<passes::StepIndexTransformer>());
   // Immediately validate the step index transformer's output.
@@ -78,16 +517,28 @@ const Compiler &Compiler::irata() {
   passes.push_back(std::make_unique<passes::BusValidator>());
   passes.push_back(std::make_unique<passes::StatusCompletenessValidator>());
   passes.push_back(passes::InstructionCoverageValidator::irata());
+  if (overlap_fetch) {
+    passes.push_back(std::make_unique<passes::FetchOverlapValidator>());
+  }
 
-  static const Compiler compiler(std::move(passes));
+  return passes;
+}
+
+const Compiler &Compiler::irata() {
+  static const Compiler compiler(irata_passes());
   return compiler;
 }
 
 ir::InstructionSet
 Compiler::compile_to_ir(const dsl::InstructionSet &instruction_set) const {
-  ir::InstructionSet ir = convert_input(instruction_set);
-  for (const auto &pass : passes_) {
-    ir = pass->run(ir);
+  const auto registry = this->registry(instruction_set);
+  ir::InstructionSet ir(registry, instruction_set);
+  for (auto &segment : segments_) {
+    if (segment.pass != nullptr) {
+      ir = segment.pass->run(ir);
+    } else {
+      ir = run_segment(segment, ir, registry);
+    }
   }
   return ir;
 }
@@ -96,4 +547,53 @@ table::Table Compiler::compile_irata() {
   return irata().compile(dsl::InstructionSet::irata());
 }
 
+namespace {
+
+// Returns the irata table loaded from the microcode image embedded in the
+// binary, or nullopt if there's no image or it doesn't match the compiler.
+// The image is built from the same sources as the compiler, so an image that
+// can't be used is a build problem, which irata_table_loaded_from_image()
+// reports.
+std::optional<table::Table> load_irata_image() {
+  const auto image = Compiler::irata_image();
+  if (image.empty()) {
+    return std::nullopt;
+  }
+  std::istringstream is(std::string(image), std::ios::binary);
+  const auto &instruction_set = dsl::InstructionSet::irata();
+  try {
+    return table::read_image(
+        is, instruction_set,
+        table::image_hash(instruction_set, Compiler::fingerprint()));
+  } catch (const std::runtime_error &) {
+    return std::nullopt;
+  }
+}
+
+// The irata table, and whether it was loaded from the microcode image.
+struct IrataTable {
+  table::Table table;
+  bool loaded_from_image;
+};
+
+const IrataTable &irata_table() {
+  static const IrataTable table = [] {
+    if (auto table = load_irata_image()) {
+      return IrataTable{std::move(*table), true};
+    }
+    return IrataTable{Compiler::compile_irata(), false};
+  }();
+  return table;
+}
+
+} // namespace
+
+const table::Table &Compiler::irata_table() {
+  return compiler::irata_table().table;
+}
+
+bool Compiler::irata_table_loaded_from_image() {
+  return compiler::irata_table().loaded_from_image;
+}
+
 } // namespace irata::sim::microcode::compiler
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <irata/sim/microcode/compiler/ir/control_registry.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace irata::sim::microcode::compiler::ir {
+
+namespace {
+
+std::vector<const hdl::ControlDecl *>
+sort_by_path(const std::set<const hdl::ControlDecl *> &controls) {
+  std::vector<std::pair<std::string, const hdl::ControlDecl *>> paths;
+  for (const auto *control : controls) {
+    if (control == nullptr) {
+      throw std::invalid_argument("Control cannot be null");
+    }
+    paths.emplace_back(control->path(), control);
+  }
+  std::sort(paths.begin(), paths.end());
+  std::vector<const hdl::ControlDecl *> result;
+  for (const auto &[_, control] : paths) {
+    result.push_back(control);
+  }
+  return result;
+}
+
+} // namespace
+
+ControlRegistry::ControlRegistry(
+    const std::set<const hdl::ControlDecl *> &controls)
+    : controls_(sort_by_path(controls)), write_controls_(*this),
+      read_controls_(*this) {
+  if (controls_.size() > ControlSet::max_controls) {
+    std::ostringstream os;
+    os << "Too many controls to register: " << controls_.size() << " > "
+       << ControlSet::max_controls;
+    throw std::invalid_argument(os.str());
+  }
+  for (const auto phase :
+       {hdl::TickPhase::Control, hdl::TickPhase::Write, hdl::TickPhase::Read,
+        hdl::TickPhase::Process, hdl::TickPhase::Clear}) {
+    phase_controls_.emplace(phase, ControlSet(*this));
+  }
+  for (size_t id = 0; id < controls_.size(); ++id) {
+    const auto *control = controls_[id];
+    ids_[control] = id;
+    phase_controls_.at(control->phase()).set(id);
+    if (const auto *write_control =
+            dynamic_cast<const hdl::WriteControlDecl *>(control)) {
+      write_controls_.set(id);
+      bus_controls_.try_emplace(&write_control->bus(), *this)
+          .first->second.set(id);
+    } else if (const auto *read_control =
+                   dynamic_cast<const hdl::ReadControlDecl *>(control)) {
+      read_controls_.set(id);
+      bus_controls_.try_emplace(&read_control->bus(), *this)
+          .first->second.set(id);
+    }
+  }
+}
+
+std::optional<size_t>
+ControlRegistry::id(const hdl::ControlDecl &control) const {
+  if (const auto it = ids_.find(&control); it != ids_.end()) {
+    return it->second;
+  }
+  return std::nullopt;
+}
+
+const hdl::ControlDecl &ControlRegistry::control(size_t id) const {
+  return *controls_.at(id);
+}
+
+size_t ControlRegistry::size() const { return controls_.size(); }
+
+const ControlSet &ControlRegistry::phase_controls(hdl::TickPhase phase) const {
+  return phase_controls_.at(phase);
+}
+
+const ControlSet &ControlRegistry::write_controls() const {
+  return write_controls_;
+}
+
+const ControlSet &ControlRegistry::read_controls() const {
+  return read_controls_;
+}
+
+const std::map<const hdl::BusDecl *, ControlSet> &
+ControlRegistry::bus_controls() const {
+  return bus_controls_;
+}
+
+} // namespace irata::sim::microcode::compiler::ir
@@ -0,0 +1,218 @@
+#include <irata/sim/microcode/compiler/ir/control_set.hpp>
+
+#include <algorithm>
+#include <irata/sim/microcode/compiler/ir/control_registry.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace irata::sim::microcode::compiler::ir {
+
+ControlSet::const_iterator::const_iterator(const ControlSet &set, size_t id)
+    : set_(&set), id_(id) {}
+
+ControlSet::const_iterator::value_type
+ControlSet::const_iterator::operator*() const {
+  return &set_->registry_->control(id_);
+}
+
+ControlSet::const_iterator &ControlSet::const_iterator::operator++() {
+  id_ = set_->next(id_ + 1);
+  return *this;
+}
+
+ControlSet::const_iterator ControlSet::const_iterator::operator++(int) {
+  const_iterator result = *this;
+  ++*this;
+  return result;
+}
+
+bool ControlSet::const_iterator::operator==(const const_iterator &other) const {
+  return set_ == other.set_ && id_ == other.id_;
+}
+
+bool ControlSet::const_iterator::operator!=(const const_iterator &other) const {
+  return !(*this == other);
+}
+
+ControlSet::ControlSet(const ControlRegistry &registry)
+    : registry_(&registry) {}
+
+ControlSet::ControlSet(const ControlRegistry &registry,
+                       std::initializer_list<const hdl::ControlDecl *> controls)
+    : ControlSet(registry) {
+  for (const auto *control : controls) {
+    insert(control);
+  }
+}
+
+const ControlRegistry &ControlSet::registry() const { return *registry_; }
+
+void ControlSet::insert(const hdl::ControlDecl *control) {
+  if (control == nullptr) {
+    throw std::invalid_argument("Control cannot be null");
+  }
+  const auto id = registry_->id(*control);
+  if (!id) {
+    std::ostringstream os;
+    os << "Control " << control->path() << " is not registered";
+    throw std::invalid_argument(os.str());
+  }
+  set(*id);
+}
+
+void ControlSet::erase(const hdl::ControlDecl *control) {
+  if (control == nullptr) {
+    return;
+  }
+  if (const auto id = registry_->id(*control); id) {
+    words_[*id / bits_per_word] &= ~(uint64_t(1) << (*id % bits_per_word));
+  }
+}
+
+size_t ControlSet::count(const hdl::ControlDecl *control) const {
+  if (control == nullptr) {
+    return 0;
+  }
+  const auto id = registry_->id(*control);
+  return id && test(*id) ? 1 : 0;
+}
+
+size_t ControlSet::size() const {
+  size_t size = 0;
+  for (const auto word : words_) {
+    size += __builtin_popcountll(word);
+  }
+  return size;
+}
+
+bool ControlSet::empty() const {
+  for (const auto word : words_) {
+    if (word != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+ControlSet::const_iterator ControlSet::begin() const {
+  return const_iterator(*this, next(0));
+}
+
+ControlSet::const_iterator ControlSet::end() const {
+  return const_iterator(*this, max_controls);
+}
+
+ControlSet &ControlSet::operator|=(const ControlSet &other) {
+  check_registry(other);
+  for (size_t i = 0; i < num_words; ++i) {
+    words_[i] |= other.words_[i];
+  }
+  return *this;
+}
+
+ControlSet &ControlSet::operator&=(const ControlSet &other) {
+  check_registry(other);
+  for (size_t i = 0; i < num_words; ++i) {
+    words_[i] &= other.words_[i];
+  }
+  return *this;
+}
+
+ControlSet &ControlSet::operator-=(const ControlSet &other) {
+  check_registry(other);
+  for (size_t i = 0; i < num_words; ++i) {
+    words_[i] &= ~other.words_[i];
+  }
+  return *this;
+}
+
+ControlSet ControlSet::operator|(const ControlSet &other) const {
+  ControlSet result = *this;
+  return result |= other;
+}
+
+ControlSet ControlSet::operator&(const ControlSet &other) const {
+  ControlSet result = *this;
+  return result &= other;
+}
+
+ControlSet ControlSet::operator-(const ControlSet &other) const {
+  ControlSet result = *this;
+  return result -= other;
+}
+
+bool ControlSet::operator==(const ControlSet &other) const {
+  if (registry_ == other.registry_) {
+    return words_ == other.words_;
+  }
+  return size() == other.size() && std::equal(begin(), end(), other.begin());
+}
+
+bool ControlSet::operator!=(const ControlSet &other) const {
+  return !(*this == other);
+}
+
+bool ControlSet::operator<(const ControlSet &other) const {
+  if (registry_ == other.registry_) {
+    // Ids are in path order, so the last differing control is the highest
+    // differing bit.
+    for (size_t word = num_words; word-- > 0;) {
+      if (words_[word] != other.words_[word]) {
+        return words_[word] < other.words_[word];
+      }
+    }
+    return false;
+  }
+  const auto path_less = [](const hdl::ControlDecl *lhs,
+                            const hdl::ControlDecl *rhs) {
+    return std::make_pair(lhs->path(), lhs) < std::make_pair(rhs->path(), rhs);
+  };
+  bool less = false;
+  auto lhs = begin();
+  auto rhs = other.begin();
+  while (lhs != end() || rhs != other.end()) {
+    if (rhs == other.end() || (lhs != end() && path_less(*lhs, *rhs))) {
+      less = false;
+      ++lhs;
+    } else if (lhs == end() || path_less(*rhs, *lhs)) {
+      less = true;
+      ++rhs;
+    } else {
+      ++lhs;
+      ++rhs;
+    }
+  }
+  return less;
+}
+
+bool ControlSet::test(size_t id) const {
+  return (words_[id / bits_per_word] >> (id % bits_per_word)) & 1;
+}
+
+void ControlSet::set(size_t id) {
+  words_[id / bits_per_word] |= uint64_t(1) << (id % bits_per_word);
+}
+
+size_t ControlSet::next(size_t id) const {
+  for (size_t word = id / bits_per_word; word < num_words; ++word) {
+    uint64_t bits = words_[word];
+    if (word == id / bits_per_word) {
+      // Drop the bits below id in its own word.
+      bits &= ~uint64_t(0) << (id % bits_per_word);
+    }
+    if (bits != 0) {
+      return word * bits_per_word + __builtin_ctzll(bits);
+    }
+  }
+  return max_controls;
+}
+
+void ControlSet::check_registry(const ControlSet &other) const {
+  if (registry_ != other.registry_) {
+    throw std::invalid_argument(
+        "Can't combine control sets of different registries");
+  }
+}
+
+} // namespace irata::sim::microcode::compiler::ir
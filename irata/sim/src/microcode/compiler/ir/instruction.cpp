@@ -1,5 +1,8 @@
+#include <irata/sim/microcode/compiler/ir/control_registry.hpp>
 #include <irata/sim/microcode/compiler/ir/instruction.hpp>
 #include <irata/sim/microcode/dsl/instruction.hpp>
+#include <sstream>
+#include <stdexcept>
 
 namespace irata::sim::microcode::compiler::ir {
 
@@ -17,20 +20,32 @@ Instruction::Instruction(const asm_::Instruction &descriptor,
 
 namespace {
 
-std::vector<Step>
-convert_dsl_steps(const std::vector<std::unique_ptr<dsl::Step>> &steps) {
+// Steps can only hold registered controls, so check for others here, where
+// the error can name the instruction that uses them.
+std::vector<Step> convert_dsl_steps(const ControlRegistry &registry,
+                                    const dsl::Instruction &instruction) {
   std::vector<Step> result;
-  for (const auto &step : steps) {
-    result.emplace_back(*step);
+  for (const auto &step : instruction.steps()) {
+    for (const auto *control : step->controls()) {
+      if (!registry.id(*control)) {
+        std::ostringstream os;
+        os << "Instruction " << instruction.descriptor() << " step "
+           << result.size() << " uses control " << control->path()
+           << ", which isn't registered";
+        throw std::invalid_argument(os.str());
+      }
+    }
+    result.emplace_back(registry, *step);
   }
   return result;
 }
 
 } // namespace
 
-Instruction::Instruction(const dsl::Instruction &instruction)
+Instruction::Instruction(const ControlRegistry &registry,
+                         const dsl::Instruction &instruction)
     : Instruction(instruction.descriptor(),
-                  convert_dsl_steps(instruction.steps()),
+                  convert_dsl_steps(registry, instruction),
                   instruction.statuses()) {}
 
 const asm_::Instruction &Instruction::descriptor() const { return descriptor_; }
@@ -1,17 +1,23 @@
 #include <irata/sim/microcode/compiler/ir/instruction_set.hpp>
+#include <stdexcept>
 
 namespace irata::sim::microcode::compiler::ir {
 
-InstructionSet::InstructionSet(std::set<Instruction> instructions)
-    : instructions_(std::move(instructions)) {}
+InstructionSet::InstructionSet(std::set<Instruction> instructions,
+                               std::shared_ptr<const ControlRegistry> registry)
+    : instructions_(std::move(instructions)), registry_(std::move(registry)) {}
 
 namespace {
 
 std::set<Instruction> convert_instructions(
+    const ControlRegistry *registry,
     const std::vector<std::unique_ptr<dsl::Instruction>> &instructions) {
+  if (registry == nullptr) {
+    throw std::invalid_argument("Registry cannot be null");
+  }
   std::set<Instruction> result;
   for (const auto &instruction : instructions) {
-    Instruction instruction_(*instruction);
+    Instruction instruction_(*registry, *instruction);
     result.insert(instruction_);
   }
   return result;
@@ -20,12 +26,25 @@ std::set<Instruction> convert_instructions(
 } // namespace
 
 InstructionSet::InstructionSet(const dsl::InstructionSet &instruction_set)
-    : InstructionSet(convert_instructions(instruction_set.instructions())) {}
+    : InstructionSet(
+          std::make_shared<const ControlRegistry>(instruction_set.controls()),
+          instruction_set) {}
+
+InstructionSet::InstructionSet(std::shared_ptr<const ControlRegistry> registry,
+                               const dsl::InstructionSet &instruction_set)
+    : InstructionSet(
+          convert_instructions(registry.get(), instruction_set.instructions()),
+          registry) {}
 
 const std::set<Instruction> &InstructionSet::instructions() const {
   return instructions_;
 }
 
+const std::shared_ptr<const ControlRegistry> &
+InstructionSet::registry() const {
+  return registry_;
+}
+
 bool InstructionSet::operator==(const InstructionSet &other) const {
   return instructions_ == other.instructions_;
 }
@@ -1,47 +1,51 @@
+#include <irata/sim/microcode/compiler/ir/control_registry.hpp>
 #include <irata/sim/microcode/compiler/ir/step.hpp>
 #include <sstream>
 #include <stdexcept>
+#include <string_view>
 
 namespace irata::sim::microcode::compiler::ir {
 
-Step::Step(std::set<const hdl::ControlDecl *> controls,
-           std::set<const hdl::WriteControlDecl *> write_controls,
-           std::set<const hdl::ReadControlDecl *> read_controls, int stage)
-    : controls_(std::move(controls)),
-      write_controls_(std::move(write_controls)),
-      read_controls_(std::move(read_controls)), stage_(stage) {
-  for (const auto &control : controls_) {
-    if (control == nullptr) {
-      throw std::invalid_argument("Control cannot be null");
-    }
-  }
-  for (const auto &control : write_controls_) {
-    if (control == nullptr) {
-      throw std::invalid_argument("Write control cannot be null");
-    }
-    if (controls_.find(control) == controls_.end()) {
-      std::ostringstream os;
-      os << "Write control " << control->path() << " must be in controls"
-         << " in step " << *this;
-      throw std::invalid_argument(os.str());
-    }
-  }
-  for (const auto &control : read_controls_) {
-    if (control == nullptr) {
-      throw std::invalid_argument("Read control cannot be null");
-    }
-    if (controls_.find(control) == controls_.end()) {
-      std::ostringstream os;
-      os << "Read control " << control->path() << " must be in controls"
-         << " in step " << *this;
-      throw std::invalid_argument(os.str());
-    }
+namespace {
+
+// Throws if any of the given controls are missing from the allowed controls.
+void check_subset(const ControlSet &controls, const ControlSet &allowed,
+                  std::string_view kind, std::string_view requirement,
+                  const Step &step) {
+  if (const auto extra = controls - allowed; !extra.empty()) {
+    std::ostringstream os;
+    os << kind << " control " << (*extra.begin())->path() << " must be "
+       << requirement << " in step " << step;
+    throw std::invalid_argument(os.str());
   }
 }
 
-Step::Step(const dsl::Step &step)
-    : Step(step.controls(), step.write_controls(), step.read_controls(),
-           step.stage()) {}
+} // namespace
+
+Step::Step(ControlSet controls, ControlSet write_controls,
+           ControlSet read_controls, int stage)
+    : controls_(controls), write_controls_(write_controls),
+      read_controls_(read_controls), stage_(stage) {
+  const auto &registry = controls_.registry();
+  check_subset(write_controls_, registry.write_controls(), "Write",
+               "a write control", *this);
+  check_subset(write_controls_, controls_, "Write", "in controls", *this);
+  check_subset(read_controls_, registry.read_controls(), "Read",
+               "a read control", *this);
+  check_subset(read_controls_, controls_, "Read", "in controls", *this);
+}
+
+Step::Step(const ControlRegistry &registry,
+           const std::set<const hdl::ControlDecl *> &controls,
+           const std::set<const hdl::WriteControlDecl *> &write_controls,
+           const std::set<const hdl::ReadControlDecl *> &read_controls,
+           int stage)
+    : Step(ControlSet(registry, controls), ControlSet(registry, write_controls),
+           ControlSet(registry, read_controls), stage) {}
+
+Step::Step(const ControlRegistry &registry, const dsl::Step &step)
+    : Step(registry, step.controls(), step.write_controls(),
+           step.read_controls(), step.stage()) {}
 
 bool Step::operator==(const Step &other) const {
   return std::tie(controls_, write_controls_, read_controls_, stage_) ==
@@ -67,15 +71,15 @@ std::ostream &operator<<(std::ostream &os, const Step &step) {
   return os;
 }
 
-const std::set<const hdl::ControlDecl *> &Step::controls() const {
+const ControlSet &Step::controls() const {
   return controls_;
 }
 
-const std::set<const hdl::WriteControlDecl *> &Step::write_controls() const {
+const ControlSet &Step::write_controls() const {
   return write_controls_;
 }
 
-const std::set<const hdl::ReadControlDecl *> &Step::read_controls() const {
+const ControlSet &Step::read_controls() const {
   return read_controls_;
 }
 
@@ -1,7 +1,6 @@
 #include <irata/common/strings/strings.hpp>
+#include <irata/sim/microcode/compiler/ir/control_registry.hpp>
 #include <irata/sim/microcode/compiler/passes/bus_validator.hpp>
-#include <map>
-#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
@@ -10,44 +9,32 @@ namespace irata::sim::microcode::compiler::passes {
 
 namespace {
 
-struct Controls {
-  std::set<const hdl::WriteControlDecl *> write_controls;
-  std::set<const hdl::ReadControlDecl *> read_controls;
-};
-
-std::map<const hdl::BusDecl *, Controls>
-group_controls_by_bus(const ir::Step &step) {
-  std::map<const hdl::BusDecl *, Controls> result;
-  for (const auto &control : step.write_controls()) {
-    result[&control->bus()].write_controls.insert(control);
-  }
-  for (const auto &control : step.read_controls()) {
-    result[&control->bus()].read_controls.insert(control);
-  }
-  return result;
-}
-
 void validate(const ir::Step &step) {
-  const auto controls_by_bus = group_controls_by_bus(step);
-  for (const auto &[bus, controls] : controls_by_bus) {
-    if (controls.write_controls.size() == 0) {
+  for (const auto &[bus, bus_controls] :
+       step.controls().registry().bus_controls()) {
+    const auto write_controls = step.write_controls() & bus_controls;
+    const auto read_controls = step.read_controls() & bus_controls;
+    if (write_controls.empty() && read_controls.empty()) {
+      continue;
+    }
+    if (write_controls.empty()) {
       std::ostringstream os;
       os << "Bus " << bus->path() << " is read but not written in step "
          << step;
       throw std::invalid_argument(os.str());
     }
-    if (controls.write_controls.size() > 1) {
+    if (write_controls.size() > 1) {
       std::ostringstream os;
       os << "Bus " << bus->path() << " is written by multiple controls in step "
          << step << ": ";
       std::vector<std::string> control_paths;
-      for (const auto &control : controls.write_controls) {
+      for (const auto &control : write_controls) {
         control_paths.push_back(control->path());
       }
       os << common::strings::join(control_paths, ", ");
       throw std::invalid_argument(os.str());
     }
-    if (controls.read_controls.size() == 0) {
+    if (read_controls.empty()) {
       std::ostringstream os;
       os << "Bus " << bus->path() << " is written but not read in step "
          << step;
@@ -62,18 +49,12 @@ void validate(const ir::Instruction &instruction) {
   }
 }
 
-void validate(const ir::InstructionSet &instruction_set) {
-  for (const auto &instruction : instruction_set.instructions()) {
-    validate(instruction);
-  }
-}
-
 } // namespace
 
-ir::InstructionSet
-BusValidator::run(const ir::InstructionSet &instruction_set) {
-  validate(instruction_set);
-  return instruction_set;
+ir::Instruction
+BusValidator::run_instruction(const ir::Instruction &instruction) const {
+  validate(instruction);
+  return instruction;
 }
 
 } // namespace irata::sim::microcode::compiler::passes
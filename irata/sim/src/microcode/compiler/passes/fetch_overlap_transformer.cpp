@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <irata/sim/hdl/irata_decl.hpp>
+#include <irata/sim/microcode/compiler/passes/fetch_overlap_transformer.hpp>
+#include <sstream>
+#include <stdexcept>
+
+namespace irata::sim::microcode::compiler::passes {
+
+namespace {
+
+// Returns the step that loads the memory address register from the pc.
+ir::Step fetch_transfer(const ir::ControlRegistry &registry, int stage) {
+  const auto &pc_write = hdl::irata().cpu().pc().write();
+  const auto &address_read = hdl::irata().memory().address().read();
+  return ir::Step(registry, {&pc_write, &address_read}, {&pc_write},
+                  {&address_read}, stage);
+}
+
+ir::Instruction transform(const ir::Instruction &instruction) {
+  std::vector<ir::Step> steps = instruction.steps();
+  if (steps.empty()) {
+    std::ostringstream os;
+    os << "Instruction " << instruction << " has no fetch stage";
+    throw std::invalid_argument(os.str());
+  }
+  const auto &registry = steps.front().controls().registry();
+  if (steps.front() != fetch_transfer(registry, /*stage=*/0)) {
+    std::ostringstream os;
+    os << "Instruction " << instruction
+       << " doesn't start its fetch stage with " << fetch_transfer(registry, 0);
+    throw std::invalid_argument(os.str());
+  }
+  steps.erase(steps.begin());
+  // The fetch stage must stay the same in every instruction, so the transfer
+  // always goes after it.
+  const int stage = std::max(steps.back().stage(), 1);
+  steps.push_back(fetch_transfer(registry, stage));
+  return ir::Instruction(instruction.descriptor(), steps,
+                         instruction.statuses());
+}
+
+} // namespace
+
+ir::Instruction FetchOverlapTransformer::run_instruction(
+    const ir::Instruction &instruction) const {
+  return transform(instruction);
+}
+
+std::set<const hdl::ControlDecl *>
+FetchOverlapTransformer::added_controls() const {
+  return {&hdl::irata().cpu().pc().write(),
+          &hdl::irata().memory().address().read()};
+}
+
+} // namespace irata::sim::microcode::compiler::passes
@@ -0,0 +1,92 @@
+#include <irata/sim/hdl/irata_decl.hpp>
+#include <irata/sim/microcode/compiler/passes/fetch_overlap_validator.hpp>
+#include <sstream>
+#include <stdexcept>
+
+namespace irata::sim::microcode::compiler::passes {
+
+namespace {
+
+bool is_within(const hdl::ComponentDecl *component,
+               const hdl::ComponentDecl &ancestor) {
+  for (; component != nullptr; component = component->parent()) {
+    if (component == &ancestor) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns true if the given control can't run in the fetch's pc to memory
+// address register transfer step, or in a step after it.
+bool conflicts_with_fetch(const hdl::ControlDecl &control,
+                          bool in_transfer_step) {
+  const auto &irata = hdl::irata();
+  if (const auto *bus_control =
+          dynamic_cast<const hdl::ControlWithBusDecl *>(&control);
+      bus_control != nullptr && &bus_control->bus() == &irata.address_bus()) {
+    return true;
+  }
+  // The transfer reads the pc in the write phase, so any pc control but a
+  // write would change it too late.
+  if (is_within(control.parent(), irata.cpu().pc()) &&
+      dynamic_cast<const hdl::WriteControlDecl *>(&control) == nullptr) {
+    return true;
+  }
+  // The transfer loads the memory address register in the read phase, so the
+  // memory can only use its old address in an earlier phase of the same step.
+  return is_within(control.parent(), irata.memory()) &&
+         (!in_transfer_step || control.phase() >= hdl::TickPhase::Read);
+}
+
+void validate(const ir::Instruction &instruction) {
+  if (instruction.steps().empty()) {
+    return;
+  }
+
+  const hdl::ControlDecl &pc_write = hdl::irata().cpu().pc().write();
+  const hdl::ControlDecl &address_read =
+      hdl::irata().memory().address().read();
+  const auto is_transfer = [&](const ir::Step &step) {
+    return step.stage() > 0 && step.controls().count(&pc_write) > 0 &&
+           step.controls().count(&address_read) > 0;
+  };
+
+  const auto &steps = instruction.steps();
+  auto transfer = steps.rbegin();
+  while (transfer != steps.rend() && !is_transfer(*transfer)) {
+    ++transfer;
+  }
+  if (transfer == steps.rend()) {
+    std::ostringstream os;
+    os << "Instruction " << instruction
+       << " does not load the memory address register from the pc after its "
+          "fetch stage";
+    throw std::invalid_argument(os.str());
+  }
+  for (auto step = steps.rbegin(); step != std::next(transfer); ++step) {
+    for (const auto *control : step->controls()) {
+      if (step == transfer &&
+          (control == &pc_write || control == &address_read)) {
+        continue;
+      }
+      if (conflicts_with_fetch(*control, step == transfer)) {
+        std::ostringstream os;
+        os << "Step " << *step << " of instruction " << instruction
+           << " has control " << control->path()
+           << " that conflicts with the next fetch";
+        throw std::invalid_argument(os.str());
+      }
+    }
+  }
+}
+
+} // namespace
+
+ir::Instruction FetchOverlapValidator::run_instruction(
+    const ir::Instruction &instruction) const {
+  validate(instruction);
+  return instruction;
+}
+
+} // namespace irata::sim::microcode::compiler::passes
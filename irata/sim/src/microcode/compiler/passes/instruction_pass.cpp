@@ -0,0 +1,14 @@
+#include <irata/sim/microcode/compiler/passes/instruction_pass.hpp>
+
+namespace irata::sim::microcode::compiler::passes {
+
+ir::InstructionSet
+InstructionPass::run(const ir::InstructionSet &instruction_set) {
+  std::set<ir::Instruction> instructions;
+  for (const auto &instruction : instruction_set.instructions()) {
+    instructions.insert(run_instruction(instruction));
+  }
+  return ir::InstructionSet(instructions, instruction_set.registry());
+}
+
+} // namespace irata::sim::microcode::compiler::passes
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <irata/sim/hdl/irata_decl.hpp>
+#include <irata/sim/microcode/compiler/passes/list_scheduler.hpp>
+#include <optional>
+#include <vector>
+
+namespace irata::sim::microcode::compiler::passes {
+
+ListScheduler::ListScheduler(std::set<const hdl::ComponentDecl *> units,
+                             UnitReads unit_reads)
+    : units_(std::move(units)), unit_reads_(std::move(unit_reads)) {}
+
+std::unique_ptr<ListScheduler> ListScheduler::irata() {
+  const auto &irata = hdl::irata();
+  const auto &cpu = irata.cpu();
+  const std::set<const hdl::ComponentDecl *> units = {
+      &cpu.a(),
+      &cpu.x(),
+      &cpu.y(),
+      &cpu.pc(),
+      &cpu.controller(),
+      &cpu.alu(),
+      &cpu.alu().lhs(),
+      &cpu.alu().rhs(),
+      &cpu.buffer(),
+      &cpu.status_register(),
+      &cpu.stack_pointer(),
+      &irata.memory(),
+      &irata.memory().address(),
+  };
+  // The ALU reads its operands and the carry from the status register, the
+  // status register latches the ALU's flags, the memory reads and writes at
+  // its address register, and the address register's carry increment reads
+  // the ALU's address add carry.
+  UnitReads unit_reads = {
+      {&cpu.alu(),
+       {&cpu.alu().lhs(), &cpu.alu().rhs(), &cpu.status_register()}},
+      {&cpu.status_register(), {&cpu.alu()}},
+      {&irata.memory(), {&irata.memory().address()}},
+      {&irata.memory().address(), {&cpu.alu()}},
+  };
+  return std::make_unique<ListScheduler>(units, std::move(unit_reads));
+}
+
+namespace {
+
+template <typename T>
+bool intersects(const std::set<T> &lhs, const std::set<T> &rhs) {
+  return std::any_of(lhs.begin(), lhs.end(),
+                     [&rhs](const T &value) { return rhs.count(value) > 0; });
+}
+
+// An access to a unit's state by a control, in the control's tick phase.
+struct Access {
+  const hdl::ComponentDecl *unit;
+  hdl::TickPhase phase;
+};
+
+// The state accesses of a step, used to find the dependencies between steps.
+struct Operation {
+  std::vector<Access> reads;
+  std::vector<Access> writes;
+  std::set<const hdl::BusDecl *> buses;
+  bool barrier = false;
+
+  // Returns the number of ticks this operation has to stay after the given
+  // earlier operation: 0 if it can share a tick because each of its accesses
+  // that conflicts with the earlier operation runs in a later tick phase, 1 if
+  // it has to wait for the next tick, or nullopt if the two are independent.
+  std::optional<size_t> delay_after(const Operation &other) const {
+    if (barrier || other.barrier) {
+      return 1;
+    }
+    std::optional<size_t> delay;
+    const auto check = [&delay](const std::vector<Access> &earlier,
+                                const std::vector<Access> &later) {
+      for (const auto &earlier_access : earlier) {
+        for (const auto &later_access : later) {
+          if (earlier_access.unit == later_access.unit) {
+            delay = std::max<size_t>(
+                delay.value_or(0),
+                earlier_access.phase < later_access.phase ? 0 : 1);
+          }
+        }
+      }
+    };
+    check(other.writes, reads);
+    check(other.writes, writes);
+    check(other.reads, writes);
+    return delay;
+  }
+};
+
+Operation operation_of(const std::set<const hdl::ComponentDecl *> &units,
+                       const ListScheduler::UnitReads &unit_reads,
+                       const ir::Step &step) {
+  Operation operation;
+  for (const auto *control : step.controls()) {
+    const hdl::ComponentDecl *unit = control->parent();
+    while (unit != nullptr && units.count(unit) == 0) {
+      unit = unit->parent();
+    }
+    if (unit == nullptr) {
+      operation.barrier = true;
+      continue;
+    }
+    const auto phase = control->phase();
+    if (const auto it = unit_reads.find(unit); it != unit_reads.end()) {
+      for (const auto *read_unit : it->second) {
+        operation.reads.push_back({read_unit, phase});
+      }
+    }
+    if (const auto *write_control =
+            dynamic_cast<const hdl::WriteControlDecl *>(control)) {
+      operation.reads.push_back({unit, phase});
+      operation.buses.insert(&write_control->bus());
+    } else if (const auto *read_control =
+                   dynamic_cast<const hdl::ReadControlDecl *>(control)) {
+      operation.writes.push_back({unit, phase});
+      operation.buses.insert(&read_control->bus());
+    } else {
+      operation.reads.push_back({unit, phase});
+      operation.writes.push_back({unit, phase});
+    }
+  }
+  return operation;
+}
+
+ir::Step merge(const ir::Step &lhs, const ir::Step &rhs) {
+  return ir::Step(lhs.controls() | rhs.controls(),
+                  lhs.write_controls() | rhs.write_controls(),
+                  lhs.read_controls() | rhs.read_controls(), lhs.stage());
+}
+
+ir::Instruction schedule(const std::set<const hdl::ComponentDecl *> &units,
+                         const ListScheduler::UnitReads &unit_reads,
+                         const ir::Instruction &instruction) {
+  std::vector<ir::Step> scheduled_steps;
+  const auto &steps = instruction.steps();
+  for (size_t stage_begin = 0; stage_begin < steps.size();) {
+    size_t stage_end = stage_begin;
+    while (stage_end < steps.size() &&
+           steps[stage_end].stage() == steps[stage_begin].stage()) {
+      ++stage_end;
+    }
+
+    // The tick each step of the stage is placed in, relative to the start of
+    // the stage, and the steps and buses in each tick.
+    std::vector<Operation> operations;
+    std::vector<size_t> step_ticks;
+    std::vector<std::vector<size_t>> tick_steps;
+    std::vector<std::set<const hdl::BusDecl *>> tick_buses;
+    for (size_t i = stage_begin; i < stage_end; ++i) {
+      const auto &operation =
+          operations.emplace_back(operation_of(units, unit_reads, steps[i]));
+      const size_t index = operations.size() - 1;
+      size_t tick = 0;
+      for (size_t earlier = 0; earlier < index; ++earlier) {
+        if (const auto delay = operation.delay_after(operations[earlier])) {
+          tick = std::max(tick, step_ticks[earlier] + *delay);
+        }
+      }
+      while (tick < tick_buses.size() &&
+             intersects(tick_buses[tick], operation.buses)) {
+        ++tick;
+      }
+      if (tick == tick_steps.size()) {
+        tick_steps.emplace_back();
+        tick_buses.emplace_back();
+      }
+      step_ticks.push_back(tick);
+      tick_steps[tick].push_back(i);
+      tick_buses[tick].insert(operation.buses.begin(), operation.buses.end());
+    }
+
+    for (const auto &tick : tick_steps) {
+      ir::Step step = steps[tick.front()];
+      for (size_t i = 1; i < tick.size(); ++i) {
+        step = merge(step, steps[tick[i]]);
+      }
+      scheduled_steps.push_back(std::move(step));
+    }
+    stage_begin = stage_end;
+  }
+  return ir::Instruction(instruction.descriptor(), scheduled_steps,
+                         instruction.statuses());
+}
+
+} // namespace
+
+ir::Instruction
+ListScheduler::run_instruction(const ir::Instruction &instruction) const {
+  return schedule(units_, unit_reads_, instruction);
+}
+
+} // namespace irata::sim::microcode::compiler::passes
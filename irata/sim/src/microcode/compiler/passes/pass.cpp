@@ -0,0 +1,7 @@
+#include <irata/sim/microcode/compiler/passes/pass.hpp>
+
+namespace irata::sim::microcode::compiler::passes {
+
+std::set<const hdl::ControlDecl *> Pass::added_controls() const { return {}; }
+
+} // namespace irata::sim::microcode::compiler::passes
@@ -5,26 +5,14 @@ namespace irata::sim::microcode::compiler::passes {
 
 namespace {
 
-void add_control(std::set<const hdl::ControlDecl *> &controls,
-                 const hdl::ControlDecl &control) {
-  controls.insert(&control);
-}
-
-void remove_control(std::set<const hdl::ControlDecl *> &controls,
-                    const hdl::ControlDecl &control) {
-  if (const auto it = controls.find(&control); it != controls.end()) {
-    controls.erase(it);
-  }
-}
-
 ir::Step transform_increment_step(const ir::Step &step) {
   const hdl::ProcessControlDecl &increment_control =
       hdl::irata().cpu().controller().step_counter().increment();
   const hdl::ProcessControlDecl &reset_control =
       hdl::irata().cpu().controller().step_counter().reset();
-  std::set<const hdl::ControlDecl *> transformed_controls = step.controls();
-  add_control(transformed_controls, increment_control);
-  remove_control(transformed_controls, reset_control);
+  ir::ControlSet transformed_controls = step.controls();
+  transformed_controls.insert(&increment_control);
+  transformed_controls.erase(&reset_control);
   return ir::Step(transformed_controls, step.write_controls(),
                   step.read_controls(), step.stage());
 }
@@ -34,9 +22,9 @@ ir::Step transform_reset_step(const ir::Step &step) {
       hdl::irata().cpu().controller().step_counter().increment();
   const hdl::ProcessControlDecl &reset_control =
       hdl::irata().cpu().controller().step_counter().reset();
-  std::set<const hdl::ControlDecl *> transformed_controls = step.controls();
-  remove_control(transformed_controls, increment_control);
-  add_control(transformed_controls, reset_control);
+  ir::ControlSet transformed_controls = step.controls();
+  transformed_controls.erase(&increment_control);
+  transformed_controls.insert(&reset_control);
   return ir::Step(transformed_controls, step.write_controls(),
                   step.read_controls(), step.stage());
 }
@@ -55,19 +43,17 @@ ir::Instruction transform(const ir::Instruction &instruction) {
                          instruction.statuses());
 }
 
-ir::InstructionSet transform(const ir::InstructionSet &instruction_set) {
-  std::set<ir::Instruction> transformed_instructions;
-  for (const auto &instruction : instruction_set.instructions()) {
-    transformed_instructions.insert(transform(instruction));
-  }
-  return ir::InstructionSet(transformed_instructions);
-}
-
 } // namespace
 
-ir::InstructionSet
-StepIndexTransformer::run(const ir::InstructionSet &instruction_set) {
-  return transform(instruction_set);
+ir::Instruction StepIndexTransformer::run_instruction(
+    const ir::Instruction &instruction) const {
+  return transform(instruction);
+}
+
+std::set<const hdl::ControlDecl *>
+StepIndexTransformer::added_controls() const {
+  const auto &step_counter = hdl::irata().cpu().controller().step_counter();
+  return {&step_counter.increment(), &step_counter.reset()};
 }
 
 } // namespace irata::sim::microcode::compiler::passes
\ No newline at end of file
@@ -13,7 +13,7 @@ void validate(const ir::Instruction &instruction) {
   }
 
   const auto step_contains_control = [](const ir::Step &step, const auto &ctl) {
-    return step.controls().find(&ctl) != step.controls().end();
+    return step.controls().count(&ctl) > 0;
   };
 
   const hdl::ControlDecl &increment_step_index =
@@ -46,18 +46,12 @@ void validate(const ir::Instruction &instruction) {
   }
 }
 
-void validate(const ir::InstructionSet &instruction_set) {
-  for (const auto &instruction : instruction_set.instructions()) {
-    validate(instruction);
-  }
-}
-
 } // namespace
 
-ir::InstructionSet
-StepIndexValidator::run(const ir::InstructionSet &instruction_set) {
-  validate(instruction_set);
-  return instruction_set;
+ir::Instruction
+StepIndexValidator::run_instruction(const ir::Instruction &instruction) const {
+  validate(instruction);
+  return instruction;
 }
 
 } // namespace irata::sim::microcode::compiler::passes
@@ -1,23 +1,37 @@
+#include <irata/sim/microcode/compiler/ir/control_registry.hpp>
 #include <irata/sim/microcode/compiler/passes/step_merger.hpp>
+#include <iterator>
 
 namespace irata::sim::microcode::compiler::passes {
 
 namespace {
 
+constexpr hdl::TickPhase phases[] = {
+    hdl::TickPhase::Control, hdl::TickPhase::Write, hdl::TickPhase::Read,
+    hdl::TickPhase::Process, hdl::TickPhase::Clear};
+
+bool has_phase(const ir::Step &step, hdl::TickPhase phase) {
+  return !(step.controls() &
+           step.controls().registry().phase_controls(phase))
+              .empty();
+}
+
 hdl::TickPhase min_phase(const ir::Step &step) {
-  hdl::TickPhase min_phase = hdl::TickPhase::Clear;
-  for (const auto &control : step.controls()) {
-    min_phase = std::min(min_phase, control->phase());
+  for (const auto phase : phases) {
+    if (has_phase(step, phase)) {
+      return phase;
+    }
   }
-  return min_phase;
+  return hdl::TickPhase::Clear;
 }
 
 hdl::TickPhase max_phase(const ir::Step &step) {
-  hdl::TickPhase max_phase = hdl::TickPhase::Control;
-  for (const auto &control : step.controls()) {
-    max_phase = std::max(max_phase, control->phase());
+  for (auto it = std::rbegin(phases); it != std::rend(phases); ++it) {
+    if (has_phase(step, *it)) {
+      return *it;
+    }
   }
-  return max_phase;
+  return hdl::TickPhase::Control;
 }
 
 bool can_merge(const ir::Step &lhs, const ir::Step &rhs) {
@@ -25,14 +39,9 @@ bool can_merge(const ir::Step &lhs, const ir::Step &rhs) {
 }
 
 ir::Step merge(const ir::Step &lhs, const ir::Step &rhs) {
-  std::set<const hdl::ControlDecl *> controls = lhs.controls();
-  controls.insert(rhs.controls().begin(), rhs.controls().end());
-  std::set<const hdl::WriteControlDecl *> write_controls = lhs.write_controls();
-  write_controls.insert(rhs.write_controls().begin(),
-                        rhs.write_controls().end());
-  std::set<const hdl::ReadControlDecl *> read_controls = lhs.read_controls();
-  read_controls.insert(rhs.read_controls().begin(), rhs.read_controls().end());
-  return ir::Step(controls, write_controls, read_controls, lhs.stage());
+  return ir::Step(lhs.controls() | rhs.controls(),
+                  lhs.write_controls() | rhs.write_controls(),
+                  lhs.read_controls() | rhs.read_controls(), lhs.stage());
 }
 
 ir::Instruction transform(const ir::Instruction &instruction) {
@@ -58,18 +67,11 @@ ir::Instruction transform(const ir::Instruction &instruction) {
                          instruction.statuses());
 }
 
-ir::InstructionSet transform(const ir::InstructionSet &instruction_set) {
-  std::set<ir::Instruction> transformed_instructions;
-  for (const auto &instruction : instruction_set.instructions()) {
-    transformed_instructions.insert(transform(instruction));
-  }
-  return ir::InstructionSet(transformed_instructions);
-}
-
 } // namespace
 
-ir::InstructionSet StepMerger::run(const ir::InstructionSet &instruction_set) {
-  return transform(instruction_set);
+ir::Instruction
+StepMerger::run_instruction(const ir::Instruction &instruction) const {
+  return transform(instruction);
 }
 
 } // namespace irata::sim::microcode::compiler::passes
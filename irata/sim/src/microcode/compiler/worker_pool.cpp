@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <irata/sim/microcode/compiler/worker_pool.hpp>
+
+namespace irata::sim::microcode::compiler {
+
+WorkerPool::WorkerPool(size_t num_threads)
+    : num_threads_(std::max<size_t>(1, num_threads)) {
+  for (size_t worker = 1; worker < num_threads_; ++worker) {
+    workers_.emplace_back([this] { work(); });
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  work_added_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+size_t WorkerPool::num_threads() const { return num_threads_; }
+
+void WorkerPool::run(size_t num_jobs,
+                     const std::function<void(size_t)> &job) {
+  if (num_jobs == 0) {
+    return;
+  }
+  if (workers_.empty() || num_jobs == 1) {
+    for (size_t i = 0; i < num_jobs; ++i) {
+      job(i);
+    }
+    return;
+  }
+  const auto batch = std::make_shared<Batch>(Batch{job, num_jobs});
+  std::unique_lock lock(mutex_);
+  batches_.push_back(batch);
+  work_added_.notify_all();
+  work_on(*batch, lock);
+  batch_done_.wait(lock,
+                   [&batch] { return batch->num_done == batch->num_jobs; });
+}
+
+void WorkerPool::work_on(Batch &batch, std::unique_lock<std::mutex> &lock) {
+  while (batch.next < batch.num_jobs) {
+    const size_t i = batch.next++;
+    if (batch.next == batch.num_jobs) {
+      // Every job has started, so no other thread should take this batch.
+      batches_.erase(std::find_if(
+          batches_.begin(), batches_.end(),
+          [&batch](const auto &queued) { return queued.get() == &batch; }));
+    }
+    lock.unlock();
+    batch.job(i);
+    lock.lock();
+    if (++batch.num_done == batch.num_jobs) {
+      batch_done_.notify_all();
+    }
+  }
+}
+
+void WorkerPool::work() {
+  std::unique_lock lock(mutex_);
+  while (true) {
+    work_added_.wait(lock, [this] { return stopping_ || !batches_.empty(); });
+    if (stopping_) {
+      return;
+    }
+    // Hold the batch, since the last job to start removes it from the queue.
+    const auto batch = batches_.front();
+    work_on(*batch, lock);
+  }
+}
+
+} // namespace irata::sim::microcode::compiler
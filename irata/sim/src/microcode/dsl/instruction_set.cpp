@@ -42,6 +42,16 @@ InstructionSet::instructions() const {
   return instructions_;
 }
 
+std::set<const hdl::ControlDecl *> InstructionSet::controls() const {
+  std::set<const hdl::ControlDecl *> controls;
+  for (const auto &instruction : instructions_) {
+    for (const auto &step : instruction->steps()) {
+      controls.insert(step->controls().begin(), step->controls().end());
+    }
+  }
+  return controls;
+}
+
 const Instruction &InstructionSet::get_instruction(
     const asm_::Instruction &descriptor,
     std::map<const hdl::StatusDecl *, bool> statuses) const {
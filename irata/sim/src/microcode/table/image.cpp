@@ -0,0 +1,219 @@
+#include <irata/asm/instruction.hpp>
+#include <irata/common/serialization/serialization.hpp>
+#include <irata/sim/hdl/irata_decl.hpp>
+#include <irata/sim/microcode/dsl/instruction.hpp>
+#include <irata/sim/microcode/dsl/step.hpp>
+#include <irata/sim/microcode/table/image.hpp>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace irata::sim::microcode::table {
+
+namespace {
+
+using common::serialization::Hasher;
+using common::serialization::read_u16;
+using common::serialization::read_u32;
+using common::serialization::read_u64;
+using common::serialization::read_u8;
+using common::serialization::write_u16;
+using common::serialization::write_u32;
+using common::serialization::write_u64;
+using common::serialization::write_u8;
+
+// Identifies an irata microcode image.
+constexpr char magic[8] = {'I', 'R', 'A', 'T', 'A', 'M', 'C', '\0'};
+
+// Bumped whenever the layout of the image changes.
+constexpr uint32_t version = 1;
+
+void write_string(std::ostream &os, const std::string &s) {
+  write_u16(os, s.size());
+  os.write(s.data(), s.size());
+}
+
+std::string read_string(std::istream &is) {
+  std::string s(read_u16(is), '\0');
+  if (!is.read(s.data(), s.size())) {
+    throw std::runtime_error("microcode image is truncated");
+  }
+  return s;
+}
+
+// The instructions, controls and statuses that can appear in a table compiled
+// from the instruction set, by opcode and path. These are the ones named by
+// the instruction set plus the step counter controls added by the compiler.
+struct Decls {
+  std::map<uint8_t, const asm_::Instruction *> instructions;
+  std::map<std::string, const hdl::ControlDecl *> controls;
+  std::map<std::string, const hdl::StatusDecl *> statuses;
+
+  explicit Decls(const dsl::InstructionSet &instruction_set) {
+    for (const auto &instruction : instruction_set.instructions()) {
+      instructions.emplace(instruction->descriptor().opcode().unsigned_value(),
+                           &instruction->descriptor());
+      for (const auto &[status, _] : instruction->statuses()) {
+        statuses.emplace(status->path(), status);
+      }
+      for (const auto &step : instruction->steps()) {
+        for (const auto *control : step->controls()) {
+          controls.emplace(control->path(), control);
+        }
+      }
+    }
+    const auto &step_counter = hdl::irata().cpu().controller().step_counter();
+    for (const hdl::ControlDecl *control :
+         {static_cast<const hdl::ControlDecl *>(&step_counter.increment()),
+          static_cast<const hdl::ControlDecl *>(&step_counter.reset())}) {
+      controls.emplace(control->path(), control);
+    }
+  }
+};
+
+} // namespace
+
+uint64_t image_hash(const dsl::InstructionSet &instruction_set,
+                    uint64_t compiler_fingerprint) {
+  Hasher hasher;
+  hasher.add(version);
+  hasher.add(compiler_fingerprint);
+  for (const auto &instruction : instruction_set.instructions()) {
+    const auto &descriptor = instruction->descriptor();
+    hasher.add(descriptor.name());
+    hasher.add(descriptor.opcode().unsigned_value());
+    hasher.add(static_cast<uint64_t>(descriptor.addressing_mode()));
+    std::map<std::string, bool> statuses;
+    for (const auto &[status, value] : instruction->statuses()) {
+      statuses.emplace(status->path(), value);
+    }
+    for (const auto &[path, value] : statuses) {
+      hasher.add(path);
+      hasher.add(value);
+    }
+    for (const auto &step : instruction->steps()) {
+      hasher.add(static_cast<uint64_t>(step->stage()));
+      std::set<std::string> controls;
+      for (const auto *control : step->controls()) {
+        controls.insert(control->path());
+      }
+      for (const auto &path : controls) {
+        hasher.add(path);
+      }
+      // Separate the steps so that moving a control between steps changes
+      // the hash.
+      hasher.add("");
+    }
+  }
+  return hasher.value();
+}
+
+void write_image(std::ostream &os, const Table &table, uint64_t hash) {
+  // Every path is stored once and entries refer to paths by index.
+  std::map<std::string, uint16_t> path_indices;
+  std::vector<std::string> paths;
+  const auto path_index = [&](const std::string &path) {
+    const auto [it, inserted] = path_indices.emplace(path, paths.size());
+    if (inserted) {
+      paths.push_back(path);
+    }
+    return it->second;
+  };
+  for (const auto &entry : table.entries) {
+    for (const auto &[status, _] : entry.statuses) {
+      path_index(status->path());
+    }
+    for (const auto *control : entry.controls) {
+      path_index(control->path());
+    }
+  }
+
+  os.write(magic, sizeof(magic));
+  write_u32(os, version);
+  write_u64(os, hash);
+  write_u16(os, paths.size());
+  for (const auto &path : paths) {
+    write_string(os, path);
+  }
+  write_u32(os, table.entries.size());
+  for (const auto &entry : table.entries) {
+    write_u8(os, entry.instruction.opcode().unsigned_value());
+    write_u8(os, entry.step_index.unsigned_value());
+    write_u8(os, entry.statuses.size());
+    for (const auto &[status, value] : entry.statuses) {
+      write_u16(os, path_indices.at(status->path()));
+      write_u8(os, value);
+    }
+    write_u16(os, entry.controls.size());
+    for (const auto *control : entry.controls) {
+      write_u16(os, path_indices.at(control->path()));
+    }
+  }
+  if (!os) {
+    throw std::runtime_error("failed to write microcode image");
+  }
+}
+
+std::optional<Table> read_image(std::istream &is,
+                                const dsl::InstructionSet &instruction_set,
+                                uint64_t hash) {
+  char image_magic[sizeof(magic)];
+  if (!is.read(image_magic, sizeof(image_magic)) ||
+      !std::equal(std::begin(magic), std::end(magic), image_magic)) {
+    throw std::runtime_error("not a microcode image");
+  }
+  if (read_u32(is) != version || read_u64(is) != hash) {
+    return std::nullopt;
+  }
+
+  std::vector<std::string> paths(read_u16(is));
+  for (auto &path : paths) {
+    path = read_string(is);
+  }
+  const auto path = [&](uint16_t index) -> const std::string & {
+    if (index >= paths.size()) {
+      throw std::runtime_error("microcode image has a bad path index");
+    }
+    return paths[index];
+  };
+
+  const Decls decls(instruction_set);
+  std::set<Entry> entries;
+  for (uint32_t num_entries = read_u32(is); num_entries > 0; --num_entries) {
+    const auto instruction = decls.instructions.find(read_u8(is));
+    if (instruction == decls.instructions.end()) {
+      return std::nullopt;
+    }
+    const Byte step_index(read_u8(is));
+    std::map<const hdl::StatusDecl *, bool> statuses;
+    for (uint8_t num_statuses = read_u8(is); num_statuses > 0;
+         --num_statuses) {
+      const auto &status_path = path(read_u16(is));
+      const bool value = read_u8(is);
+      const auto it = decls.statuses.find(status_path);
+      if (it == decls.statuses.end()) {
+        return std::nullopt;
+      }
+      statuses.emplace(it->second, value);
+    }
+    std::set<const hdl::ControlDecl *> controls;
+    for (uint16_t num_controls = read_u16(is); num_controls > 0;
+         --num_controls) {
+      const auto it = decls.controls.find(path(read_u16(is)));
+      if (it == decls.controls.end()) {
+        return std::nullopt;
+      }
+      controls.insert(it->second);
+    }
+    entries.insert({
+        .instruction = *instruction->second,
+        .step_index = step_index,
+        .statuses = std::move(statuses),
+        .controls = std::move(controls),
+    });
+  }
+  return Table{std::move(entries)};
+}
+
+} // namespace irata::sim::microcode::table
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <iomanip>
+#include <irata/asm/instruction_set.hpp>
+#include <irata/sim/bytes/byte.hpp>
+#include <irata/sim/profile/profile.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace irata::sim::profile {
+
+void Profile::count_tick(uint8_t step_counter,
+                         std::optional<uint8_t> loaded_opcode) {
+  ++ticks_;
+  if (step_counter == 0) {
+    fetching_ = true;
+  }
+  if (fetching_) {
+    ++fetch_ticks_;
+  } else if (opcode_) {
+    ++opcodes_[*opcode_].ticks;
+  }
+  if (loaded_opcode) {
+    auto &counts = opcodes_[*loaded_opcode];
+    ++counts.instructions;
+    counts.ticks += fetch_ticks_;
+    ++instructions_;
+    opcode_ = loaded_opcode;
+    fetching_ = false;
+    fetch_ticks_ = 0;
+  }
+}
+
+void Profile::count_region_read(const std::string &region) {
+  ++regions_[region].reads;
+}
+
+void Profile::count_region_write(const std::string &region) {
+  ++regions_[region].writes;
+}
+
+void Profile::count_bus_transfer(const std::string &bus) {
+  ++bus_transfers_[bus];
+}
+
+void Profile::count_alu_operation(hdl::AluOpcode opcode) {
+  ++alu_operations_[opcode];
+}
+
+uint64_t Profile::ticks() const { return ticks_; }
+
+uint64_t Profile::instructions() const { return instructions_; }
+
+const std::array<Profile::OpcodeCounts, 256> &Profile::opcodes() const {
+  return opcodes_;
+}
+
+const std::map<std::string, Profile::RegionCounts> &Profile::regions() const {
+  return regions_;
+}
+
+const std::map<std::string, uint64_t> &Profile::bus_transfers() const {
+  return bus_transfers_;
+}
+
+const std::map<hdl::AluOpcode, uint64_t> &Profile::alu_operations() const {
+  return alu_operations_;
+}
+
+namespace {
+
+std::string opcode_name(uint8_t opcode) {
+  std::ostringstream os;
+  try {
+    const auto &instruction =
+        asm_::InstructionSet::irata().get_instruction(Byte(opcode));
+    os << instruction.name() << " " << instruction.addressing_mode() << " ";
+  } catch (const std::invalid_argument &) {
+    os << "unknown ";
+  }
+  os << "(" << Byte(opcode) << ")";
+  return os.str();
+}
+
+double ratio(uint64_t numerator, uint64_t denominator) {
+  return denominator == 0 ? 0 : double(numerator) / denominator;
+}
+
+} // namespace
+
+std::ostream &operator<<(std::ostream &os, const Profile &profile) {
+  const auto flags = os.flags();
+  os << std::dec << std::fixed << std::setprecision(1);
+  os << "Profile: " << profile.ticks() << " ticks, " << profile.instructions()
+     << " instructions, " << ratio(profile.ticks(), profile.instructions())
+     << " ticks per instruction\n";
+
+  std::vector<uint8_t> opcodes;
+  for (size_t opcode = 0; opcode < profile.opcodes().size(); ++opcode) {
+    if (profile.opcodes()[opcode].instructions > 0) {
+      opcodes.push_back(opcode);
+    }
+  }
+  std::stable_sort(opcodes.begin(), opcodes.end(), [&](uint8_t a, uint8_t b) {
+    return profile.opcodes()[a].ticks > profile.opcodes()[b].ticks;
+  });
+  os << "Opcodes by ticks:\n";
+  for (const auto opcode : opcodes) {
+    const auto &counts = profile.opcodes()[opcode];
+    const auto name = opcode_name(opcode);
+    os << std::dec << "  " << name << ": " << counts.instructions
+       << " instructions, " << counts.ticks << " ticks ("
+       << 100 * ratio(counts.ticks, profile.ticks()) << "%), "
+       << ratio(counts.ticks, counts.instructions)
+       << " ticks per instruction\n";
+  }
+
+  os << "Memory regions:\n";
+  for (const auto &[region, counts] : profile.regions()) {
+    os << "  " << region << ": " << counts.reads << " reads, "
+       << counts.writes << " writes\n";
+  }
+
+  os << "Bus transfers:\n";
+  for (const auto &[bus, count] : profile.bus_transfers()) {
+    os << "  " << bus << ": " << count << " ("
+       << 100 * ratio(count, profile.ticks()) << "% of ticks)\n";
+  }
+
+  os << "ALU operations:\n";
+  for (const auto &[opcode, count] : profile.alu_operations()) {
+    os << "  " << opcode << ": " << count << "\n";
+  }
+  os.flags(flags);
+  return os;
+}
+
+} // namespace irata::sim::profile
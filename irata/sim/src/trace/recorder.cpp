@@ -0,0 +1,56 @@
+#include <irata/sim/trace/recorder.hpp>
+#include <stdexcept>
+#include <utility>
+
+namespace irata::sim::trace {
+
+Recorder::Recorder(Header header, size_t capacity)
+    : header_(std::move(header)), os_(nullptr), capacity_(capacity) {
+  if (capacity_ == 0) {
+    throw std::invalid_argument("trace recorder capacity must be positive");
+  }
+  buffer_.reserve(capacity_);
+}
+
+Recorder::Recorder(Header header, std::ostream &os)
+    : header_(std::move(header)), os_(&os), capacity_(0) {
+  header_.write(*os_);
+}
+
+const Header &Recorder::header() const { return header_; }
+
+void Recorder::record(Record record) {
+  record.tick = num_recorded_++;
+  if (os_ != nullptr) {
+    const auto bytes = record.encode();
+    os_->write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+  } else if (buffer_.size() < capacity_) {
+    buffer_.push_back(record);
+  } else {
+    buffer_[record.tick % capacity_] = record;
+  }
+}
+
+uint64_t Recorder::num_recorded() const { return num_recorded_; }
+
+std::vector<Record> Recorder::records() const {
+  if (os_ != nullptr || buffer_.size() < capacity_) {
+    return buffer_;
+  }
+  // The buffer is full, so the oldest record is the one that the next record
+  // will overwrite.
+  const size_t oldest = num_recorded_ % capacity_;
+  std::vector<Record> records(buffer_.begin() + oldest, buffer_.end());
+  records.insert(records.end(), buffer_.begin(), buffer_.begin() + oldest);
+  return records;
+}
+
+void Recorder::write(std::ostream &os) const {
+  header_.write(os);
+  for (const auto &record : records()) {
+    const auto bytes = record.encode();
+    os.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+  }
+}
+
+} // namespace irata::sim::trace
@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <iomanip>
+#include <irata/common/serialization/serialization.hpp>
+#include <irata/common/strings/strings.hpp>
+#include <irata/sim/components/controller/instruction_encoder.hpp>
+#include <irata/sim/trace/trace.hpp>
+#include <sstream>
+#include <stdexcept>
+
+namespace irata::sim::trace {
+
+namespace {
+
+using common::serialization::read_u32;
+using common::serialization::write_u32;
+
+// Identifies a trace.
+constexpr char trace_magic[8] = {'I', 'R', 'A', 'T', 'A', 'T', 'R', '\0'};
+
+// Bumped whenever the layout of a trace changes.
+constexpr uint32_t trace_version = 2;
+
+// Flags in the last byte of an encoded record.
+constexpr uint8_t data_bus_flag = 1 << 0;
+constexpr uint8_t address_bus_flag = 1 << 1;
+
+void write_strings(std::ostream &os, const std::vector<std::string> &strings) {
+  write_u32(os, strings.size());
+  for (const auto &string : strings) {
+    write_u32(os, string.size());
+    os.write(string.data(), string.size());
+  }
+}
+
+std::vector<std::string> read_strings(std::istream &is, size_t max_size) {
+  const auto size = read_u32(is);
+  if (size > max_size) {
+    throw std::runtime_error("trace header is malformed");
+  }
+  std::vector<std::string> strings;
+  for (uint32_t i = 0; i < size; ++i) {
+    // Paths are short, so anything longer than this is a corrupt header
+    // rather than a reason to allocate.
+    const auto length = read_u32(is);
+    if (length > 0x1000) {
+      throw std::runtime_error("trace header is malformed");
+    }
+    std::string string(length, '\0');
+    if (!is.read(string.data(), length)) {
+      throw std::runtime_error("trace header is truncated");
+    }
+    strings.push_back(std::move(string));
+  }
+  return strings;
+}
+
+template <typename T> std::string hex(T value) {
+  std::ostringstream os;
+  os << "0x" << std::uppercase << std::hex << std::setw(sizeof(T) * 2)
+     << std::setfill('0') << uint64_t(value);
+  return os.str();
+}
+
+} // namespace
+
+std::array<uint8_t, Record::size> Record::encode() const {
+  std::array<uint8_t, size> bytes = {};
+  for (int i = 0; i < 8; ++i) {
+    bytes[i] = (tick >> (i * 8)) & 0xFF;
+    bytes[8 + i] = (encoded_controls >> (i * 8)) & 0xFF;
+  }
+  const uint16_t address = address_bus.value_or(0);
+  bytes[16] = address & 0xFF;
+  bytes[17] = address >> 8;
+  bytes[18] = opcode;
+  bytes[19] = step_counter;
+  for (int i = 0; i < 4; ++i) {
+    bytes[20 + i] = (encoded_statuses >> (i * 8)) & 0xFF;
+  }
+  bytes[24] = data_bus.value_or(0);
+  bytes[25] = (data_bus ? data_bus_flag : 0) |
+              (address_bus ? address_bus_flag : 0);
+  return bytes;
+}
+
+Record Record::decode(const std::array<uint8_t, size> &bytes) {
+  if ((bytes[25] & ~(data_bus_flag | address_bus_flag)) != 0) {
+    throw std::runtime_error("trace record is malformed");
+  }
+  Record record;
+  for (int i = 0; i < 8; ++i) {
+    record.tick |= uint64_t(bytes[i]) << (i * 8);
+    record.encoded_controls |= uint64_t(bytes[8 + i]) << (i * 8);
+  }
+  if (bytes[25] & address_bus_flag) {
+    record.address_bus = bytes[16] | (bytes[17] << 8);
+  }
+  record.opcode = bytes[18];
+  record.step_counter = bytes[19];
+  for (int i = 0; i < 4; ++i) {
+    record.encoded_statuses |= uint32_t(bytes[20 + i]) << (i * 8);
+  }
+  if (bytes[25] & data_bus_flag) {
+    record.data_bus = bytes[24];
+  }
+  return record;
+}
+
+bool Record::operator==(const Record &other) const {
+  return tick == other.tick && opcode == other.opcode &&
+         step_counter == other.step_counter &&
+         encoded_statuses == other.encoded_statuses &&
+         encoded_controls == other.encoded_controls &&
+         data_bus == other.data_bus && address_bus == other.address_bus;
+}
+
+bool Record::operator!=(const Record &other) const {
+  return !(*this == other);
+}
+
+Header Header::from_encoder(
+    const components::controller::InstructionEncoder &encoder) {
+  Header header;
+  for (const auto *status : encoder.status_encoder().statuses_by_index()) {
+    header.statuses.push_back(status->path());
+  }
+  for (const auto *control : encoder.control_encoder().controls()) {
+    header.controls.push_back(control->path());
+  }
+  return header;
+}
+
+void Header::write(std::ostream &os) const {
+  os.write(trace_magic, sizeof(trace_magic));
+  write_u32(os, trace_version);
+  write_u32(os, Record::size);
+  write_strings(os, statuses);
+  write_strings(os, controls);
+}
+
+Header Header::read(std::istream &is) {
+  char magic[sizeof(trace_magic)];
+  if (!is.read(magic, sizeof(magic)) ||
+      !std::equal(std::begin(trace_magic), std::end(trace_magic), magic)) {
+    throw std::runtime_error("not a trace");
+  }
+  if (read_u32(is) != trace_version || read_u32(is) != Record::size) {
+    throw std::runtime_error("unsupported trace version");
+  }
+  Header header;
+  header.statuses =
+      read_strings(is, components::controller::StatusEncoder::max_statuses);
+  header.controls = read_strings(is, 64);
+  return header;
+}
+
+std::string Header::describe(const Record &record) const {
+  std::vector<std::string> status_strings;
+  for (size_t index = 0; index < statuses.size(); ++index) {
+    status_strings.push_back(
+        statuses[index] + "=" +
+        std::to_string((record.encoded_statuses >> index) & 1));
+  }
+  std::vector<std::string> control_strings;
+  for (size_t index = 0; index < 64; ++index) {
+    if ((record.encoded_controls & (1ull << index)) == 0) {
+      continue;
+    }
+    control_strings.push_back(index < controls.size()
+                                  ? controls[index]
+                                  : "<control " + std::to_string(index) + ">");
+  }
+  std::ostringstream os;
+  os << "tick " << record.tick << ": opcode=" << hex(record.opcode)
+     << " step_counter=" << hex(record.step_counter) << " statuses=["
+     << common::strings::join(status_strings, ", ") << "] controls=["
+     << common::strings::join(control_strings, ", ") << "] data_bus="
+     << (record.data_bus ? hex(*record.data_bus) : "-")
+     << " address_bus=" << (record.address_bus ? hex(*record.address_bus) : "-");
+  return os.str();
+}
+
+bool Header::operator==(const Header &other) const {
+  return statuses == other.statuses && controls == other.controls;
+}
+
+bool Header::operator!=(const Header &other) const {
+  return !(*this == other);
+}
+
+Reader::Reader(std::istream &is) : is_(is), header_(Header::read(is)) {}
+
+const Header &Reader::header() const { return header_; }
+
+std::optional<Record> Reader::next() {
+  std::array<uint8_t, Record::size> bytes;
+  is_.read(reinterpret_cast<char *>(bytes.data()), bytes.size());
+  if (is_.gcount() == 0) {
+    return std::nullopt;
+  }
+  if (static_cast<size_t>(is_.gcount()) != bytes.size()) {
+    throw std::runtime_error("trace is truncated");
+  }
+  return Record::decode(bytes);
+}
+
+std::vector<Record> Reader::read_all() {
+  std::vector<Record> records;
+  while (auto record = next()) {
+    records.push_back(*record);
+  }
+  return records;
+}
+
+} // namespace irata::sim::trace
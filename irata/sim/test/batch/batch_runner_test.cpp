@@ -0,0 +1,152 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <irata/asm/instruction_set.hpp>
+#include <irata/sim/batch/batch_runner.hpp>
+#include <irata/sim/components/memory/rom.hpp>
+#include <sstream>
+
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::Not;
+
+namespace irata::sim::batch {
+
+namespace {
+
+uint8_t opcode(std::string_view name,
+               asm_::AddressingMode mode = asm_::AddressingMode::None) {
+  return asm_::InstructionSet::irata()
+      .get_instruction(name, mode)
+      .opcode()
+      .unsigned_value();
+}
+
+BatchRunner::Job job(std::string name, std::vector<uint8_t> cartridge) {
+  return {std::move(name),
+          std::make_shared<components::memory::ROM>(0x100, std::move(cartridge),
+                                                    "cartridge")};
+}
+
+BatchRunner::Job halt_job(std::string name) {
+  return job(std::move(name), {opcode("hlt")});
+}
+
+BatchRunner::Job crash_job(std::string name) {
+  return job(std::move(name), {opcode("crs")});
+}
+
+// Counts x down from the given value before halting, so that jobs take
+// different amounts of time.
+BatchRunner::Job countdown_job(std::string name, uint8_t count) {
+  return job(std::move(name),
+             {
+                 opcode("ldx", asm_::AddressingMode::Immediate), count, //
+                 opcode("dex"), // 0x8002
+                 opcode("txa"), //
+                 opcode("cmp", asm_::AddressingMode::Immediate), 0x00,      //
+                 opcode("jne", asm_::AddressingMode::Absolute), 0x80, 0x02, //
+                 opcode("hlt"),                                             //
+             });
+}
+
+BatchRunner::Job loop_job(std::string name) {
+  return job(std::move(name),
+             {opcode("jmp", asm_::AddressingMode::Absolute), 0x80, 0x00});
+}
+
+} // namespace
+
+TEST(BatchRunnerTest, DefaultNumThreads) {
+  EXPECT_GE(BatchRunner().num_threads(), 1);
+  EXPECT_EQ(BatchRunner(3).num_threads(), 3);
+}
+
+TEST(BatchRunnerTest, RunJobHalt) {
+  const auto result = BatchRunner().run_job(halt_job("halt"));
+  EXPECT_EQ(result.name, "halt");
+  EXPECT_EQ(result.result, components::Irata::Result::Halt);
+  EXPECT_THAT(result.error, IsEmpty());
+  EXPECT_GT(result.ticks, 0);
+}
+
+TEST(BatchRunnerTest, RunJobCrash) {
+  const auto result = BatchRunner().run_job(crash_job("crash"));
+  EXPECT_EQ(result.result, components::Irata::Result::Crash);
+  EXPECT_THAT(result.error, IsEmpty());
+}
+
+TEST(BatchRunnerTest, RunJobMaxTicks) {
+  const auto result = BatchRunner(1, 100).run_job(loop_job("loop"));
+  EXPECT_EQ(result.result, std::nullopt);
+  EXPECT_THAT(result.error, HasSubstr("max ticks"));
+  EXPECT_EQ(result.ticks, 100);
+}
+
+TEST(BatchRunnerTest, RunJobCartridgeTooLarge) {
+  const auto result = BatchRunner().run_job(
+      {"large", std::make_shared<components::memory::ROM>(0x10000)});
+  EXPECT_EQ(result.result, std::nullopt);
+  EXPECT_THAT(result.error, Not(IsEmpty()));
+  EXPECT_EQ(result.ticks, 0);
+}
+
+TEST(BatchRunnerTest, RunEmpty) {
+  const auto report = BatchRunner(4).run({});
+  EXPECT_THAT(report.results, IsEmpty());
+  EXPECT_EQ(report.total_ticks(), 0);
+  EXPECT_EQ(report.num_halted(), 0);
+}
+
+TEST(BatchRunnerTest, RunKeepsJobOrder) {
+  const auto report = BatchRunner(2, 1000).run(
+      {halt_job("a"), crash_job("b"), loop_job("c"), countdown_job("d", 3)});
+  ASSERT_EQ(report.results.size(), 4);
+  EXPECT_EQ(report.results[0].name, "a");
+  EXPECT_EQ(report.results[0].result, components::Irata::Result::Halt);
+  EXPECT_EQ(report.results[1].name, "b");
+  EXPECT_EQ(report.results[1].result, components::Irata::Result::Crash);
+  EXPECT_EQ(report.results[2].name, "c");
+  EXPECT_EQ(report.results[2].result, std::nullopt);
+  EXPECT_EQ(report.results[3].name, "d");
+  EXPECT_EQ(report.results[3].result, components::Irata::Result::Halt);
+  EXPECT_EQ(report.num_halted(), 2);
+}
+
+TEST(BatchRunnerTest, RunManyJobs) {
+  std::vector<BatchRunner::Job> jobs;
+  for (int i = 0; i < 32; ++i) {
+    jobs.push_back(countdown_job("job" + std::to_string(i), i % 8 + 1));
+  }
+  const auto report = BatchRunner(4).run(jobs);
+  EXPECT_EQ(report.num_threads, 4);
+  ASSERT_EQ(report.results.size(), jobs.size());
+  EXPECT_EQ(report.num_halted(), jobs.size());
+  uint64_t total_ticks = 0;
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    EXPECT_EQ(report.results[i].name, jobs[i].name);
+    // Every machine is deterministic, so a job takes the same number of ticks
+    // whichever thread runs it.
+    EXPECT_EQ(report.results[i].ticks, BatchRunner().run_job(jobs[i]).ticks);
+    total_ticks += report.results[i].ticks;
+  }
+  EXPECT_EQ(report.total_ticks(), total_ticks);
+}
+
+TEST(BatchRunnerTest, RunUsesNoMoreThreadsThanJobs) {
+  EXPECT_EQ(BatchRunner(8).run({halt_job("a"), halt_job("b")}).num_threads,
+            2);
+}
+
+TEST(BatchRunnerTest, Report) {
+  const auto report = BatchRunner(1, 100).run(
+      {halt_job("a"), crash_job("b"), loop_job("c")});
+  std::ostringstream os;
+  os << report;
+  EXPECT_THAT(os.str(), HasSubstr("a: halt"));
+  EXPECT_THAT(os.str(), HasSubstr("b: crash"));
+  EXPECT_THAT(os.str(), HasSubstr("c: error: max ticks reached"));
+  EXPECT_THAT(os.str(), HasSubstr("3 cartridges, 1 halted"));
+  EXPECT_THAT(os.str(), HasSubstr("on 1 threads"));
+}
+
+} // namespace irata::sim::batch
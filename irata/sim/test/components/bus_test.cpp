@@ -3,7 +3,8 @@
 #include <irata/sim/bytes/byte.hpp>
 #include <irata/sim/components/bus.hpp>
 
-using ::testing::Optional;
+using ::testing::AllOf;
+using ::testing::HasSubstr;
 
 namespace irata::sim::components {
 
@@ -17,7 +18,7 @@ TEST(BusTest, Type) {
 TEST(BusTest, Empty) {
   Bus<Byte> bus;
   EXPECT_EQ(bus.value(), std::nullopt);
-  EXPECT_EQ(bus.setter(), std::nullopt);
+  EXPECT_EQ(bus.setter(), nullptr);
 }
 
 TEST(BusTest, Write) {
@@ -25,7 +26,7 @@ TEST(BusTest, Write) {
   Component component("component", &bus);
   bus.set_value(Byte::from_unsigned(0x12), component);
   EXPECT_EQ(bus.value(), Byte::from_unsigned(0x12));
-  EXPECT_THAT(bus.setter(), Optional(component.path()));
+  EXPECT_EQ(bus.setter(), &component);
 }
 
 TEST(BusTest, WriteConflict) {
@@ -33,8 +34,24 @@ TEST(BusTest, WriteConflict) {
   Component component1("component1", &bus);
   Component component2("component2", &bus);
   bus.set_value(Byte::from_unsigned(0x12), component1);
-  EXPECT_THROW(bus.set_value(Byte::from_unsigned(0x34), component2),
-               std::logic_error);
+  try {
+    bus.set_value(Byte::from_unsigned(0x34), component2);
+    FAIL() << "expected a write conflict";
+  } catch (const std::logic_error &e) {
+    EXPECT_THAT(e.what(), AllOf(HasSubstr(component1.path()),
+                                HasSubstr(component2.path())));
+  }
+  EXPECT_EQ(bus.value(), Byte::from_unsigned(0x12));
+  EXPECT_EQ(bus.setter(), &component1);
+}
+
+TEST(BusTest, RewriteBySameSetter) {
+  Bus<Byte> bus;
+  Component component("component", &bus);
+  bus.set_value(Byte::from_unsigned(0x12), component);
+  bus.set_value(Byte::from_unsigned(0x34), component);
+  EXPECT_EQ(bus.value(), Byte::from_unsigned(0x34));
+  EXPECT_EQ(bus.setter(), &component);
 }
 
 TEST(BusTest, ClearOnTick) {
@@ -42,10 +59,10 @@ TEST(BusTest, ClearOnTick) {
   Component component("component", &bus);
   bus.set_value(Byte::from_unsigned(0x12), component);
   EXPECT_EQ(bus.value(), Byte::from_unsigned(0x12));
-  EXPECT_THAT(bus.setter(), Optional(component.path()));
+  EXPECT_EQ(bus.setter(), &component);
   bus.tick();
   EXPECT_EQ(bus.value(), std::nullopt);
-  EXPECT_EQ(bus.setter(), std::nullopt);
+  EXPECT_EQ(bus.setter(), nullptr);
 }
 
 } // namespace irata::sim::components
\ No newline at end of file
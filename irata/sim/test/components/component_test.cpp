@@ -1,11 +1,14 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <irata/sim/components/component.hpp>
+#include <sstream>
 #include <stdexcept>
 
 using ::testing::_;
+using ::testing::ElementsAre;
 using ::testing::Invoke;
 using ::testing::IsEmpty;
+using ::testing::Optional;
 using ::testing::Pair;
 using ::testing::UnorderedElementsAre;
 
@@ -126,6 +129,19 @@ TEST(ComponentTest, GetPath) {
   EXPECT_EQ(child.path(), "/parent/child");
 }
 
+TEST(ComponentTest, RootAndPathUpdateWhenSubtreeIsAdded) {
+  Component root("root");
+  Component parent("parent");
+  Component child("child", &parent);
+  EXPECT_EQ(child.root(), &parent);
+  EXPECT_EQ(child.path(), "/child");
+  root.add_child(&parent);
+  EXPECT_EQ(parent.root(), &root);
+  EXPECT_EQ(child.root(), &root);
+  EXPECT_EQ(parent.path(), "/parent");
+  EXPECT_EQ(child.path(), "/parent/child");
+}
+
 namespace {
 class MockComponent : public Component {
 public:
@@ -135,6 +151,13 @@ public:
   MOCK_METHOD(void, tick_read, (Logger & logger), (override));
   MOCK_METHOD(void, tick_process, (Logger & logger), (override));
   MOCK_METHOD(void, tick_clear, (Logger & logger), (override));
+
+protected:
+  std::set<hdl::TickPhase> tick_phases() const override {
+    return {hdl::TickPhase::Control, hdl::TickPhase::Write,
+            hdl::TickPhase::Read, hdl::TickPhase::Process,
+            hdl::TickPhase::Clear};
+  }
 };
 } // namespace
 
@@ -270,6 +293,228 @@ TEST(ComponentTest, Log) {
                       "[Clear] /child: clear msg\n");
 }
 
+TEST(ComponentTest, TickQuiet) {
+  Component root("root");
+  MockComponent child("child");
+  root.add_child(&child);
+  const auto expect_disabled = [](auto &logger) {
+    EXPECT_FALSE(logger.enabled());
+    logger << "dropped";
+  };
+  EXPECT_CALL(child, tick_control(_)).WillOnce(expect_disabled);
+  EXPECT_CALL(child, tick_write(_)).WillOnce(expect_disabled);
+  EXPECT_CALL(child, tick_read(_)).WillOnce(expect_disabled);
+  EXPECT_CALL(child, tick_process(_)).WillOnce(expect_disabled);
+  EXPECT_CALL(child, tick_clear(_)).WillOnce(expect_disabled);
+  ::testing::internal::CaptureStderr();
+  root.tick_quiet();
+  EXPECT_EQ(::testing::internal::GetCapturedStderr(), "");
+}
+
+TEST(ComponentTest, TickLoggerIsEnabled) {
+  MockComponent root("root");
+  std::ostringstream os;
+  EXPECT_CALL(root, tick_control(_)).WillOnce([](auto &logger) {
+    EXPECT_TRUE(logger.enabled());
+  });
+  EXPECT_CALL(root, tick_write(_));
+  EXPECT_CALL(root, tick_read(_));
+  EXPECT_CALL(root, tick_process(_));
+  EXPECT_CALL(root, tick_clear(_));
+  root.tick(os);
+  EXPECT_EQ(os.str(), "");
+}
+
+namespace {
+
+// A component that only implements the process phase.
+class ProcessComponent : public Component {
+public:
+  explicit ProcessComponent(std::string_view name, Component *parent = nullptr)
+      : Component(name, parent) {}
+
+  int process_count = 0;
+
+protected:
+  std::set<hdl::TickPhase> tick_phases() const override {
+    return {hdl::TickPhase::Process};
+  }
+
+  void tick_process(Logger &logger) override { ++process_count; }
+};
+
+// A process component whose handler also calls its base class's handler.
+class CallsBaseProcessComponent : public ProcessComponent {
+public:
+  using ProcessComponent::ProcessComponent;
+
+protected:
+  void tick_process(Logger &logger) override {
+    Component::tick_process(logger);
+    ProcessComponent::tick_process(logger);
+  }
+};
+
+// A process component that also handles the read phase, but doesn't declare
+// it.
+class UndeclaredReadComponent : public ProcessComponent {
+public:
+  using ProcessComponent::ProcessComponent;
+
+  int read_count = 0;
+
+protected:
+  void tick_read(Logger &logger) override { ++read_count; }
+};
+
+} // namespace
+
+namespace {
+
+// A component that records the tree's tick phase during its read phase.
+class TreeTickPhaseComponent : public Component {
+public:
+  explicit TreeTickPhaseComponent(std::string_view name,
+                                  Component *parent = nullptr)
+      : Component(name, parent) {}
+
+  std::optional<hdl::TickPhase> tick_phase_during_read() const {
+    return tick_phase_during_read_;
+  }
+  std::optional<hdl::TickPhase> tick_phase() const { return tree_tick_phase(); }
+
+protected:
+  std::set<hdl::TickPhase> tick_phases() const override {
+    return {hdl::TickPhase::Read};
+  }
+
+  void tick_read(Logger &logger) override {
+    tick_phase_during_read_ = tree_tick_phase();
+  }
+
+private:
+  std::optional<hdl::TickPhase> tick_phase_during_read_;
+};
+
+} // namespace
+
+TEST(ComponentTest, ActiveTickPhaseForUnscheduledParent) {
+  Component root("root");
+  Component parent("parent", &root);
+  MockComponent child("child");
+  parent.add_child(&child);
+  const ::testing::InSequence s;
+  EXPECT_CALL(child, tick_control(_)).WillOnce(Invoke([&](auto &) {
+    EXPECT_EQ(parent.active_tick_phase(), hdl::TickPhase::Control);
+  }));
+  EXPECT_CALL(child, tick_write(_)).WillOnce(Invoke([&](auto &) {
+    EXPECT_EQ(parent.active_tick_phase(), hdl::TickPhase::Write);
+  }));
+  EXPECT_CALL(child, tick_read(_)).WillOnce(Invoke([&](auto &) {
+    EXPECT_EQ(parent.active_tick_phase(), hdl::TickPhase::Read);
+  }));
+  EXPECT_CALL(child, tick_process(_)).WillOnce(Invoke([&](auto &) {
+    EXPECT_EQ(parent.active_tick_phase(), hdl::TickPhase::Process);
+  }));
+  EXPECT_CALL(child, tick_clear(_)).WillOnce(Invoke([&](auto &) {
+    EXPECT_EQ(parent.active_tick_phase(), hdl::TickPhase::Clear);
+  }));
+  root.tick();
+  EXPECT_EQ(parent.active_tick_phase(), std::nullopt);
+}
+
+TEST(ComponentTest, TreeTickPhase) {
+  Component root("root");
+  Component parent("parent", &root);
+  TreeTickPhaseComponent child("child", &parent);
+  for (int i = 0; i < 2; ++i) {
+    root.tick();
+    EXPECT_EQ(child.tick_phase_during_read(), hdl::TickPhase::Read);
+    EXPECT_EQ(child.tick_phase(), std::nullopt);
+  }
+}
+
+TEST(ComponentTest, TickScheduleIsRecordedOnFirstTick) {
+  Component root("root");
+  ProcessComponent child("child", &root);
+  EXPECT_EQ(root.tick_schedule(hdl::TickPhase::Process), std::nullopt);
+  root.tick();
+  EXPECT_THAT(root.tick_schedule(hdl::TickPhase::Control),
+              Optional(IsEmpty()));
+  EXPECT_THAT(root.tick_schedule(hdl::TickPhase::Process),
+              Optional(ElementsAre(&child)));
+  EXPECT_EQ(child.tick_schedule(hdl::TickPhase::Process),
+            root.tick_schedule(hdl::TickPhase::Process));
+}
+
+TEST(ComponentTest, TickScheduleIsInTraversalOrder) {
+  ProcessComponent root("root");
+  ProcessComponent b("b", &root);
+  ProcessComponent a("a", &root);
+  ProcessComponent a_child("a_child", &a);
+  root.tick();
+  EXPECT_THAT(root.tick_schedule(hdl::TickPhase::Process),
+              Optional(ElementsAre(&root, &a, &a_child, &b)));
+}
+
+TEST(ComponentTest, HandlerCallingBaseHandlerIsScheduled) {
+  Component root("root");
+  CallsBaseProcessComponent child("child", &root);
+  root.tick();
+  root.tick();
+  EXPECT_EQ(child.process_count, 2);
+  EXPECT_THAT(root.tick_schedule(hdl::TickPhase::Process),
+              Optional(ElementsAre(&child)));
+}
+
+TEST(ComponentTest, UndeclaredHandler) {
+  Component root("root");
+  Component parent("parent", &root);
+  UndeclaredReadComponent child("child", &parent);
+  EXPECT_THROW(root.tick(), std::logic_error);
+  EXPECT_EQ(root.tick_schedule(hdl::TickPhase::Read), std::nullopt);
+  EXPECT_EQ(root.active_tick_phase(), std::nullopt);
+  EXPECT_THROW(root.tick(), std::logic_error);
+}
+
+TEST(ComponentTest, ScheduledTickCallsTickPhases) {
+  Component root("root");
+  MockComponent child("child");
+  root.add_child(&child);
+  const ::testing::InSequence s;
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_CALL(child, tick_control(_)).WillOnce(Invoke([&](auto &) {
+      EXPECT_EQ(root.active_tick_phase(), hdl::TickPhase::Control);
+      EXPECT_EQ(child.active_tick_phase(), hdl::TickPhase::Control);
+    }));
+    EXPECT_CALL(child, tick_write(_));
+    EXPECT_CALL(child, tick_read(_));
+    EXPECT_CALL(child, tick_process(_));
+    EXPECT_CALL(child, tick_clear(_)).WillOnce(Invoke([&](auto &) {
+      EXPECT_EQ(root.active_tick_phase(), hdl::TickPhase::Clear);
+      EXPECT_EQ(child.active_tick_phase(), hdl::TickPhase::Clear);
+    }));
+  }
+  root.tick();
+  root.tick();
+  EXPECT_EQ(root.active_tick_phase(), std::nullopt);
+  EXPECT_EQ(child.active_tick_phase(), std::nullopt);
+}
+
+TEST(ComponentTest, AddChildDiscardsTickSchedule) {
+  Component root("root");
+  ProcessComponent child1("child1", &root);
+  root.tick();
+  ASSERT_NE(root.tick_schedule(hdl::TickPhase::Process), std::nullopt);
+  ProcessComponent child2("child2", &child1);
+  EXPECT_EQ(root.tick_schedule(hdl::TickPhase::Process), std::nullopt);
+  root.tick();
+  EXPECT_EQ(child1.process_count, 2);
+  EXPECT_EQ(child2.process_count, 1);
+  EXPECT_THAT(root.tick_schedule(hdl::TickPhase::Process),
+              Optional(ElementsAre(&child1, &child2)));
+}
+
 namespace {
 
 class ComponentWithSerializedProperty : public Component {
@@ -296,6 +541,135 @@ private:
 
 } // namespace
 
+namespace {
+
+class ComponentWithState : public Component {
+public:
+  explicit ComponentWithState(std::string_view name,
+                              Component *parent = nullptr)
+      : Component(name, parent) {}
+
+  bool flag = false;
+  uint8_t byte = 0;
+  std::vector<uint8_t> bytes = std::vector<uint8_t>(4);
+
+protected:
+  void save_state(StateWriter &writer) const override {
+    writer.write_bool(flag);
+    writer.write_byte(byte);
+    writer.write_bytes(bytes);
+  }
+
+  void load_state(StateReader &reader) override {
+    flag = reader.read_bool();
+    byte = reader.read_byte();
+    reader.read_bytes(bytes);
+  }
+};
+
+} // namespace
+
+TEST(ComponentTest, Snapshot) {
+  Component root("root");
+  ComponentWithState child1("child1", &root);
+  ComponentWithState child2("child2", &root);
+  child1.flag = true;
+  child1.byte = 0x12;
+  child2.bytes = {1, 2, 3, 4};
+  std::stringstream snapshot;
+  root.save_snapshot(snapshot);
+
+  child1.flag = false;
+  child1.byte = 0x34;
+  child2.bytes = {5, 6, 7, 8};
+  root.load_snapshot(snapshot);
+  EXPECT_TRUE(child1.flag);
+  EXPECT_EQ(child1.byte, 0x12);
+  EXPECT_THAT(child1.bytes, ElementsAre(0, 0, 0, 0));
+  EXPECT_FALSE(child2.flag);
+  EXPECT_EQ(child2.byte, 0x00);
+  EXPECT_THAT(child2.bytes, ElementsAre(1, 2, 3, 4));
+}
+
+TEST(ComponentTest, SnapshotFromChild) {
+  Component root("root");
+  ComponentWithState child("child", &root);
+  child.byte = 0x12;
+  std::stringstream snapshot;
+  // A snapshot always covers the whole tree.
+  child.save_snapshot(snapshot);
+  child.byte = 0x34;
+  root.load_snapshot(snapshot);
+  EXPECT_EQ(child.byte, 0x12);
+}
+
+TEST(ComponentTest, SnapshotIntoAnotherTree) {
+  Component root1("root");
+  ComponentWithState child1("child", &root1);
+  child1.byte = 0x12;
+  std::stringstream snapshot;
+  root1.save_snapshot(snapshot);
+
+  Component root2("root");
+  ComponentWithState child2("child", &root2);
+  root2.load_snapshot(snapshot);
+  EXPECT_EQ(child2.byte, 0x12);
+}
+
+TEST(ComponentTest, SnapshotIntoDifferentTree) {
+  Component root1("root");
+  ComponentWithState child1("child1", &root1);
+  std::stringstream snapshot;
+  root1.save_snapshot(snapshot);
+
+  Component root2("root");
+  ComponentWithState child2("child2", &root2);
+  child2.byte = 0x34;
+  EXPECT_THROW(root2.load_snapshot(snapshot), std::invalid_argument);
+  EXPECT_EQ(child2.byte, 0x34);
+}
+
+TEST(ComponentTest, LoadMalformedSnapshot) {
+  Component root("root");
+  ComponentWithState child("child", &root);
+  std::stringstream snapshot;
+  root.save_snapshot(snapshot);
+  const std::string data = snapshot.str();
+
+  std::istringstream not_a_snapshot("not a snapshot");
+  EXPECT_THROW(root.load_snapshot(not_a_snapshot), std::runtime_error);
+  std::istringstream truncated(data.substr(0, data.size() - 1));
+  EXPECT_THROW(root.load_snapshot(truncated), std::runtime_error);
+}
+
+TEST(ComponentTest, LoadMalformedSnapshotLeavesTreeUnchanged) {
+  Component root("root");
+  ComponentWithState child1("child1", &root);
+  ComponentWithState child2("child2", &root);
+  child1.byte = 0x12;
+  std::stringstream snapshot;
+  root.save_snapshot(snapshot);
+  // Each child writes a bool, a byte and a 4 byte buffer with a 4 byte length,
+  // so the payload is 20 bytes and child2's bool is its tenth from the end.
+  std::string data = snapshot.str();
+  const size_t child2_flag = data.size() - 10;
+  ASSERT_EQ(data[child2_flag], 0);
+
+  child1.byte = 0x34;
+  data[child2_flag] = 2;
+  std::istringstream bad_bool(data);
+  EXPECT_THROW(root.load_snapshot(bad_bool), std::runtime_error);
+  EXPECT_EQ(child1.byte, 0x34);
+
+  // Drop the last byte of child2's buffer, and of the payload's length.
+  data = snapshot.str();
+  data.pop_back();
+  --data[data.size() - 23];
+  std::istringstream truncated(data);
+  EXPECT_THROW(root.load_snapshot(truncated), std::runtime_error);
+  EXPECT_EQ(child1.byte, 0x34);
+}
+
 TEST(ComponentTest, Serialize) {
   Component root("root");
   Component parent("parent", &root);
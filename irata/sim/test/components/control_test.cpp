@@ -469,6 +469,39 @@ TEST(ControlTest, ManualClear) {
   EXPECT_THAT(control.clear(), Optional(false));
 }
 
+namespace {
+
+// A component that reads a control during its write phase.
+class WriteComponent : public Component {
+public:
+  WriteComponent(std::string_view name, const Control &control,
+                 Component *parent)
+      : Component(name, parent), control_(control) {}
+
+protected:
+  std::set<hdl::TickPhase> tick_phases() const override {
+    return {hdl::TickPhase::Write};
+  }
+
+  void tick_write(Logger &logger) override { control_.value(); }
+
+private:
+  const Control &control_;
+};
+
+} // namespace
+
+TEST(ControlTest, ReadInWrongPhase) {
+  Component root("root");
+  Control control("control", hdl::TickPhase::Process, &root);
+  WriteComponent reader("reader", control, &root);
+#ifndef IRATA_DISABLE_PHASE_CHECKS
+  EXPECT_THROW(root.tick(), std::runtime_error);
+#else
+  EXPECT_NO_THROW(root.tick());
+#endif
+}
+
 TEST(ControlTest, GetControls) {
   Component root("root");
   Control control1("control1", hdl::TickPhase::Process, &root);
@@ -2,7 +2,10 @@
 #include <gtest/gtest.h>
 #include <irata/sim/components/controller/control_encoder.hpp>
 #include <irata/sim/hdl/irata_decl.hpp>
+#include <irata/sim/microcode/compiler/compiler.hpp>
+#include <stdexcept>
 
+using ::testing::ElementsAre;
 using ::testing::IsEmpty;
 using ::testing::Pair;
 using ::testing::UnorderedElementsAre;
@@ -36,6 +39,50 @@ TEST_F(ControlEncoderTest, Indices) {
               UnorderedElementsAre(Pair(&control1, 0), Pair(&control2, 1)));
 }
 
+TEST_F(ControlEncoderTest, Controls) {
+  EXPECT_THAT(encoder.controls(), UnorderedElementsAre(&control1, &control2));
+  for (const auto &[control, index] : encoder.indices()) {
+    EXPECT_EQ(encoder.controls()[index], control);
+  }
+}
+
+TEST_F(ControlEncoderTest, IndicesFollowPathOrder) {
+  // Declared in reverse path order, so that pointer order and path order
+  // disagree.
+  const hdl::ProcessControlDecl b("b", hdl::irata());
+  const hdl::ProcessControlDecl a("a", hdl::irata());
+  const microcode::table::Table table = {.entries = {{
+                                             .instruction = instruction,
+                                             .step_index = Byte(0x01),
+                                             .statuses = {},
+                                             .controls = {&b, &a},
+                                         }}};
+  const ControlEncoder encoder(table);
+  EXPECT_THAT(encoder.indices(),
+              UnorderedElementsAre(Pair(&a, 0), Pair(&b, 1)));
+  EXPECT_THAT(encoder.controls(), ElementsAre(&a, &b));
+}
+
+TEST_F(ControlEncoderTest, DuplicatePaths) {
+  const hdl::ProcessControlDecl a1("a", hdl::irata());
+  const hdl::ProcessControlDecl a2("a", hdl::irata());
+  const microcode::table::Table table = {.entries = {{
+                                             .instruction = instruction,
+                                             .step_index = Byte(0x01),
+                                             .statuses = {},
+                                             .controls = {&a1, &a2},
+                                         }}};
+  EXPECT_THROW(ControlEncoder encoder(table), std::invalid_argument);
+}
+
+TEST_F(ControlEncoderTest, IrataControlsAreInPathOrder) {
+  const ControlEncoder encoder(microcode::compiler::Compiler::irata_table());
+  ASSERT_FALSE(encoder.controls().empty());
+  for (size_t i = 1; i < encoder.controls().size(); ++i) {
+    EXPECT_LT(encoder.controls()[i - 1]->path(), encoder.controls()[i]->path());
+  }
+}
+
 TEST_F(ControlEncoderTest, TooManyControls) {
   std::vector<std::unique_ptr<hdl::ProcessControlDecl>> controls;
   std::set<const hdl::ControlDecl *> control_ptrs;
@@ -58,8 +105,10 @@ TEST_F(ControlEncoderTest, EncodeLotsOfControls) {
   std::vector<std::unique_ptr<hdl::ProcessControlDecl>> controls;
   std::set<const hdl::ControlDecl *> control_ptrs;
   for (size_t i = 0; i < 64; ++i) {
+    // Bits are assigned in path order, so pad the index to keep path order
+    // and creation order the same.
     auto control = std::make_unique<hdl::ProcessControlDecl>(
-        "control" + std::to_string(i), hdl::irata());
+        (i < 10 ? "control0" : "control") + std::to_string(i), hdl::irata());
     control_ptrs.insert(control.get());
     controls.push_back(std::move(control));
   }
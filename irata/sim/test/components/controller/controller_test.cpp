@@ -72,6 +72,45 @@ TEST_F(ControllerTest, Irata) {
   EXPECT_NO_THROW(Controller::irata(bus, "irata_controller", &root));
 }
 
+TEST_F(ControllerTest, IrataControllersShareMicrocode) {
+  const auto controller1 = Controller::irata(bus, "controller1", &root);
+  const auto controller2 = Controller::irata(bus, "controller2", &root);
+  EXPECT_EQ(&controller1.instruction_memory().steps(),
+            &controller2.instruction_memory().steps());
+  EXPECT_EQ(&controller1.instruction_memory().steps(),
+            &Controller::irata_microcode()->steps);
+}
+
+TEST_F(ControllerTest, Bind) {
+  EXPECT_FALSE(controller.bound());
+  controller.bind();
+  EXPECT_TRUE(controller.bound());
+}
+
+TEST_F(ControllerTest, BindOnFirstTick) {
+  EXPECT_FALSE(controller.bound());
+  controller.tick();
+  EXPECT_TRUE(controller.bound());
+}
+
+TEST_F(ControllerTest, BindMissingStatus) {
+  Component other_root("other_root");
+  Bus<Byte> other_bus("bus", &other_root);
+  Controller other_controller(table, other_bus, "controller", &other_root);
+  EXPECT_THROW(other_controller.bind(), std::invalid_argument);
+}
+
+TEST_F(ControllerTest, MissingControlIsOnlyReportedWhenAsserted) {
+  Component other_root("other_root");
+  Bus<Byte> other_bus("bus", &other_root);
+  Controller other_controller(table, other_bus, "controller", &other_root);
+  Status other_status1("status1", &other_root);
+  EXPECT_NO_THROW(other_controller.bind());
+  other_controller.set_opcode(Byte(0x10));
+  other_controller.set_step_counter(Byte(0x00));
+  EXPECT_THROW(other_controller.tick(), std::invalid_argument);
+}
+
 TEST_F(ControllerTest, UnknownOpcode) {
   EXPECT_FALSE(control1.value());
   EXPECT_FALSE(control2.value());
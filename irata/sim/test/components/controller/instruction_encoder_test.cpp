@@ -49,7 +49,8 @@ protected:
 
 TEST_F(InstructionEncoderTest, TooManyAddressBits) {
   // 8 opcode bits, 1 status bit, 8 step index bits = 17 bits
-  // This is too many bits to encode in a 16-bit address.
+  // This is too many bits to encode in a flat 16-bit address, but the table
+  // can still be encoded.
   const microcode::table::Entry entry = {
       .instruction = asm_::Instruction("instruction", Byte(0xFF),
                                        asm_::AddressingMode::Immediate, ""),
@@ -57,7 +58,10 @@ TEST_F(InstructionEncoderTest, TooManyAddressBits) {
       .statuses = {{&status1, false}},
   };
   const microcode::table::Table table = {{entry}};
-  EXPECT_THROW((InstructionEncoder(table)), std::invalid_argument);
+  const InstructionEncoder encoder(table);
+  EXPECT_EQ(encoder.num_address_bits(), 17);
+  EXPECT_NO_THROW(encoder.check_bounds(0xFF, 0xFF));
+  EXPECT_THROW(encoder.encode_address(entry), std::invalid_argument);
 }
 
 TEST_F(InstructionEncoderTest, num_statuses) {
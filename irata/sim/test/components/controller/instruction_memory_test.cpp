@@ -116,6 +116,203 @@ TEST_F(InstructionMemoryTest, ReadByInstruction) {
               UnorderedElementsAre(&control2));
 }
 
+TEST_F(InstructionMemoryTest, ReadEncoded) {
+  const auto &encoder = instruction_memory.encoder();
+  const auto status_true =
+      encoder.status_encoder().encode(complete({{&status1, true}}));
+  const auto status_false =
+      encoder.status_encoder().encode(complete({{&status1, false}}));
+  EXPECT_EQ(instruction_memory.read_encoded(0x10, status_true, 0x00),
+            encoder.encode_value({&control1}));
+  EXPECT_EQ(instruction_memory.read_encoded(0x10, status_false, 0x01),
+            encoder.encode_value({&control2}));
+  EXPECT_EQ(instruction_memory.read_encoded(0x20, status_true, 0x00),
+            encoder.encode_value({&control1}));
+  EXPECT_EQ(instruction_memory.read_encoded(0x20, status_false, 0x00),
+            encoder.encode_value({&control2}));
+}
+
+TEST_F(InstructionMemoryTest, OnlyBranchingOpcodesHaveStatusBlocks) {
+  const auto &headers = instruction_memory.headers();
+  ASSERT_EQ(headers.size(), 0x21);
+  // instruction1 doesn't branch, so it has a single block of two steps.
+  EXPECT_EQ(headers[0x10].offset, 0);
+  EXPECT_EQ(headers[0x10].status_mask, 0);
+  EXPECT_EQ(headers[0x10].num_steps, 2);
+  // instruction2 branches on status1, so it has a block of one step for each
+  // value of status1.
+  EXPECT_EQ(headers[0x20].offset, 2);
+  EXPECT_EQ(headers[0x20].status_mask,
+            1 << instruction_memory.encoder().status_encoder().indices().at(
+                &status1));
+  EXPECT_EQ(headers[0x20].num_steps, 1);
+  EXPECT_EQ(headers[0x00].num_steps, 0);
+  EXPECT_EQ(instruction_memory.steps().size(), 4);
+}
+
+TEST_F(InstructionMemoryTest, UnprogrammedStepsReadAsZero) {
+  EXPECT_EQ(instruction_memory.read_encoded(0x00, 0, 0x00), 0);
+  EXPECT_EQ(instruction_memory.read_encoded(0x20, 0, 0x01), 0);
+  EXPECT_EQ(instruction_memory.read(0xFFFF), 0);
+}
+
+TEST_F(InstructionMemoryTest, OutOfBoundsReadThrows) {
+  EXPECT_THROW(instruction_memory.read_encoded(0xFF, 0, 0x00),
+               std::invalid_argument);
+  EXPECT_THROW(instruction_memory.read_encoded(0x10, 0, 0xFF),
+               std::invalid_argument);
+}
+
+TEST_F(InstructionMemoryTest, ReadByFlatAddress) {
+  const auto &encoder = instruction_memory.encoder();
+  for (const auto &entry : table.entries) {
+    for (const auto &address : encoder.encode_address(entry)) {
+      EXPECT_EQ(instruction_memory.read(address), encoder.encode_value(entry));
+    }
+  }
+}
+
+TEST_F(InstructionMemoryTest, MoreThanEightStatuses) {
+  // Every instruction branches on a different status, and the last one
+  // branches on the highest status bit.
+  std::vector<std::unique_ptr<hdl::StatusDecl>> statuses;
+  std::vector<asm_::Instruction> instructions;
+  std::set<microcode::table::Entry> entries;
+  for (size_t i = 0; i < StatusEncoder::max_statuses; ++i) {
+    statuses.push_back(std::make_unique<hdl::StatusDecl>(
+        "status" + std::to_string(i), hdl::irata()));
+    instructions.emplace_back("instruction", Byte(i),
+                              asm_::AddressingMode::Immediate, "");
+  }
+  for (size_t i = 0; i < StatusEncoder::max_statuses; ++i) {
+    for (const bool status : {false, true}) {
+      entries.insert({
+          .instruction = instructions[i],
+          .step_index = Byte(0x00),
+          .statuses = {{statuses[i].get(), status}},
+          .controls = {status ? &control1 : &control2},
+      });
+    }
+  }
+  const microcode::table::Table wide_table = {entries};
+  const InstructionMemory wide_memory(wide_table);
+  const auto &status_encoder = wide_memory.encoder().status_encoder();
+  ASSERT_EQ(status_encoder.num_statuses(), StatusEncoder::max_statuses);
+  const auto *last_status = status_encoder.statuses_by_index().back();
+  const auto &last_instruction =
+      instructions[std::find_if(statuses.begin(), statuses.end(),
+                                [&](const auto &status) {
+                                  return status.get() == last_status;
+                                }) -
+                   statuses.begin()];
+  const uint32_t last_bit = uint32_t(1) << (StatusEncoder::max_statuses - 1);
+  EXPECT_EQ(
+      wide_memory.headers()[last_instruction.opcode().unsigned_value()]
+          .status_mask,
+      last_bit);
+  EXPECT_EQ(wide_memory.read_encoded(last_instruction.opcode().unsigned_value(),
+                                     last_bit, 0x00),
+            wide_memory.encoder().encode_value({&control1}));
+  EXPECT_EQ(wide_memory.read_encoded(last_instruction.opcode().unsigned_value(),
+                                     ~last_bit, 0x00),
+            wide_memory.encoder().encode_value({&control2}));
+}
+
+TEST_F(InstructionMemoryTest, MoreThanSixteenAddressBits) {
+  // 8 opcode bits, 1 status bit and 8 step index bits don't fit in a flat
+  // 16-bit address, but only the branching opcode needs a step per status.
+  const asm_::Instruction instruction3 = asm_::Instruction(
+      "instruction3", Byte(0xFF), asm_::AddressingMode::Immediate, "");
+  std::set<microcode::table::Entry> entries = table.entries;
+  entries.insert({
+      .instruction = instruction3,
+      .step_index = Byte(0xFF),
+      .controls = {&control2},
+  });
+  const microcode::table::Table large_table = {entries};
+  const InstructionMemory large_memory(large_table);
+  const auto &encoder = large_memory.encoder();
+  EXPECT_EQ(encoder.num_address_bits(), 17);
+  EXPECT_EQ(large_memory.steps().size(), 2 + 2 + 0x100);
+  for (const bool status : {false, true}) {
+    const auto encoded_statuses =
+        encoder.status_encoder().encode(complete({{&status1, status}}));
+    EXPECT_EQ(large_memory.read_encoded(0xFF, encoded_statuses, 0xFF),
+              encoder.encode_value({&control2}));
+    EXPECT_EQ(large_memory.read_encoded(0x20, encoded_statuses, 0x00),
+              encoder.encode_value({status ? &control1 : &control2}));
+  }
+}
+
+TEST_F(InstructionMemoryTest, ReadByFlatAddressWithTooManyAddressBits) {
+  std::set<microcode::table::Entry> entries = table.entries;
+  entries.insert({
+      .instruction = asm_::Instruction("instruction3", Byte(0xFF),
+                                       asm_::AddressingMode::Immediate, ""),
+      .step_index = Byte(0xFF),
+      .controls = {&control2},
+  });
+  const microcode::table::Table large_table = {entries};
+  const InstructionMemory large_memory(large_table);
+  ASSERT_EQ(large_memory.encoder().num_address_bits(), 17);
+  EXPECT_THROW(large_memory.read(0x0000), std::invalid_argument);
+}
+
+TEST_F(InstructionMemoryTest, RomsMatchSteps) {
+  const auto &steps = instruction_memory.steps();
+  for (size_t index = 0; index < steps.size(); ++index) {
+    uint64_t value = 0;
+    for (size_t rom_index = 0; rom_index < 8; ++rom_index) {
+      const uint64_t rom_value =
+          instruction_memory.roms()[rom_index].read(Word(index));
+      value |= rom_value << (8 * rom_index);
+    }
+    EXPECT_EQ(value, steps[index]);
+    EXPECT_EQ(instruction_memory.read_roms(index), steps[index]);
+  }
+  EXPECT_THROW(instruction_memory.read_roms(steps.size()), std::out_of_range);
+}
+
+TEST_F(InstructionMemoryTest, RomsHoldMoreThanSixteenBitsOfSteps) {
+  // Every opcode has 0x100 steps, and one branches on a status, which gives
+  // more steps than a Word can address.
+  std::set<microcode::table::Entry> entries;
+  for (size_t opcode = 0; opcode <= 0xFF; ++opcode) {
+    const asm_::Instruction instruction(
+        "instruction", Byte(opcode), asm_::AddressingMode::Immediate, "");
+    for (size_t step_index = 0; step_index <= 0xFF; ++step_index) {
+      if (opcode == 0xFF) {
+        for (const bool status : {false, true}) {
+          entries.insert({
+              .instruction = instruction,
+              .step_index = Byte(step_index),
+              .statuses = {{&status1, status}},
+              .controls = {status ? &control1 : &control2},
+          });
+        }
+      } else {
+        entries.insert({
+            .instruction = instruction,
+            .step_index = Byte(step_index),
+            .controls = {&control1},
+        });
+      }
+    }
+  }
+  const microcode::table::Table large_table = {entries};
+  const InstructionMemory large_memory(large_table);
+  EXPECT_EQ(large_memory.steps().size(), 0xFF * 0x100 + 2 * 0x100);
+  for (const auto &rom : large_memory.roms()) {
+    EXPECT_EQ(rom.size(), 0x20000);
+  }
+  // The last opcode's blocks are past what a Word can address.
+  const auto &steps = large_memory.steps();
+  for (size_t index = 0xFF * 0x100; index < steps.size(); ++index) {
+    EXPECT_EQ(large_memory.read_roms(index), steps[index]);
+  }
+  EXPECT_NE(large_memory.read_roms(steps.size() - 1), 0);
+}
+
 TEST_F(InstructionMemoryTest, CmpHasAluOpcode1) {
   const auto &cmp = asm_::InstructionSet::irata().get_instruction(
       "cmp", asm_::AddressingMode::Immediate);
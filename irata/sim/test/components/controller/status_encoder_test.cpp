@@ -44,7 +44,7 @@ protected:
 TEST_F(StatusEncoderTest, TooManyStatuses) {
   std::vector<std::unique_ptr<hdl::StatusDecl>> statuses;
   std::set<microcode::table::Entry> entries;
-  for (size_t i = 0; i < 9; ++i) {
+  for (size_t i = 0; i <= StatusEncoder::max_statuses; ++i) {
     auto status = std::make_unique<hdl::StatusDecl>(
         "status" + std::to_string(i), hdl::irata());
     entries.insert({
@@ -65,6 +65,29 @@ TEST_F(StatusEncoderTest, Statuses) {
   EXPECT_THAT(encoder.statuses(), UnorderedElementsAre(&status1, &status2));
 }
 
+TEST_F(StatusEncoderTest, StatusesByIndex) {
+  EXPECT_THAT(encoder.statuses_by_index(), ElementsAre(&status1, &status2));
+}
+
+TEST_F(StatusEncoderTest, IndicesFollowPathOrder) {
+  // Declared in reverse path order, so that pointer order and path order
+  // disagree.
+  const hdl::StatusDecl b("b", hdl::irata());
+  const hdl::StatusDecl a("a", hdl::irata());
+  const microcode::table::Table table = {.entries = {{
+                                             .instruction = instruction,
+                                             .step_index = Byte(0x01),
+                                             .statuses = {{&b, true},
+                                                          {&a, false}},
+                                             .controls = {},
+                                         }}};
+  const StatusEncoder encoder(table);
+  EXPECT_THAT(encoder.indices(), UnorderedElementsAre(Pair(&a, 0), Pair(&b, 1)));
+  EXPECT_THAT(encoder.statuses_by_index(), ElementsAre(&a, &b));
+  EXPECT_EQ(encoder.encode(CompleteStatuses(encoder, {{&a, false}, {&b, true}})),
+            0b10);
+}
+
 TEST_F(StatusEncoderTest, EncodeComplete) {
   EXPECT_EQ(encoder.encode(complete({{&status1, false}, {&status2, false}})),
             0b00);
@@ -1,7 +1,12 @@
+#include <algorithm>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <irata/asm/instruction_set.hpp>
 #include <irata/sim/components/irata.hpp>
+#include <irata/sim/components/memory/ram.hpp>
+#include <irata/sim/trace/recorder.hpp>
+#include <sstream>
+#include <thread>
 
 namespace irata::sim::components {
 
@@ -29,6 +34,10 @@ protected:
       "SEC", asm_::AddressingMode::None);
   const asm_::Instruction &clc = asm_::InstructionSet::irata().get_instruction(
       "CLC", asm_::AddressingMode::None);
+  const asm_::Instruction &sta = asm_::InstructionSet::irata().get_instruction(
+      "STA", asm_::AddressingMode::ZeroPage);
+  const asm_::Instruction &inx = asm_::InstructionSet::irata().get_instruction(
+      "INX", asm_::AddressingMode::None);
 };
 
 } // namespace
@@ -57,13 +66,39 @@ TEST_F(IrataTest, LoadCartridge) {
 
 TEST_F(IrataTest, TickUntilHalt) {
   auto irata = this->irata({hlt.opcode()});
+  EXPECT_EQ(irata.result(), std::nullopt);
   EXPECT_EQ(irata.tick_until_halt(), Irata::Result::Halt);
+  EXPECT_EQ(irata.result(), Irata::Result::Halt);
+  EXPECT_EQ(irata.cpu().pc().value(), Word(0x8001));
+}
+
+TEST_F(IrataTest, TickUntilHaltQuiet) {
+  auto irata = this->irata({lda.opcode(), Byte(0x12), hlt.opcode()});
+  ::testing::internal::CaptureStdout();
+  ::testing::internal::CaptureStderr();
+  const auto result = irata.tick_until_halt(-1, Irata::LogLevel::Quiet);
+  EXPECT_EQ(::testing::internal::GetCapturedStdout(), "");
+  EXPECT_EQ(::testing::internal::GetCapturedStderr(), "");
+  EXPECT_EQ(result, Irata::Result::Halt);
+  EXPECT_EQ(irata.cpu().pc().value(), Word(0x8003));
+  EXPECT_EQ(irata.cpu().a().value(), Byte(0x12));
+}
+
+TEST_F(IrataTest, TickSchedule) {
+  auto irata = this->irata({hlt.opcode()});
+  irata.tick_quiet();
+  const Component *controller = &irata.cpu().controller();
+  EXPECT_THAT(irata.tick_schedule(hdl::TickPhase::Control),
+              ::testing::Optional(::testing::ElementsAre(controller)));
+  EXPECT_EQ(irata.tick_until_halt(-1, Irata::LogLevel::Quiet),
+            Irata::Result::Halt);
   EXPECT_EQ(irata.cpu().pc().value(), Word(0x8001));
 }
 
 TEST_F(IrataTest, TickUntilCrash) {
   auto irata = this->irata({crs.opcode()});
   EXPECT_EQ(irata.tick_until_halt(), Irata::Result::Crash);
+  EXPECT_EQ(irata.result(), Irata::Result::Crash);
   EXPECT_EQ(irata.cpu().pc().value(), Word(0x8001));
 }
 
@@ -74,6 +109,81 @@ TEST_F(IrataTest, TickUntilHaltWithLda) {
   EXPECT_EQ(irata.cpu().a().value(), Byte(0x12));
 }
 
+TEST_F(IrataTest, Record) {
+  auto irata = this->irata({lda.opcode(), Byte(0x12), hlt.opcode()});
+  trace::Recorder recorder(irata.trace_header(), 1000);
+  irata.set_recorder(&recorder);
+  EXPECT_EQ(irata.recorder(), &recorder);
+  int ticks = 0;
+  while (!irata.result()) {
+    irata.tick_quiet();
+    ++ticks;
+  }
+  EXPECT_EQ(recorder.num_recorded(), ticks);
+  const auto records = recorder.records();
+  ASSERT_EQ(records.size(), ticks);
+  // The first tick reads the opcode from the start of the cartridge, which is
+  // already in the memory address register.
+  EXPECT_EQ(records[0].tick, 0);
+  EXPECT_EQ(records[0].step_counter, 0);
+  EXPECT_EQ(records[0].data_bus, lda.opcode().unsigned_value());
+  EXPECT_EQ(records[0].address_bus, std::nullopt);
+  EXPECT_NE(records[0].encoded_controls, 0);
+  EXPECT_THAT(recorder.header().describe(records[0]),
+              ::testing::HasSubstr("/cpu/controller/opcode/read"));
+  EXPECT_TRUE(std::any_of(records.begin(), records.end(), [](const auto &r) {
+    return r.address_bus == 0x8001;
+  }));
+  EXPECT_TRUE(std::any_of(records.begin(), records.end(), [](const auto &r) {
+    return r.data_bus == 0x12;
+  }));
+  EXPECT_TRUE(std::any_of(records.begin(), records.end(), [&](const auto &r) {
+    return r.opcode == lda.opcode().unsigned_value();
+  }));
+
+  irata.set_recorder(nullptr);
+  irata.tick_quiet();
+  EXPECT_EQ(recorder.num_recorded(), ticks);
+}
+
+TEST_F(IrataTest, Profile) {
+  auto irata = this->irata({
+      lda.opcode(), Byte(0x12), sta.opcode(), Byte(0x20), //
+      cmp.opcode(), Byte(0x12), hlt.opcode(),
+  });
+  profile::Profile profile;
+  irata.set_profile(&profile);
+  EXPECT_EQ(irata.profile(), &profile);
+  int ticks = 0;
+  while (!irata.result()) {
+    irata.tick_quiet();
+    ++ticks;
+  }
+  EXPECT_EQ(profile.ticks(), ticks);
+  EXPECT_EQ(profile.instructions(), 4);
+  uint64_t attributed_ticks = 0;
+  for (const auto *instruction : {&lda, &sta, &cmp, &hlt}) {
+    const auto &counts =
+        profile.opcodes()[instruction->opcode().unsigned_value()];
+    EXPECT_EQ(counts.instructions, 1) << *instruction;
+    // Each instruction takes at least its fetch and one more step.
+    EXPECT_GE(counts.ticks, 2) << *instruction;
+    attributed_ticks += counts.ticks;
+  }
+  EXPECT_EQ(attributed_ticks, ticks);
+  EXPECT_EQ(profile.regions().at("ram").writes, 1);
+  EXPECT_EQ(profile.regions().at("ram").reads, 0);
+  // Every opcode and operand is read from the cartridge.
+  EXPECT_EQ(profile.regions().at("cartridge").reads, 7);
+  EXPECT_GT(profile.bus_transfers().at("data_bus"), 0);
+  EXPECT_GT(profile.bus_transfers().at("address_bus"), 0);
+  EXPECT_EQ(profile.alu_operations().at(hdl::AluOpcode::Subtract), 1);
+
+  irata.set_profile(nullptr);
+  irata.tick_quiet();
+  EXPECT_EQ(profile.ticks(), ticks);
+}
+
 TEST_F(IrataTest, Cmp) {
   for (const auto &[cmp_value, expected_zero_status] :
        std::vector<std::pair<Byte, bool>>{
@@ -115,4 +225,123 @@ TEST_F(IrataTest, Clc) {
   EXPECT_FALSE(irata.cpu().status_register().carry_out().value());
 }
 
+TEST_F(IrataTest, Snapshot) {
+  const std::vector<Byte> program = {
+      lda.opcode(), Byte(0x12), sta.opcode(), Byte(0x20), //
+      inx.opcode(), sec.opcode(), hlt.opcode(),
+  };
+  auto irata = this->irata(program);
+  // Run partway into the program.
+  for (int i = 0; i < 6; ++i) {
+    irata.tick_quiet();
+  }
+  ASSERT_EQ(irata.result(), std::nullopt);
+  std::stringstream snapshot;
+  irata.save_snapshot(snapshot);
+  std::ostringstream before;
+  irata.serialize_all(before);
+
+  EXPECT_EQ(irata.tick_until_halt(-1, Irata::LogLevel::Quiet),
+            Irata::Result::Halt);
+  std::ostringstream halted;
+  irata.serialize_all(halted);
+  EXPECT_NE(before.str(), halted.str());
+
+  // Rewind and run the rest of the program again.
+  irata.load_snapshot(snapshot);
+  std::ostringstream restored;
+  irata.serialize_all(restored);
+  EXPECT_EQ(before.str(), restored.str());
+  EXPECT_EQ(irata.result(), std::nullopt);
+  EXPECT_EQ(irata.tick_until_halt(-1, Irata::LogLevel::Quiet),
+            Irata::Result::Halt);
+  std::ostringstream rerun;
+  irata.serialize_all(rerun);
+  EXPECT_EQ(halted.str(), rerun.str());
+  EXPECT_EQ(irata.memory().value(Word(0x0020)), Byte(0x12));
+  EXPECT_EQ(irata.cpu().x().value(), Byte(0x01));
+}
+
+TEST_F(IrataTest, SnapshotFork) {
+  const std::vector<Byte> program = {
+      lda.opcode(), Byte(0x12), sta.opcode(), Byte(0x20), hlt.opcode(),
+  };
+  auto irata = this->irata(program);
+  EXPECT_EQ(irata.tick_until_halt(-1, Irata::LogLevel::Quiet),
+            Irata::Result::Halt);
+  std::stringstream snapshot;
+  irata.save_snapshot(snapshot);
+
+  auto fork = this->irata(program);
+  fork.load_snapshot(snapshot);
+  EXPECT_EQ(fork.result(), Irata::Result::Halt);
+  EXPECT_EQ(fork.memory().value(Word(0x0020)), Byte(0x12));
+  EXPECT_EQ(fork.cpu().a().value(), Byte(0x12));
+  EXPECT_EQ(fork.cpu().pc().value(), irata.cpu().pc().value());
+  std::ostringstream irata_state, fork_state;
+  irata.serialize_all(irata_state);
+  fork.serialize_all(fork_state);
+  EXPECT_EQ(irata_state.str(), fork_state.str());
+}
+
+TEST_F(IrataTest, Fork) {
+  auto irata = this->irata({
+      lda.opcode(), Byte(0x12), sta.opcode(), Byte(0x20), //
+      inx.opcode(), sta.opcode(), Byte(0x21), hlt.opcode(),
+  });
+  // Run partway into the program.
+  for (int i = 0; i < 12; ++i) {
+    irata.tick_quiet();
+  }
+  ASSERT_EQ(irata.result(), std::nullopt);
+  const auto fork = irata.fork();
+  std::ostringstream irata_state, fork_state;
+  irata.serialize_all(irata_state);
+  fork->serialize_all(fork_state);
+  EXPECT_EQ(irata_state.str(), fork_state.str());
+
+  const auto &ram = dynamic_cast<const memory::RAM &>(
+      irata.memory().regions()[0]->module());
+  EXPECT_EQ(ram.num_shared_pages(), ram.size() / memory::RAM::page_size);
+
+  EXPECT_EQ(fork->tick_until_halt(-1, Irata::LogLevel::Quiet),
+            Irata::Result::Halt);
+  EXPECT_EQ(fork->memory().value(Word(0x0021)), Byte(0x12));
+  EXPECT_EQ(fork->cpu().x().value(), Byte(0x01));
+  // The fork's writes copied the zero page, but the original is unchanged.
+  EXPECT_EQ(ram.num_shared_pages(), ram.size() / memory::RAM::page_size - 1);
+  EXPECT_EQ(irata.result(), std::nullopt);
+  EXPECT_EQ(irata.memory().value(Word(0x0021)), Byte(0x00));
+
+  EXPECT_EQ(irata.tick_until_halt(-1, Irata::LogLevel::Quiet),
+            Irata::Result::Halt);
+  EXPECT_EQ(irata.memory().value(Word(0x0021)), Byte(0x12));
+}
+
+TEST_F(IrataTest, ForksRunConcurrently) {
+  auto irata = this->irata({
+      lda.opcode(), Byte(0x12), sta.opcode(), Byte(0x20), //
+      inx.opcode(), sta.opcode(), Byte(0x21), hlt.opcode(),
+  });
+  irata.tick_quiet();
+  std::vector<std::unique_ptr<Irata>> forks;
+  for (int i = 0; i < 4; ++i) {
+    forks.push_back(irata.fork());
+  }
+  std::vector<std::thread> threads;
+  for (auto &fork : forks) {
+    threads.emplace_back(
+        [&fork] { fork->tick_until_halt(-1, Irata::LogLevel::Quiet); });
+  }
+  irata.tick_until_halt(-1, Irata::LogLevel::Quiet);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (const auto &fork : forks) {
+    EXPECT_EQ(fork->result(), Irata::Result::Halt);
+    EXPECT_EQ(fork->memory().value(Word(0x0020)), Byte(0x12));
+    EXPECT_EQ(fork->memory().value(Word(0x0021)), Byte(0x12));
+  }
+}
+
 } // namespace irata::sim::components
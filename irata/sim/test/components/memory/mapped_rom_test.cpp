@@ -0,0 +1,144 @@
+#include <cstdio>
+#include <fstream>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <irata/asm/instruction_set.hpp>
+#include <irata/sim/components/irata.hpp>
+#include <irata/sim/components/memory/mapped_rom.hpp>
+#include <stdexcept>
+
+using ::testing::ElementsAre;
+
+namespace irata::sim::components::memory {
+
+namespace {
+
+// A file that exists for the lifetime of the test.
+class MappedROMTest : public ::testing::Test {
+protected:
+  const std::string path = ::testing::TempDir() + "mapped_rom_test.cartridge";
+
+  void write_file(const std::vector<uint8_t> &bytes) {
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    os.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+  }
+
+  void TearDown() override { std::remove(path.c_str()); }
+};
+
+} // namespace
+
+TEST_F(MappedROMTest, Read) {
+  write_file({0x12, 0x34, 0x56});
+  const MappedROM rom(4, path, "cartridge");
+  EXPECT_EQ(rom.name(), "cartridge");
+  EXPECT_EQ(rom.file_size(), 3);
+  EXPECT_EQ(rom.size(), 4);
+  EXPECT_EQ(rom.read(Word(0x0000)), Byte(0x12));
+  EXPECT_EQ(rom.read(Word(0x0002)), Byte(0x56));
+  EXPECT_EQ(rom.read(Word(0x0003)), Byte(0x00));
+  EXPECT_THROW(rom.read(Word(0x0004)), std::out_of_range);
+}
+
+TEST_F(MappedROMTest, ReadPastEndOfFile) {
+  write_file({0x12, 0x34, 0x56});
+  const MappedROM rom(0x1000, path);
+  EXPECT_EQ(rom.file_size(), 3);
+  EXPECT_EQ(rom.size(), 0x1000);
+  EXPECT_EQ(rom.read(Word(0x0003)), Byte(0x00));
+  EXPECT_EQ(rom.read(Word(0x0fff)), Byte(0x00));
+  EXPECT_THROW(rom.read(Word(0x1000)), std::out_of_range);
+}
+
+TEST_F(MappedROMTest, FileExactlyRomSize) {
+  write_file({0x12, 0x34, 0x56, 0x78});
+  const MappedROM rom(4, path);
+  EXPECT_EQ(rom.read(Word(0x0003)), Byte(0x78));
+}
+
+TEST_F(MappedROMTest, FileTooLarge) {
+  write_file({0x12, 0x34, 0x56, 0x78, 0x9a});
+  EXPECT_THROW(MappedROM(4, path), std::invalid_argument);
+}
+
+TEST_F(MappedROMTest, SizeNotPowerOfTwo) {
+  write_file({0x12});
+  EXPECT_THROW(MappedROM(3, path), std::invalid_argument);
+}
+
+TEST_F(MappedROMTest, Dump) {
+  write_file({0x12, 0x34, 0x56});
+  const MappedROM rom(4, path);
+  EXPECT_THAT(rom.dump(), ElementsAre(0x12, 0x34, 0x56, 0x00));
+}
+
+TEST_F(MappedROMTest, Write) {
+  write_file({0x12});
+  MappedROM rom(4, path);
+  EXPECT_FALSE(rom.can_write());
+  EXPECT_THROW(rom.write(Word(0x0000), Byte(0x34)), std::runtime_error);
+}
+
+TEST_F(MappedROMTest, EmptyFile) {
+  write_file({});
+  const MappedROM rom(4, path);
+  EXPECT_EQ(rom.file_size(), 0);
+  EXPECT_EQ(rom.size(), 4);
+  EXPECT_EQ(rom.read(Word(0x0000)), Byte(0x00));
+}
+
+TEST_F(MappedROMTest, MissingFile) {
+  EXPECT_THROW(MappedROM(4, path + ".missing"), std::runtime_error);
+}
+
+TEST_F(MappedROMTest, Clone) {
+  write_file({0x12, 0x34});
+  std::unique_ptr<Module> clone;
+  {
+    const MappedROM rom(4, path, "cartridge");
+    clone = rom.clone();
+  }
+  // The mapping outlives the original ROM.
+  EXPECT_EQ(clone->name(), "cartridge");
+  EXPECT_EQ(clone->size(), 4);
+  EXPECT_EQ(clone->read(Word(0x0001)), Byte(0x34));
+}
+
+TEST_F(MappedROMTest, Cartridge) {
+  const auto &instruction_set = asm_::InstructionSet::irata();
+  write_file({
+      instruction_set.get_instruction("LDA", asm_::AddressingMode::Immediate)
+          .opcode()
+          .unsigned_value(),
+      0x12,
+      instruction_set.get_instruction("HLT", asm_::AddressingMode::None)
+          .opcode()
+          .unsigned_value(),
+  });
+  Irata irata(std::make_unique<MappedROM>(0x1000, path, "cartridge"));
+  EXPECT_EQ(irata.tick_until_halt(-1, Irata::LogLevel::Quiet),
+            Irata::Result::Halt);
+  EXPECT_EQ(irata.cpu().a().value(), Byte(0x12));
+}
+
+TEST_F(MappedROMTest, CartridgeReadsPastEndOfFile) {
+  const auto &instruction_set = asm_::InstructionSet::irata();
+  write_file({
+      instruction_set.get_instruction("LDA", asm_::AddressingMode::Absolute)
+          .opcode()
+          .unsigned_value(),
+      0x80,
+      0x40,
+      instruction_set.get_instruction("HLT", asm_::AddressingMode::None)
+          .opcode()
+          .unsigned_value(),
+  });
+  // The machine is the same as one with the cartridge loaded from a stream, so
+  // the cartridge covers 0x8040 even though the file is only 4 bytes.
+  Irata irata(std::make_unique<MappedROM>(0x1000, path, "cartridge"));
+  EXPECT_EQ(irata.tick_until_halt(-1, Irata::LogLevel::Quiet),
+            Irata::Result::Halt);
+  EXPECT_EQ(irata.cpu().a().value(), Byte(0x00));
+}
+
+} // namespace irata::sim::components::memory
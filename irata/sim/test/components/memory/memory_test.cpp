@@ -116,6 +116,36 @@ TEST_F(MemoryTest, ValueOutOfRange) {
   EXPECT_THROW(memory.value(Word(0x2000)), std::runtime_error);
 }
 
+TEST_F(MemoryTest, ValueAcrossRegions) {
+  std::vector<std::unique_ptr<Region>> regions;
+  regions.emplace_back(
+      rom(0x0100, Word(0x0000), "rom1", {{Word(0x00FF), Byte(0x12)}}));
+  regions.emplace_back(
+      rom(0x0100, Word(0x0100), "rom2", {{Word(0x0000), Byte(0x34)}}));
+  regions.emplace_back(
+      rom(0x8000, Word(0x8000), "rom3", {{Word(0x7FFF), Byte(0x56)}}));
+  auto memory = this->memory(std::move(regions));
+  EXPECT_EQ(memory.value(Word(0x00FF)), Byte(0x12));
+  EXPECT_EQ(memory.value(Word(0x0100)), Byte(0x34));
+  EXPECT_EQ(memory.value(Word(0xFFFF)), Byte(0x56));
+  EXPECT_THROW(memory.value(Word(0x0200)), std::runtime_error);
+  EXPECT_THROW(memory.value(Word(0x7FFF)), std::runtime_error);
+}
+
+TEST_F(MemoryTest, ValueInRegionsSmallerThanAPage) {
+  std::vector<std::unique_ptr<Region>> regions;
+  regions.emplace_back(
+      rom(0x0004, Word(0x1000), "rom1", {{Word(0x0003), Byte(0x12)}}));
+  regions.emplace_back(
+      rom(0x0004, Word(0x1004), "rom2", {{Word(0x0000), Byte(0x34)}}));
+  auto memory = this->memory(std::move(regions));
+  EXPECT_EQ(memory.value(Word(0x1003)), Byte(0x12));
+  EXPECT_EQ(memory.value(Word(0x1004)), Byte(0x34));
+  // The rest of the page is unmapped.
+  EXPECT_THROW(memory.value(Word(0x1008)), std::runtime_error);
+  EXPECT_THROW(memory.value(Word(0x10FF)), std::runtime_error);
+}
+
 TEST_F(MemoryTest, Constructor) {
   std::vector<std::unique_ptr<Region>> regions;
   regions.emplace_back(ram(0x1000, Word(0x0000)));
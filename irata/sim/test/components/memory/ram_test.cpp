@@ -3,6 +3,8 @@
 #include <irata/sim/components/memory/ram.hpp>
 #include <stdexcept>
 
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
 using ::testing::Pair;
 using ::testing::UnorderedElementsAre;
 
@@ -50,6 +52,97 @@ TEST(RamTest, WriteOutOfRange) {
   EXPECT_THROW(ram.write(Word(0x0400), Byte(0xAB)), std::out_of_range);
 }
 
+TEST(RamTest, WriteZero) {
+  RAM ram(1024, "ram", {{Word(0x0001), Byte(0xAB)}});
+  ram.write(Word(0x0001), Byte(0x00));
+  EXPECT_EQ(ram.read(Word(0x0001)), Byte(0x00));
+  EXPECT_THAT(ram.data(), IsEmpty());
+}
+
+TEST(RamTest, FromBytes) {
+  RAM ram(1024, std::vector<uint8_t>{0x12, 0x00, 0x34});
+  EXPECT_EQ(ram.size(), 1024);
+  EXPECT_EQ(ram.dump().size(), 1024);
+  EXPECT_EQ(ram.read(Word(0x0000)), Byte(0x12));
+  EXPECT_EQ(ram.read(Word(0x0002)), Byte(0x34));
+  EXPECT_EQ(ram.read(Word(0x0003)), Byte(0x00));
+  EXPECT_THAT(ram.data(), UnorderedElementsAre(Pair(Word(0x0000), Byte(0x12)),
+                                               Pair(Word(0x0002), Byte(0x34))));
+}
+
+TEST(RamTest, FromBytesTooLarge) {
+  EXPECT_THROW(RAM(4, std::vector<uint8_t>(5, 0x12)), std::invalid_argument);
+}
+
+TEST(RamTest, Load) {
+  RAM ram(16);
+  ram.load({0x12, 0x34}, Word(0x000E));
+  EXPECT_EQ(ram.read(Word(0x000E)), Byte(0x12));
+  EXPECT_EQ(ram.read(Word(0x000F)), Byte(0x34));
+}
+
+TEST(RamTest, LoadOutOfRange) {
+  RAM ram(16);
+  EXPECT_THROW(ram.load({0x12, 0x34}, Word(0x000F)), std::out_of_range);
+}
+
+TEST(RamTest, Dump) {
+  RAM ram(4, "ram", {{Word(0x0001), Byte(0xAB)}});
+  ram.write(Word(0x0003), Byte(0xCD));
+  EXPECT_THAT(ram.dump(), ElementsAre(0x00, 0xAB, 0x00, 0xCD));
+}
+
+TEST(RamTest, ReadWriteAcrossPages) {
+  RAM ram(0x2000);
+  ram.write(Word(0x00FF), Byte(0x12));
+  ram.write(Word(0x0100), Byte(0x34));
+  ram.write(Word(0x1FFF), Byte(0x56));
+  EXPECT_EQ(ram.read(Word(0x00FF)), Byte(0x12));
+  EXPECT_EQ(ram.read(Word(0x0100)), Byte(0x34));
+  EXPECT_EQ(ram.read(Word(0x1FFF)), Byte(0x56));
+  EXPECT_THAT(ram.data(), UnorderedElementsAre(Pair(Word(0x00FF), Byte(0x12)),
+                                               Pair(Word(0x0100), Byte(0x34)),
+                                               Pair(Word(0x1FFF), Byte(0x56))));
+}
+
+TEST(RamTest, Share) {
+  RAM ram(0x1000, "ram", {{Word(0x0010), Byte(0x12)}});
+  RAM fork(0x1000);
+  EXPECT_EQ(ram.num_shared_pages(), 0);
+  fork.share(ram);
+  EXPECT_EQ(ram.num_shared_pages(), 0x10);
+  EXPECT_EQ(fork.num_shared_pages(), 0x10);
+  EXPECT_EQ(fork.read(Word(0x0010)), Byte(0x12));
+
+  // Writing copies only the written page.
+  fork.write(Word(0x0010), Byte(0x34));
+  EXPECT_EQ(ram.num_shared_pages(), 0x0F);
+  EXPECT_EQ(fork.num_shared_pages(), 0x0F);
+  EXPECT_EQ(ram.read(Word(0x0010)), Byte(0x12));
+  EXPECT_EQ(fork.read(Word(0x0010)), Byte(0x34));
+
+  ram.write(Word(0x0210), Byte(0x56));
+  EXPECT_EQ(ram.num_shared_pages(), 0x0E);
+  EXPECT_EQ(ram.read(Word(0x0210)), Byte(0x56));
+  EXPECT_EQ(fork.read(Word(0x0210)), Byte(0x00));
+}
+
+TEST(RamTest, ShareDifferentSize) {
+  RAM ram(0x1000);
+  RAM fork(0x2000);
+  EXPECT_THROW(fork.share(ram), std::invalid_argument);
+}
+
+TEST(RamTest, SmallerThanPage) {
+  RAM ram(4);
+  RAM fork(4);
+  ram.write(Word(0x0003), Byte(0x12));
+  fork.share(ram);
+  fork.write(Word(0x0000), Byte(0x34));
+  EXPECT_THAT(ram.dump(), ElementsAre(0x00, 0x00, 0x00, 0x12));
+  EXPECT_THAT(fork.dump(), ElementsAre(0x34, 0x00, 0x00, 0x12));
+}
+
 TEST(RamTest, CanWrite) {
   RAM ram(1024);
   EXPECT_TRUE(ram.can_write());
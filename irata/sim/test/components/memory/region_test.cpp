@@ -21,6 +21,13 @@ TEST(RegionTest, Constructor) {
   EXPECT_EQ(region.path(), "/ram");
 }
 
+TEST(RegionTest, Module) {
+  auto ram = std::make_unique<RAM>(0x400);
+  const Module *module = ram.get();
+  const Region region("ram", std::move(ram), Word(0x1000));
+  EXPECT_EQ(&region.module(), module);
+}
+
 TEST(RegionTest, NullModule) {
   EXPECT_THROW(Region("ram", nullptr, Word(0x1000)), std::invalid_argument);
 }
@@ -66,6 +73,13 @@ TEST(RegionTest, ContainsAddress) {
   EXPECT_FALSE(region.contains_address(Word(0x1400)));
 }
 
+TEST(RegionTest, ContainsAddressAtTopOfMemory) {
+  Region region("rom", std::make_unique<ROM>(0x8000), Word(0x8000));
+  EXPECT_TRUE(region.contains_address(Word(0x8000)));
+  EXPECT_TRUE(region.contains_address(Word(0xFFFF)));
+  EXPECT_FALSE(region.contains_address(Word(0x7FFF)));
+}
+
 TEST(RegionTest, Read) {
   std::map<Word, Byte> data = {{Word(0x100), Byte(0x12)}};
   Region region("ram", std::make_unique<RAM>(0x400, "ram", std::move(data)),
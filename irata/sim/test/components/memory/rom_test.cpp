@@ -3,6 +3,7 @@
 #include <irata/sim/components/memory/rom.hpp>
 #include <stdexcept>
 
+using ::testing::ElementsAre;
 using ::testing::IsEmpty;
 using ::testing::Pair;
 using ::testing::UnorderedElementsAre;
@@ -45,6 +46,33 @@ TEST(RomTest, ReadOutOfBounds) {
   EXPECT_THROW(rom.read(Word(0x0400)), std::out_of_range);
 }
 
+TEST(RomTest, FromBytes) {
+  ROM rom(1024, std::vector<uint8_t>{0x12, 0x00, 0x34});
+  EXPECT_EQ(rom.size(), 1024);
+  EXPECT_EQ(rom.bytes().size(), 1024);
+  EXPECT_EQ(rom.read(Word(0x0000)), Byte(0x12));
+  EXPECT_EQ(rom.read(Word(0x0002)), Byte(0x34));
+  EXPECT_EQ(rom.read(Word(0x03FF)), Byte(0x00));
+}
+
+TEST(RomTest, FromBytesTooLarge) {
+  EXPECT_THROW(ROM(4, std::vector<uint8_t>(5, 0x12)), std::invalid_argument);
+}
+
+TEST(RomTest, Dump) {
+  ROM rom(4, "rom", {{Word(0x0002), Byte(0x12)}});
+  EXPECT_THAT(rom.dump(), ElementsAre(0x00, 0x00, 0x12, 0x00));
+}
+
+TEST(RomTest, Clone) {
+  ROM rom(4, "cartridge", {{Word(0x0002), Byte(0x12)}});
+  const auto clone = rom.clone();
+  EXPECT_EQ(clone->name(), "cartridge");
+  EXPECT_EQ(clone->size(), 4);
+  EXPECT_EQ(clone->read(Word(0x0002)), Byte(0x12));
+  EXPECT_EQ(&dynamic_cast<const ROM &>(*clone).bytes(), &rom.bytes());
+}
+
 TEST(RomTest, Write) {
   ROM rom(1024);
   EXPECT_FALSE(rom.can_write());
@@ -81,6 +109,14 @@ TEST(RomTest, Load_Zero) {
   EXPECT_EQ(rom.size(), 1024);
 }
 
+TEST(RomTest, Load_ExactSize) {
+  std::string s(1024, char(0x12));
+  std::istringstream is(s);
+  const auto rom = ROM(1024, is);
+  EXPECT_EQ(rom.size(), 1024);
+  EXPECT_EQ(rom.read(Word(1023)), Byte(0x12));
+}
+
 TEST(RomTest, Load_TooLarge) {
   std::string s(1025, char(0x12));
   std::istringstream is(s);
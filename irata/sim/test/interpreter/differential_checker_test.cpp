@@ -0,0 +1,108 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <irata/asm/instruction_set.hpp>
+#include <irata/sim/interpreter/differential_checker.hpp>
+#include <sstream>
+#include <stdexcept>
+
+namespace irata::sim::interpreter {
+
+namespace {
+
+uint8_t opcode(std::string_view name,
+               asm_::AddressingMode mode = asm_::AddressingMode::None) {
+  return asm_::InstructionSet::irata()
+      .get_instruction(name, mode)
+      .opcode()
+      .unsigned_value();
+}
+
+} // namespace
+
+TEST(DifferentialCheckerTest, Halt) {
+  DifferentialChecker checker({opcode("hlt")});
+  EXPECT_EQ(checker.run(), std::nullopt);
+  EXPECT_EQ(checker.interpreter().result(), Interpreter::Result::Halt);
+  EXPECT_EQ(checker.irata().result(), components::Irata::Result::Halt);
+}
+
+TEST(DifferentialCheckerTest, Crash) {
+  DifferentialChecker checker({opcode("crs")});
+  EXPECT_EQ(checker.run(), std::nullopt);
+  EXPECT_EQ(checker.interpreter().result(), Interpreter::Result::Crash);
+  EXPECT_EQ(checker.irata().result(), components::Irata::Result::Crash);
+}
+
+TEST(DifferentialCheckerTest, CartridgeTooLarge) {
+  EXPECT_THROW(DifferentialChecker(std::vector<uint8_t>(0x8001)),
+               std::invalid_argument);
+}
+
+TEST(DifferentialCheckerTest, Program) {
+  DifferentialChecker checker({
+      opcode("ldx", asm_::AddressingMode::Immediate), 0x03,    //
+      opcode("lda", asm_::AddressingMode::Immediate), 0x12,    //
+      opcode("sta", asm_::AddressingMode::ZeroPageX), 0x10,    //
+      opcode("adc", asm_::AddressingMode::ZeroPage), 0x13,     //
+      opcode("pha"),                                           //
+      opcode("jsr", asm_::AddressingMode::Absolute), 0x80, 0x0E, //
+      opcode("pla"),                                           //
+      opcode("hlt"),                                           //
+      opcode("dex"),                                           // 0x800E
+      opcode("txa"),                                           //
+      opcode("cmp", asm_::AddressingMode::Immediate), 0x00,    //
+      opcode("jne", asm_::AddressingMode::Absolute), 0x80, 0x0E, //
+      opcode("rts"),                                           //
+  });
+  EXPECT_EQ(checker.run(100), std::nullopt);
+  EXPECT_EQ(checker.interpreter().result(), Interpreter::Result::Halt);
+  EXPECT_EQ(checker.interpreter().a(), Byte(0x24));
+  EXPECT_EQ(checker.interpreter().x(), Byte(0x00));
+}
+
+TEST(DifferentialCheckerTest, MaxInstructions) {
+  DifferentialChecker checker(
+      {opcode("jmp", asm_::AddressingMode::Absolute), 0x80, 0x00});
+  EXPECT_THROW(checker.run(5), std::runtime_error);
+}
+
+TEST(DifferentialCheckerTest, RandomProgramsAgree) {
+  std::mt19937 rng(0x1234);
+  for (int i = 0; i < 20; ++i) {
+    const auto program = DifferentialChecker::random_program(rng, 50);
+    DifferentialChecker checker(program);
+    const auto divergence = checker.run(1000);
+    std::ostringstream os;
+    if (divergence) {
+      os << *divergence;
+    }
+    EXPECT_EQ(divergence, std::nullopt) << "program " << i << ": " << os.str();
+    EXPECT_EQ(checker.interpreter().result(), Interpreter::Result::Halt);
+  }
+}
+
+TEST(DifferentialCheckerTest, RandomProgramIsDeterministic) {
+  std::mt19937 rng1(42);
+  std::mt19937 rng2(42);
+  EXPECT_EQ(DifferentialChecker::random_program(rng1, 100),
+            DifferentialChecker::random_program(rng2, 100));
+}
+
+TEST(DifferentialCheckerTest, RandomProgramEndsWithHlt) {
+  std::mt19937 rng(42);
+  const auto program = DifferentialChecker::random_program(rng, 10);
+  ASSERT_FALSE(program.empty());
+  EXPECT_EQ(program.back(), opcode("hlt"));
+}
+
+TEST(DifferentialCheckerTest, PrintDivergence) {
+  const DifferentialChecker::Divergence divergence{
+      3, Word(0x8005), "LDA Immedate", {"a: interpreter=0x12 sim=0x13"}};
+  std::ostringstream os;
+  os << divergence;
+  EXPECT_EQ(os.str(), "divergence after 3 instructions at 0x8005 (LDA "
+                      "Immedate):\n"
+                      "  a: interpreter=0x12 sim=0x13\n");
+}
+
+} // namespace irata::sim::interpreter
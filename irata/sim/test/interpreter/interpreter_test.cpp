@@ -0,0 +1,251 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <irata/asm/instruction_set.hpp>
+#include <irata/sim/interpreter/interpreter.hpp>
+#include <stdexcept>
+
+namespace irata::sim::interpreter {
+
+namespace {
+
+class InterpreterTest : public ::testing::Test {
+protected:
+  static uint8_t opcode(std::string_view name, asm_::AddressingMode mode =
+                                                   asm_::AddressingMode::None) {
+    return asm_::InstructionSet::irata()
+        .get_instruction(name, mode)
+        .opcode()
+        .unsigned_value();
+  }
+
+  static constexpr auto immediate = asm_::AddressingMode::Immediate;
+  static constexpr auto absolute = asm_::AddressingMode::Absolute;
+  static constexpr auto zero_page = asm_::AddressingMode::ZeroPage;
+  static constexpr auto zero_page_x = asm_::AddressingMode::ZeroPageX;
+  static constexpr auto absolute_y = asm_::AddressingMode::AbsoluteY;
+};
+
+} // namespace
+
+TEST_F(InterpreterTest, InitialState) {
+  const Interpreter interpreter;
+  EXPECT_EQ(interpreter.a(), Byte(0x00));
+  EXPECT_EQ(interpreter.x(), Byte(0x00));
+  EXPECT_EQ(interpreter.y(), Byte(0x00));
+  EXPECT_EQ(interpreter.stack_pointer(), Byte(0xFF));
+  EXPECT_EQ(interpreter.pc(), Word(0x8000));
+  EXPECT_EQ(interpreter.status_register(), Byte(0x00));
+  EXPECT_EQ(interpreter.memory().size(), 0x10000);
+  EXPECT_EQ(interpreter.result(), std::nullopt);
+}
+
+TEST_F(InterpreterTest, CartridgeTooLarge) {
+  EXPECT_THROW(Interpreter(std::vector<uint8_t>(0x8001)),
+               std::invalid_argument);
+}
+
+TEST_F(InterpreterTest, Halt) {
+  Interpreter interpreter({opcode("hlt")});
+  EXPECT_EQ(interpreter.run(), Interpreter::Result::Halt);
+  EXPECT_EQ(interpreter.pc(), Word(0x8001));
+  EXPECT_EQ(interpreter.instruction_count(), 1);
+  // Stepping a halted program does nothing.
+  EXPECT_EQ(interpreter.step(), Interpreter::Result::Halt);
+  EXPECT_EQ(interpreter.pc(), Word(0x8001));
+}
+
+TEST_F(InterpreterTest, Crash) {
+  Interpreter interpreter({opcode("crs")});
+  EXPECT_EQ(interpreter.run(), Interpreter::Result::Crash);
+  EXPECT_EQ(interpreter.pc(), Word(0x8001));
+}
+
+TEST_F(InterpreterTest, MaxInstructions) {
+  Interpreter interpreter(
+      {opcode("jmp", absolute), 0x80, 0x00, opcode("hlt")});
+  EXPECT_THROW(interpreter.run(10), std::runtime_error);
+  EXPECT_EQ(interpreter.instruction_count(), 10);
+}
+
+TEST_F(InterpreterTest, UnknownOpcode) {
+  Interpreter interpreter({0xFF});
+  EXPECT_THROW(interpreter.step(), std::runtime_error);
+  EXPECT_EQ(interpreter.pc(), Word(0x8000));
+}
+
+TEST_F(InterpreterTest, Memory) {
+  Interpreter interpreter({0x12});
+  EXPECT_EQ(interpreter.read(Word(0x8000)), Byte(0x12));
+  interpreter.write(Word(0x1FFF), Byte(0x34));
+  EXPECT_EQ(interpreter.read(Word(0x1FFF)), Byte(0x34));
+  EXPECT_EQ(interpreter.memory()[0x1FFF], 0x34);
+  // Unmapped addresses can't be read or written.
+  EXPECT_THROW(interpreter.read(Word(0x2000)), std::runtime_error);
+  EXPECT_THROW(interpreter.read(Word(0x8001)), std::runtime_error);
+  EXPECT_THROW(interpreter.write(Word(0x2000), Byte(0x00)),
+               std::runtime_error);
+  // The cartridge is read only.
+  EXPECT_THROW(interpreter.write(Word(0x8000), Byte(0x00)),
+               std::runtime_error);
+}
+
+TEST_F(InterpreterTest, LoadAndStore) {
+  Interpreter interpreter({
+      opcode("lda", immediate), 0x12,     //
+      opcode("sta", zero_page), 0x10,     //
+      opcode("ldx", zero_page), 0x10,     //
+      opcode("stx", absolute), 0x01, 0x23, //
+      opcode("ldy", absolute), 0x01, 0x23, //
+      opcode("hlt"),
+  });
+  EXPECT_EQ(interpreter.run(), Interpreter::Result::Halt);
+  EXPECT_EQ(interpreter.a(), Byte(0x12));
+  EXPECT_EQ(interpreter.x(), Byte(0x12));
+  EXPECT_EQ(interpreter.y(), Byte(0x12));
+  EXPECT_EQ(interpreter.read(Word(0x0010)), Byte(0x12));
+  EXPECT_EQ(interpreter.read(Word(0x0123)), Byte(0x12));
+  // Loads and stores don't touch the status register.
+  EXPECT_EQ(interpreter.status_register(), Byte(0x00));
+}
+
+TEST_F(InterpreterTest, IndexedAddressing) {
+  Interpreter interpreter({
+      opcode("ldx", immediate), 0xF8,        //
+      opcode("lda", immediate), 0x34,        //
+      opcode("sta", zero_page_x), 0x10,      // 0x10 + 0xF8 wraps to 0x08
+      opcode("ldy", immediate), 0x20,        //
+      opcode("lda", absolute_y), 0x00, 0xF0, // 0x00F0 + 0x20 carries to 0x0110
+      opcode("hlt"),
+  });
+  interpreter.write(Word(0x0110), Byte(0x56));
+  EXPECT_EQ(interpreter.run(), Interpreter::Result::Halt);
+  EXPECT_EQ(interpreter.read(Word(0x0008)), Byte(0x34));
+  EXPECT_EQ(interpreter.a(), Byte(0x56));
+}
+
+TEST_F(InterpreterTest, Cmp) {
+  for (const auto &[cmp_value, expected_zero] :
+       std::vector<std::pair<uint8_t, bool>>{{0x12, true}, {0x34, false}}) {
+    Interpreter interpreter({
+        opcode("lda", immediate),
+        0x12,
+        opcode("cmp", immediate),
+        cmp_value,
+        opcode("hlt"),
+    });
+    EXPECT_EQ(interpreter.run(), Interpreter::Result::Halt);
+    EXPECT_EQ(interpreter.status().zero, expected_zero);
+    EXPECT_EQ(interpreter.status_register(),
+              Byte(expected_zero ? 0x02 : 0x00));
+    // cmp doesn't change a.
+    EXPECT_EQ(interpreter.a(), Byte(0x12));
+  }
+}
+
+TEST_F(InterpreterTest, AdcWithCarry) {
+  Interpreter interpreter({
+      opcode("lda", immediate), 0xFF, //
+      opcode("sec"),                  //
+      opcode("adc", immediate), 0x01, //
+      opcode("hlt"),
+  });
+  EXPECT_EQ(interpreter.run(), Interpreter::Result::Halt);
+  EXPECT_EQ(interpreter.a(), Byte(0x01));
+  EXPECT_TRUE(interpreter.status().carry);
+  EXPECT_FALSE(interpreter.status().zero);
+  EXPECT_EQ(interpreter.status_register(), Byte(0x01));
+}
+
+TEST_F(InterpreterTest, SecAndClc) {
+  Interpreter interpreter({opcode("sec"), opcode("hlt")});
+  EXPECT_EQ(interpreter.run(), Interpreter::Result::Halt);
+  EXPECT_TRUE(interpreter.status().carry);
+  EXPECT_EQ(interpreter.status_register(), Byte(0x01));
+  // sec doesn't change the alu's own flags.
+  EXPECT_FALSE(interpreter.alu_flags().carry);
+}
+
+TEST_F(InterpreterTest, AddressArithmeticLatchesAluFlags) {
+  Interpreter interpreter({
+      opcode("sec"),                    //
+      opcode("lda", zero_page_x), 0x00, //
+      opcode("hlt"),
+  });
+  EXPECT_EQ(interpreter.run(), Interpreter::Result::Halt);
+  // The indexed load latched the alu flags, which were never set.
+  EXPECT_FALSE(interpreter.status().carry);
+  EXPECT_EQ(interpreter.status_register(), Byte(0x00));
+}
+
+TEST_F(InterpreterTest, Stack) {
+  Interpreter interpreter({
+      opcode("lda", immediate), 0x12, //
+      opcode("pha"),                  //
+      opcode("lda", immediate), 0x00, //
+      opcode("pla"),                  //
+      opcode("hlt"),
+  });
+  EXPECT_EQ(interpreter.run(), Interpreter::Result::Halt);
+  EXPECT_EQ(interpreter.a(), Byte(0x12));
+  EXPECT_EQ(interpreter.read(Word(0x01FF)), Byte(0x12));
+  EXPECT_EQ(interpreter.stack_pointer(), Byte(0xFF));
+}
+
+TEST_F(InterpreterTest, PlpOnlyLoadsStatusRegister) {
+  Interpreter interpreter({
+      opcode("lda", immediate), 0x02, //
+      opcode("pha"),                  //
+      opcode("plp"),                  //
+      opcode("hlt"),
+  });
+  EXPECT_EQ(interpreter.run(), Interpreter::Result::Halt);
+  EXPECT_EQ(interpreter.status_register(), Byte(0x02));
+  EXPECT_FALSE(interpreter.status().zero);
+}
+
+TEST_F(InterpreterTest, JsrAndRts) {
+  Interpreter interpreter({
+      opcode("jsr", absolute), 0x80, 0x05, // 0x8000
+      opcode("hlt"),                       // 0x8003
+      opcode("crs"),                       // 0x8004
+      opcode("lda", immediate), 0x12,      // 0x8005
+      opcode("rts"),                       // 0x8007
+  });
+  EXPECT_EQ(interpreter.run(), Interpreter::Result::Halt);
+  EXPECT_EQ(interpreter.a(), Byte(0x12));
+  EXPECT_EQ(interpreter.pc(), Word(0x8004));
+  // The return address is pushed high byte first.
+  EXPECT_EQ(interpreter.read(Word(0x01FF)), Byte(0x80));
+  EXPECT_EQ(interpreter.read(Word(0x01FE)), Byte(0x03));
+}
+
+TEST_F(InterpreterTest, Branches) {
+  Interpreter interpreter({
+      opcode("lda", immediate), 0x12, // 0x8000
+      opcode("cmp", immediate), 0x12, // 0x8002
+      opcode("jne", absolute), 0x80, 0x0E, // 0x8004
+      opcode("jeq", absolute), 0x80, 0x0D, // 0x8007
+      opcode("crs"),                       // 0x800A
+      opcode("crs"),                       // 0x800B
+      opcode("crs"),                       // 0x800C
+      opcode("hlt"),                       // 0x800D
+      opcode("crs"),                       // 0x800E
+  });
+  EXPECT_EQ(interpreter.run(), Interpreter::Result::Halt);
+}
+
+TEST_F(InterpreterTest, Serialize) {
+  Interpreter interpreter({opcode("lda", immediate), 0x12, opcode("hlt")});
+  interpreter.run();
+  std::ostringstream os;
+  interpreter.serialize(os);
+  EXPECT_EQ(os.str(), "a: 0x12\n"
+                      "x: 0x00\n"
+                      "y: 0x00\n"
+                      "stack_pointer: 0xFF\n"
+                      "pc: 0x8003\n"
+                      "status_register: 0x00\n"
+                      "instruction_count: 2\n");
+}
+
+} // namespace irata::sim::interpreter
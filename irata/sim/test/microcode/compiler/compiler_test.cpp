@@ -1,9 +1,13 @@
+#include <atomic>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <irata/asm/instruction.hpp>
 #include <irata/asm/instruction_set.hpp>
 #include <irata/sim/hdl/irata_decl.hpp>
 #include <irata/sim/microcode/compiler/compiler.hpp>
+#include <irata/sim/microcode/compiler/passes/step_index_transformer.hpp>
+#include <irata/sim/microcode/dsl/instruction.hpp>
+#include <sstream>
 #include <stdexcept>
 
 using ::testing::AllOf;
@@ -40,6 +44,43 @@ template <typename Matcher> auto EntryHasInstruction(Matcher matcher) {
   return Field("instruction", &table::Entry::instruction, matcher);
 }
 
+// Counts the instructions it runs on, and fails on instructions that use the
+// given control, if any.
+class CountingPass : public passes::InstructionPass {
+public:
+  explicit CountingPass(const hdl::ControlDecl *invalid_control = nullptr)
+      : invalid_control_(invalid_control) {}
+
+  ir::Instruction
+  run_instruction(const ir::Instruction &instruction) const override {
+    ++runs;
+    for (const auto &step : instruction.steps()) {
+      if (step.controls().count(invalid_control_) > 0) {
+        throw std::invalid_argument("invalid control");
+      }
+    }
+    return instruction;
+  }
+
+  mutable std::atomic<int> runs = 0;
+
+private:
+  const hdl::ControlDecl *invalid_control_;
+};
+
+// Returns an instruction set with LDA and TAX, where TAX copies the given
+// register to x.
+std::unique_ptr<dsl::InstructionSet>
+instruction_set(const hdl::ComponentWithByteBusDecl &tax_source) {
+  const auto &cpu = hdl::irata().cpu();
+  auto instruction_set = std::make_unique<dsl::InstructionSet>();
+  instruction_set->create_instruction("lda", asm_::AddressingMode::Immediate)
+      ->read_memory_at_pc(cpu.a());
+  instruction_set->create_instruction("tax", asm_::AddressingMode::None)
+      ->copy(tax_source, cpu.x());
+  return instruction_set;
+}
+
 } // namespace
 
 TEST(MicrocodeCompilerTest, NullPasses) {
@@ -82,4 +123,183 @@ TEST(MicrocodeCompilerTest, CmpHasOpcode1) {
   }
 }
 
+TEST(MicrocodeCompilerTest, ParallelCompileMatchesSerial) {
+  const Compiler serial(Compiler::irata_passes(), /*num_threads=*/1);
+  const Compiler parallel(Compiler::irata_passes(), /*num_threads=*/4);
+  EXPECT_EQ(serial.num_threads(), 1);
+  EXPECT_EQ(parallel.num_threads(), 4);
+  EXPECT_EQ(parallel.compile_to_ir(dsl::InstructionSet::irata()),
+            serial.compile_to_ir(dsl::InstructionSet::irata()));
+}
+
+TEST(MicrocodeCompilerTest, RecompileOnlyRunsChangedInstructions) {
+  std::vector<std::unique_ptr<passes::Pass>> passes;
+  auto &pass = *static_cast<CountingPass *>(
+      passes.emplace_back(std::make_unique<CountingPass>()).get());
+  const Compiler compiler(std::move(passes), /*num_threads=*/2);
+  const auto &cpu = hdl::irata().cpu();
+
+  const auto original = instruction_set(cpu.a());
+  const auto compiled = compiler.compile_to_ir(*original);
+  EXPECT_EQ(pass.runs, 2);
+  EXPECT_EQ(compiler.compile_to_ir(*original), compiled);
+  EXPECT_EQ(pass.runs, 2);
+
+  const auto changed = instruction_set(cpu.y());
+  EXPECT_NE(compiler.compile_to_ir(*changed), compiled);
+  EXPECT_EQ(pass.runs, 3);
+}
+
+TEST(MicrocodeCompilerTest, RecompileOnlyKeepsLastResults) {
+  std::vector<std::unique_ptr<passes::Pass>> passes;
+  auto &pass = *static_cast<CountingPass *>(
+      passes.emplace_back(std::make_unique<CountingPass>()).get());
+  const Compiler compiler(std::move(passes), /*num_threads=*/2);
+  const auto &cpu = hdl::irata().cpu();
+
+  const auto original = instruction_set(cpu.a());
+  const auto changed = instruction_set(cpu.y());
+  compiler.compile_to_ir(*original);
+  compiler.compile_to_ir(*changed);
+  EXPECT_EQ(pass.runs, 3);
+  // The original TAX was dropped when the changed set was compiled.
+  compiler.compile_to_ir(*original);
+  EXPECT_EQ(pass.runs, 4);
+}
+
+namespace {
+
+std::vector<std::unique_ptr<passes::Pass>> counting_passes(CountingPass *&pass) {
+  std::vector<std::unique_ptr<passes::Pass>> passes;
+  pass = static_cast<CountingPass *>(
+      passes.emplace_back(std::make_unique<CountingPass>()).get());
+  return passes;
+}
+
+} // namespace
+
+TEST(MicrocodeCompilerTest, LoadedCacheSkipsCachedInstructions) {
+  const auto &cpu = hdl::irata().cpu();
+  const auto original = instruction_set(cpu.a());
+  CountingPass *saving_pass;
+  const Compiler saving(counting_passes(saving_pass));
+  const auto compiled = saving.compile_to_ir(*original);
+  std::stringstream cache;
+  saving.save_cache(cache);
+
+  CountingPass *pass;
+  const Compiler compiler(counting_passes(pass));
+  EXPECT_TRUE(compiler.load_cache(cache, *original));
+  EXPECT_EQ(compiler.compile_to_ir(*original), compiled);
+  EXPECT_EQ(pass->runs, 0);
+}
+
+TEST(MicrocodeCompilerTest, LoadedCacheRecompilesChangedInstructions) {
+  const auto &cpu = hdl::irata().cpu();
+  std::stringstream cache;
+  CountingPass *saving_pass;
+  const Compiler saving(counting_passes(saving_pass));
+  saving.compile_to_ir(*instruction_set(cpu.a()));
+  saving.save_cache(cache);
+
+  const auto changed = instruction_set(cpu.y());
+  CountingPass *pass;
+  const Compiler compiler(counting_passes(pass));
+  EXPECT_TRUE(compiler.load_cache(cache, *changed));
+  CountingPass *uncached_pass;
+  EXPECT_EQ(compiler.compile_to_ir(*changed),
+            Compiler(counting_passes(uncached_pass)).compile_to_ir(*changed));
+  EXPECT_EQ(pass->runs, 1);
+}
+
+TEST(MicrocodeCompilerTest, LoadedIrataCacheMatchesCompile) {
+  const auto &instruction_set = dsl::InstructionSet::irata();
+  const Compiler saving(Compiler::irata_passes());
+  const auto compiled = saving.compile_to_ir(instruction_set);
+  std::stringstream cache;
+  saving.save_cache(cache);
+
+  const Compiler compiler(Compiler::irata_passes());
+  EXPECT_TRUE(compiler.load_cache(cache, instruction_set));
+  EXPECT_EQ(compiler.compile_to_ir(instruction_set), compiled);
+}
+
+TEST(MicrocodeCompilerTest, CacheFromOtherPassesIsNotLoaded) {
+  const auto &cpu = hdl::irata().cpu();
+  const auto original = instruction_set(cpu.a());
+  std::vector<std::unique_ptr<passes::Pass>> other_passes;
+  other_passes.push_back(std::make_unique<passes::StepIndexTransformer>());
+  const Compiler saving(std::move(other_passes));
+  saving.compile_to_ir(*original);
+  std::stringstream cache;
+  saving.save_cache(cache);
+
+  CountingPass *pass;
+  const Compiler compiler(counting_passes(pass));
+  EXPECT_FALSE(compiler.load_cache(cache, *original));
+  compiler.compile_to_ir(*original);
+  EXPECT_EQ(pass->runs, 2);
+}
+
+TEST(MicrocodeCompilerTest, MalformedCacheThrows) {
+  const auto &cpu = hdl::irata().cpu();
+  CountingPass *pass;
+  const Compiler compiler(counting_passes(pass));
+  std::istringstream not_a_cache("not a cache");
+  EXPECT_THROW(compiler.load_cache(not_a_cache, *instruction_set(cpu.a())),
+               std::runtime_error);
+
+  compiler.compile_to_ir(*instruction_set(cpu.a()));
+  std::stringstream cache;
+  compiler.save_cache(cache);
+  std::istringstream truncated(cache.str().substr(0, cache.str().size() - 1));
+  EXPECT_THROW(compiler.load_cache(truncated, *instruction_set(cpu.a())),
+               std::runtime_error);
+}
+
+TEST(MicrocodeCompilerTest, RegistryHasAddedControls) {
+  const auto &compiler = Compiler::irata();
+  const auto registry = compiler.registry(dsl::InstructionSet::irata());
+  const auto &step_counter = hdl::irata().cpu().controller().step_counter();
+  EXPECT_NE(registry->id(step_counter.increment()), std::nullopt);
+  EXPECT_NE(registry->id(step_counter.reset()), std::nullopt);
+  EXPECT_EQ(compiler.registry(dsl::InstructionSet::irata()), registry);
+}
+
+TEST(MicrocodeCompilerTest, CompilesControlsOutsideIrataMicrocode) {
+  const hdl::ProcessControlDecl control("control", hdl::irata());
+  dsl::InstructionSet instruction_set;
+  instruction_set.create_instruction("nop", asm_::AddressingMode::None)
+      ->create_step()
+      ->with_control(control);
+  std::vector<std::unique_ptr<passes::Pass>> passes;
+  passes.push_back(std::make_unique<passes::StepIndexTransformer>());
+  const Compiler compiler(std::move(passes));
+  EXPECT_THAT(compiler.compile(instruction_set).entries,
+              Contains(EntryHasControls(Contains(&control))));
+}
+
+TEST(MicrocodeCompilerTest, InstructionPassErrorIsThrown) {
+  const auto &cpu = hdl::irata().cpu();
+  std::vector<std::unique_ptr<passes::Pass>> passes;
+  passes.push_back(std::make_unique<CountingPass>(&cpu.y().write()));
+  const Compiler compiler(std::move(passes), /*num_threads=*/2);
+  EXPECT_NO_THROW(compiler.compile_to_ir(*instruction_set(cpu.a())));
+  EXPECT_THROW(compiler.compile_to_ir(*instruction_set(cpu.y())),
+               std::invalid_argument);
+}
+
+TEST(MicrocodeCompilerTest, IrataTableIsLoadedFromImage) {
+  // The image embedded in the library must match the current compiler
+  // and instruction set, or every process compiles the microcode at startup.
+  EXPECT_FALSE(Compiler::irata_image().empty());
+  EXPECT_TRUE(Compiler::irata_table_loaded_from_image());
+}
+
+TEST(MicrocodeCompilerTest, IrataTableMatchesCompiledTable) {
+  EXPECT_EQ(Compiler::irata_table(), Compiler::compile_irata());
+  // The table is only loaded once.
+  EXPECT_EQ(&Compiler::irata_table(), &Compiler::irata_table());
+}
+
 } // namespace irata::sim::microcode::compiler
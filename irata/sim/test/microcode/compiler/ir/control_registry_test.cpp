@@ -0,0 +1,81 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <irata/sim/hdl/irata_decl.hpp>
+#include <irata/sim/microcode/compiler/ir/control_registry.hpp>
+#include <irata/sim/microcode/dsl/instruction_set.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+using ::testing::Contains;
+using ::testing::ElementsAre;
+using ::testing::Key;
+using ::testing::UnorderedElementsAre;
+
+namespace irata::sim::microcode::compiler::ir {
+
+namespace {
+
+class ControlRegistryTest : public ::testing::Test {
+protected:
+  const hdl::IrataDecl &irata_ = hdl::irata();
+  const hdl::CpuDecl &cpu_ = irata_.cpu();
+  const ControlRegistry irata_registry_{
+      dsl::InstructionSet::irata().controls()};
+};
+
+} // namespace
+
+TEST_F(ControlRegistryTest, AssignsIdsInPathOrder) {
+  const ControlRegistry registry(
+      {&cpu_.x().read(), &cpu_.a().write(), &cpu_.pc().increment()});
+  EXPECT_EQ(registry.size(), 3);
+  EXPECT_EQ(registry.id(cpu_.a().write()), 0);
+  EXPECT_EQ(registry.id(cpu_.pc().increment()), 1);
+  EXPECT_EQ(registry.id(cpu_.x().read()), 2);
+  EXPECT_EQ(registry.id(cpu_.y().read()), std::nullopt);
+  EXPECT_EQ(&registry.control(0), &cpu_.a().write());
+}
+
+TEST_F(ControlRegistryTest, NullControl) {
+  EXPECT_THROW(ControlRegistry({nullptr}), std::invalid_argument);
+}
+
+TEST_F(ControlRegistryTest, TooManyControls) {
+  std::vector<std::unique_ptr<hdl::ProcessControlDecl>> decls;
+  std::set<const hdl::ControlDecl *> controls;
+  for (size_t i = 0; i <= ControlSet::max_controls; ++i) {
+    const auto &decl = decls.emplace_back(
+        std::make_unique<hdl::ProcessControlDecl>(
+            "control_" + std::to_string(i), irata_));
+    controls.insert(decl.get());
+  }
+  EXPECT_THROW(ControlRegistry{controls}, std::invalid_argument);
+}
+
+TEST_F(ControlRegistryTest, IrataPhaseControls) {
+  const auto &registry = irata_registry_;
+  const ControlSet controls(registry, {&cpu_.a().write(), &cpu_.x().read(),
+                                       &cpu_.pc().increment()});
+  EXPECT_THAT(controls & registry.phase_controls(hdl::TickPhase::Write),
+              ElementsAre(&cpu_.a().write()));
+  EXPECT_THAT(controls & registry.phase_controls(hdl::TickPhase::Read),
+              ElementsAre(&cpu_.x().read()));
+  EXPECT_THAT(controls & registry.phase_controls(hdl::TickPhase::Process),
+              ElementsAre(&cpu_.pc().increment()));
+  EXPECT_THAT(controls & registry.write_controls(),
+              ElementsAre(&cpu_.a().write()));
+  EXPECT_THAT(controls & registry.read_controls(),
+              ElementsAre(&cpu_.x().read()));
+}
+
+TEST_F(ControlRegistryTest, IrataBusControls) {
+  const auto &registry = irata_registry_;
+  EXPECT_THAT(registry.bus_controls(), Contains(Key(&irata_.data_bus())));
+  const ControlSet controls(registry, {&cpu_.a().write(), &cpu_.x().read(),
+                                       &cpu_.pc().increment()});
+  EXPECT_THAT(controls & registry.bus_controls().at(&irata_.data_bus()),
+              UnorderedElementsAre(&cpu_.a().write(), &cpu_.x().read()));
+}
+
+} // namespace irata::sim::microcode::compiler::ir
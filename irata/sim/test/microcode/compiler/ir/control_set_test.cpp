@@ -0,0 +1,110 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <irata/sim/hdl/irata_decl.hpp>
+#include <irata/sim/microcode/compiler/ir/control_registry.hpp>
+#include <irata/sim/microcode/compiler/ir/control_set.hpp>
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::UnorderedElementsAre;
+
+namespace irata::sim::microcode::compiler::ir {
+
+namespace {
+
+class ControlSetTest : public ::testing::Test {
+protected:
+  const hdl::CpuDecl &cpu_ = hdl::irata().cpu();
+  const hdl::ControlDecl &a_write_ = cpu_.a().write();
+  const hdl::ControlDecl &x_read_ = cpu_.x().read();
+  const hdl::ControlDecl &pc_increment_ = cpu_.pc().increment();
+  const ControlRegistry registry_{{&a_write_, &x_read_, &pc_increment_,
+                                   &cpu_.x().write()}};
+};
+
+} // namespace
+
+TEST_F(ControlSetTest, Empty) {
+  const ControlSet set(registry_);
+  EXPECT_TRUE(set.empty());
+  EXPECT_EQ(set.size(), 0);
+  EXPECT_THAT(set, IsEmpty());
+}
+
+TEST_F(ControlSetTest, Insert) {
+  ControlSet set(registry_);
+  set.insert(&a_write_);
+  set.insert(&x_read_);
+  set.insert(&a_write_);
+  EXPECT_EQ(set.size(), 2);
+  EXPECT_EQ(set.count(&a_write_), 1);
+  EXPECT_EQ(set.count(&pc_increment_), 0);
+  EXPECT_THAT(set, UnorderedElementsAre(&a_write_, &x_read_));
+}
+
+TEST_F(ControlSetTest, InsertNull) {
+  ControlSet set(registry_);
+  EXPECT_THROW(set.insert(nullptr), std::invalid_argument);
+}
+
+TEST_F(ControlSetTest, InsertUnregistered) {
+  ControlSet set(registry_);
+  EXPECT_THROW(set.insert(&cpu_.y().read()), std::invalid_argument);
+  EXPECT_EQ(set.count(&cpu_.y().read()), 0);
+}
+
+TEST_F(ControlSetTest, Erase) {
+  ControlSet set(registry_, {&a_write_, &x_read_});
+  set.erase(&a_write_);
+  set.erase(&pc_increment_);
+  EXPECT_THAT(set, ElementsAre(&x_read_));
+}
+
+TEST_F(ControlSetTest, FromStdSet) {
+  const std::set<const hdl::WriteControlDecl *> controls = {&cpu_.a().write(),
+                                                            &cpu_.x().write()};
+  EXPECT_THAT(ControlSet(registry_, controls),
+              UnorderedElementsAre(&cpu_.a().write(), &cpu_.x().write()));
+}
+
+TEST_F(ControlSetTest, IteratesInPathOrder) {
+  const ControlSet set(registry_, {&x_read_, &pc_increment_, &a_write_});
+  EXPECT_THAT(set, ElementsAre(&a_write_, &pc_increment_, &x_read_));
+}
+
+TEST_F(ControlSetTest, SetOperations) {
+  const ControlSet lhs(registry_, {&a_write_, &x_read_});
+  const ControlSet rhs(registry_, {&x_read_, &pc_increment_});
+  EXPECT_THAT(lhs | rhs,
+              UnorderedElementsAre(&a_write_, &x_read_, &pc_increment_));
+  EXPECT_THAT(lhs & rhs, ElementsAre(&x_read_));
+  EXPECT_THAT(lhs - rhs, ElementsAre(&a_write_));
+}
+
+TEST_F(ControlSetTest, Comparison) {
+  const ControlSet lhs(registry_, {&a_write_, &x_read_});
+  const ControlSet rhs(registry_, {&x_read_, &a_write_});
+  const ControlSet other(registry_, {&pc_increment_});
+  EXPECT_EQ(lhs, rhs);
+  EXPECT_NE(lhs, other);
+  EXPECT_NE(lhs < other, other < lhs);
+  EXPECT_FALSE(lhs < rhs);
+}
+
+TEST_F(ControlSetTest, DifferentRegistries) {
+  const ControlRegistry other_registry({&a_write_, &x_read_});
+  const ControlSet lhs(registry_, {&a_write_, &x_read_});
+  const ControlSet rhs(other_registry, {&x_read_, &a_write_});
+  const ControlSet other(other_registry, {&x_read_});
+  EXPECT_EQ(lhs, rhs);
+  EXPECT_FALSE(lhs < rhs);
+  EXPECT_NE(lhs, other);
+  // Sets are ordered the same way whichever registries they belong to.
+  EXPECT_EQ(lhs < other, lhs < ControlSet(registry_, {&x_read_}));
+  EXPECT_NE(lhs < other, other < lhs);
+  EXPECT_THROW(lhs | rhs, std::invalid_argument);
+  EXPECT_THROW(lhs & rhs, std::invalid_argument);
+  EXPECT_THROW(lhs - rhs, std::invalid_argument);
+}
+
+} // namespace irata::sim::microcode::compiler::ir
@@ -7,6 +7,7 @@
 #include <irata/sim/microcode/dsl/instruction.hpp>
 #include <irata/sim/microcode/dsl/instruction_set.hpp>
 #include <irata/sim/microcode/dsl/step.hpp>
+#include <stdexcept>
 
 using ::testing::AllOf;
 using ::testing::Property;
@@ -34,12 +35,13 @@ protected:
   }
 
   const hdl::StatusDecl status = hdl::StatusDecl("status", hdl::irata());
+  const ControlRegistry registry_{dsl::InstructionSet::irata().controls()};
 };
 
 } // namespace
 
 TEST_F(MicrocodeIrInstructionTest, ConstructFromDsl) {
-  Instruction ir_instruction(dsl_instruction_);
+  Instruction ir_instruction(registry_, dsl_instruction_);
   EXPECT_EQ(ir_instruction.descriptor(), dsl_instruction_.descriptor());
   EXPECT_EQ(ir_instruction.statuses(), dsl_instruction_.statuses());
   ASSERT_EQ(ir_instruction.steps().size(), dsl_instruction_.steps().size());
@@ -47,21 +49,30 @@ TEST_F(MicrocodeIrInstructionTest, ConstructFromDsl) {
     EXPECT_THAT(
         ir_instruction.steps()[i],
         AllOf(
-            StepHasControls(dsl_instruction_.steps()[i]->controls()),
-            StepHasWriteControls(dsl_instruction_.steps()[i]->write_controls()),
-            StepHasReadControls(dsl_instruction_.steps()[i]->read_controls())));
+            StepHasControls(ControlSet(
+                registry_, dsl_instruction_.steps()[i]->controls())),
+            StepHasWriteControls(ControlSet(
+                registry_, dsl_instruction_.steps()[i]->write_controls())),
+            StepHasReadControls(ControlSet(
+                registry_, dsl_instruction_.steps()[i]->read_controls()))));
   }
 }
 
+TEST_F(MicrocodeIrInstructionTest, ConstructFromDslWithUnregisteredControl) {
+  const hdl::ProcessControlDecl control("control", hdl::irata());
+  dsl::InstructionSet instruction_set;
+  auto *instruction =
+      instruction_set.create_instruction("nop", asm_::AddressingMode::None);
+  instruction->create_step()->with_control(control);
+  EXPECT_THROW((Instruction{registry_, *instruction}), std::invalid_argument);
+}
+
 TEST_F(MicrocodeIrInstructionTest, ConstructDirectly) {
   const asm_::Instruction &descriptor =
       asm_::InstructionSet::irata().get_instruction(
           "lda", asm_::AddressingMode::Immediate);
-  const std::vector<Step> steps = {Step(
-      {
-          &hdl::irata().cpu().pc().increment(),
-      },
-      {}, {}, 0)};
+  const std::vector<Step> steps = {
+      Step(registry_, {&hdl::irata().cpu().pc().increment()}, {}, {}, 0)};
   const std::map<const hdl::StatusDecl *, bool> statuses = {{&status, true}};
   Instruction ir_instruction(descriptor, steps, statuses);
   EXPECT_EQ(ir_instruction.descriptor(), descriptor);
@@ -19,15 +19,18 @@ protected:
            .get_instruction("lda", asm_::AddressingMode::Immediate)
            .steps()
            .front();
+  const ControlRegistry registry_{dsl::InstructionSet::irata().controls()};
 };
 
 } // namespace
 
 TEST_F(MicrocodeIrStepTest, ConstructFromDsl) {
-  Step ir_step(dsl_step_);
-  EXPECT_EQ(ir_step.controls(), dsl_step_.controls());
-  EXPECT_EQ(ir_step.write_controls(), dsl_step_.write_controls());
-  EXPECT_EQ(ir_step.read_controls(), dsl_step_.read_controls());
+  Step ir_step(registry_, dsl_step_);
+  EXPECT_EQ(ir_step.controls(), ControlSet(registry_, dsl_step_.controls()));
+  EXPECT_EQ(ir_step.write_controls(),
+            ControlSet(registry_, dsl_step_.write_controls()));
+  EXPECT_EQ(ir_step.read_controls(),
+            ControlSet(registry_, dsl_step_.read_controls()));
   EXPECT_EQ(ir_step.stage(), dsl_step_.stage());
 }
 
@@ -36,7 +39,7 @@ TEST_F(MicrocodeIrStepTest, ConstructFromControls) {
       hdl::irata().cpu().pc().increment();
   const hdl::WriteControlDecl &write_control = hdl::irata().cpu().pc().write();
   const hdl::ReadControlDecl &read_control = hdl::irata().cpu().pc().read();
-  Step ir_step({&process_control, &write_control, &read_control},
+  Step ir_step(registry_, {&process_control, &write_control, &read_control},
                {&write_control}, {&read_control}, 0);
   EXPECT_THAT(
       ir_step.controls(),
@@ -46,9 +49,28 @@ TEST_F(MicrocodeIrStepTest, ConstructFromControls) {
   EXPECT_EQ(ir_step.stage(), 0);
 }
 
+TEST_F(MicrocodeIrStepTest, WriteControlsMustBeInControls) {
+  const hdl::WriteControlDecl &write_control = hdl::irata().cpu().pc().write();
+  EXPECT_THROW(Step(registry_, {}, {&write_control}, {}, 0),
+               std::invalid_argument);
+}
+
+TEST_F(MicrocodeIrStepTest, WriteControlsMustBeWriteControls) {
+  const hdl::ReadControlDecl &read_control = hdl::irata().cpu().pc().read();
+  EXPECT_THROW(Step(ControlSet(registry_, {&read_control}),
+                    ControlSet(registry_, {&read_control}),
+                    ControlSet(registry_, {&read_control}), 0),
+               std::invalid_argument);
+}
+
+TEST_F(MicrocodeIrStepTest, UnregisteredControl) {
+  const hdl::ProcessControlDecl control("control", hdl::irata());
+  EXPECT_THROW(Step(registry_, {&control}, {}, {}, 0), std::invalid_argument);
+}
+
 TEST_F(MicrocodeIrStepTest, Equality) {
-  Step ir_step1(dsl_step_);
-  Step ir_step2(dsl_step_);
+  Step ir_step1(registry_, dsl_step_);
+  Step ir_step2(registry_, dsl_step_);
   EXPECT_EQ(ir_step1, ir_step2);
   EXPECT_FALSE(ir_step1 != ir_step2);
 }
@@ -0,0 +1,115 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <irata/asm/instruction.hpp>
+#include <irata/asm/instruction_set.hpp>
+#include <irata/sim/hdl/irata_decl.hpp>
+#include <irata/sim/microcode/compiler/passes/fetch_overlap_transformer.hpp>
+#include <irata/sim/microcode/dsl/instruction_set.hpp>
+#include <stdexcept>
+
+using ::testing::ElementsAre;
+using ::testing::Property;
+using ::testing::UnorderedElementsAre;
+
+namespace irata::sim::microcode::compiler::passes {
+
+namespace {
+
+class FetchOverlapTransformerTest : public ::testing::Test {
+protected:
+  FetchOverlapTransformer transformer_;
+  const hdl::IrataDecl &irata_ = hdl::irata();
+  const hdl::CpuDecl &cpu_ = irata_.cpu();
+  const ir::ControlRegistry registry_{
+      dsl::InstructionSet::irata().controls()};
+  const asm_::Instruction &instruction_descriptor_ =
+      asm_::InstructionSet::irata().get_instruction(
+          "lda", asm_::AddressingMode::Immediate);
+
+  ir::InstructionSet transform(const ir::InstructionSet &instruction_set) {
+    return transformer_.run(instruction_set);
+  }
+
+  ir::Step step(std::set<const hdl::ControlDecl *> controls, int stage) {
+    std::set<const hdl::WriteControlDecl *> write_controls;
+    std::set<const hdl::ReadControlDecl *> read_controls;
+    for (const auto &control : controls) {
+      if (const auto *write_control =
+              dynamic_cast<const hdl::WriteControlDecl *>(control)) {
+        write_controls.insert(write_control);
+      }
+      if (const auto *read_control =
+              dynamic_cast<const hdl::ReadControlDecl *>(control)) {
+        read_controls.insert(read_control);
+      }
+    }
+    return ir::Step(registry_, controls, write_controls, read_controls, stage);
+  }
+
+  ir::Step transfer(int stage) {
+    return step({&cpu_.pc().write(), &irata_.memory().address().read()},
+                stage);
+  }
+
+  ir::Step read_opcode() {
+    return step({&irata_.memory().write(), &cpu_.controller().opcode().read(),
+                 &cpu_.pc().increment()},
+                0);
+  }
+
+  ir::InstructionSet instruction_set(std::vector<ir::Step> steps) {
+    return ir::InstructionSet(
+        {ir::Instruction(instruction_descriptor_, steps, {})});
+  }
+
+  template <typename Matcher>
+  auto InstructionSetHasInstructions(Matcher matcher) {
+    return Property("instructions", &ir::InstructionSet::instructions, matcher);
+  }
+
+  template <typename Matcher> auto InstructionHasSteps(Matcher matcher) {
+    return Property("steps", &ir::Instruction::steps, matcher);
+  }
+};
+
+} // namespace
+
+TEST_F(FetchOverlapTransformerTest, MovesTransferToEnd) {
+  const auto body = step({&cpu_.a().write(), &cpu_.alu().lhs().read()}, 1);
+  EXPECT_THAT(transform(instruction_set({transfer(0), read_opcode(), body})),
+              InstructionSetHasInstructions(UnorderedElementsAre(
+                  InstructionHasSteps(
+                      ElementsAre(read_opcode(), body, transfer(1))))));
+}
+
+TEST_F(FetchOverlapTransformerTest, KeepsLastStage) {
+  const auto body = step({&cpu_.a().write(), &cpu_.alu().lhs().read()}, 2);
+  EXPECT_THAT(transform(instruction_set({transfer(0), read_opcode(), body})),
+              InstructionSetHasInstructions(UnorderedElementsAre(
+                  InstructionHasSteps(
+                      ElementsAre(read_opcode(), body, transfer(2))))));
+}
+
+TEST_F(FetchOverlapTransformerTest, KeepsFetchStageWithoutBody) {
+  EXPECT_THAT(transform(instruction_set({transfer(0), read_opcode()})),
+              InstructionSetHasInstructions(UnorderedElementsAre(
+                  InstructionHasSteps(
+                      ElementsAre(read_opcode(), transfer(1))))));
+}
+
+TEST_F(FetchOverlapTransformerTest, FetchStageWithoutTransfer) {
+  EXPECT_THROW(transform(instruction_set({read_opcode()})),
+               std::invalid_argument);
+}
+
+TEST_F(FetchOverlapTransformerTest, IrataInstructionSet) {
+  const auto transformed = transform(ir::InstructionSet(
+      dsl::InstructionSet::irata()));
+  for (const auto &instruction : transformed.instructions()) {
+    EXPECT_NE(instruction.steps().front(), transfer(0)) << instruction;
+    EXPECT_EQ(instruction.steps().back().controls(), transfer(0).controls())
+        << instruction;
+  }
+}
+
+} // namespace irata::sim::microcode::compiler::passes
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <irata/asm/instruction.hpp>
+#include <irata/asm/instruction_set.hpp>
+#include <irata/sim/hdl/irata_decl.hpp>
+#include <irata/sim/microcode/compiler/passes/fetch_overlap_validator.hpp>
+#include <irata/sim/microcode/dsl/instruction_set.hpp>
+#include <stdexcept>
+
+namespace irata::sim::microcode::compiler::passes {
+
+namespace {
+
+class FetchOverlapValidatorTest : public ::testing::Test {
+protected:
+  FetchOverlapValidator validator_;
+  const hdl::IrataDecl &irata_ = hdl::irata();
+  const hdl::CpuDecl &cpu_ = irata_.cpu();
+  const ir::ControlRegistry registry_{
+      dsl::InstructionSet::irata().controls()};
+  const asm_::Instruction &instruction_descriptor_ =
+      asm_::InstructionSet::irata().get_instruction(
+          "lda", asm_::AddressingMode::Immediate);
+
+  // Validates an instruction with a step in the fetch stage that reads the
+  // opcode and then a step for each set of controls in the given stage.
+  void validate(std::vector<std::set<const hdl::ControlDecl *>> control_sets,
+                int stage = 1) {
+    std::vector<ir::Step> steps = {
+        step({&irata_.memory().write(), &cpu_.controller().opcode().read(),
+              &cpu_.pc().increment()},
+             0)};
+    for (const auto &controls : control_sets) {
+      steps.push_back(step(controls, stage));
+    }
+    validator_.run(ir::InstructionSet(
+        {ir::Instruction(instruction_descriptor_, steps, {})}));
+  }
+
+  ir::Step step(std::set<const hdl::ControlDecl *> controls, int stage) {
+    std::set<const hdl::WriteControlDecl *> write_controls;
+    std::set<const hdl::ReadControlDecl *> read_controls;
+    for (const auto &control : controls) {
+      if (const auto *write_control =
+              dynamic_cast<const hdl::WriteControlDecl *>(control)) {
+        write_controls.insert(write_control);
+      }
+      if (const auto *read_control =
+              dynamic_cast<const hdl::ReadControlDecl *>(control)) {
+        read_controls.insert(read_control);
+      }
+    }
+    return ir::Step(registry_, controls, write_controls, read_controls, stage);
+  }
+
+  const hdl::ControlDecl *pc_write_ = &cpu_.pc().write();
+  const hdl::ControlDecl *address_read_ = &irata_.memory().address().read();
+};
+
+} // namespace
+
+TEST_F(FetchOverlapValidatorTest, TransferInLastStep) {
+  EXPECT_NO_THROW(validate({{&cpu_.a().write(), &cpu_.alu().lhs().read()},
+                            {pc_write_, address_read_}}));
+}
+
+TEST_F(FetchOverlapValidatorTest, TransferBeforeIndependentStep) {
+  EXPECT_NO_THROW(validate({{pc_write_, address_read_},
+                            {&cpu_.a().write(), &cpu_.alu().lhs().read()}}));
+}
+
+TEST_F(FetchOverlapValidatorTest, NoTransfer) {
+  EXPECT_THROW(validate({{&cpu_.a().write(), &cpu_.alu().lhs().read()}}),
+               std::invalid_argument);
+}
+
+TEST_F(FetchOverlapValidatorTest, TransferOnlyInFetchStage) {
+  EXPECT_THROW(validate({{pc_write_, address_read_}}, /*stage=*/0),
+               std::invalid_argument);
+}
+
+TEST_F(FetchOverlapValidatorTest, MemoryReadBeforeTransferInSameStep) {
+  EXPECT_NO_THROW(validate({{pc_write_, address_read_,
+                             &irata_.memory().write(), &cpu_.a().read()}}));
+}
+
+TEST_F(FetchOverlapValidatorTest, MemoryWriteInSameStep) {
+  EXPECT_THROW(validate({{pc_write_, address_read_, &cpu_.a().write(),
+                          &irata_.memory().read()}}),
+               std::invalid_argument);
+}
+
+TEST_F(FetchOverlapValidatorTest, MemoryAccessAfterTransfer) {
+  EXPECT_THROW(validate({{pc_write_, address_read_},
+                         {&irata_.memory().write(), &cpu_.a().read()}}),
+               std::invalid_argument);
+}
+
+TEST_F(FetchOverlapValidatorTest, PcChangedInSameStep) {
+  EXPECT_THROW(validate({{pc_write_, address_read_, &cpu_.pc().increment()}}),
+               std::invalid_argument);
+}
+
+TEST_F(FetchOverlapValidatorTest, PcChangedAfterTransfer) {
+  EXPECT_THROW(validate({{pc_write_, address_read_},
+                         {&cpu_.buffer().write(), &cpu_.pc().read()}}),
+               std::invalid_argument);
+}
+
+} // namespace irata::sim::microcode::compiler::passes
@@ -21,6 +21,7 @@ protected:
   const hdl::ProcessControlDecl control1 = {"control1", hdl::irata()};
   const hdl::ProcessControlDecl control2 = {"control2", hdl::irata()};
   const hdl::ProcessControlDecl control3 = {"control3", hdl::irata()};
+  const ir::ControlRegistry registry{{&control1, &control2, &control3}};
 
   FetchStageValidator validator;
 };
@@ -33,8 +34,8 @@ TEST_F(FetchStageValidatorTest, EmptyInstructionSet) {
 }
 
 TEST_F(FetchStageValidatorTest, InstructionsWithSameFetchStage) {
-  ir::Step step1({&control1}, {}, {}, 0);
-  ir::Step step2({&control2}, {}, {}, 0);
+  ir::Step step1(registry, {&control1}, {}, {}, 0);
+  ir::Step step2(registry, {&control2}, {}, {}, 0);
   ir::Instruction instruction1(descriptor, {step1, step2}, {});
   ir::Instruction instruction2(descriptor, {step1, step2}, {});
   ir::InstructionSet instruction_set({instruction1, instruction2});
@@ -42,9 +43,9 @@ TEST_F(FetchStageValidatorTest, InstructionsWithSameFetchStage) {
 }
 
 TEST_F(FetchStageValidatorTest, InstructionsWithDifferentFetchStage) {
-  ir::Step step1({&control1}, {}, {}, 0);
-  ir::Step step2({&control2}, {}, {}, 0);
-  ir::Step step3({&control3}, {}, {}, 0);
+  ir::Step step1(registry, {&control1}, {}, {}, 0);
+  ir::Step step2(registry, {&control2}, {}, {}, 0);
+  ir::Step step3(registry, {&control3}, {}, {}, 0);
   ir::Instruction instruction1(descriptor, {step1, step2}, {});
   ir::Instruction instruction2(descriptor, {step1, step3}, {});
   ir::InstructionSet instruction_set({instruction1, instruction2});
@@ -52,9 +53,9 @@ TEST_F(FetchStageValidatorTest, InstructionsWithDifferentFetchStage) {
 }
 
 TEST_F(FetchStageValidatorTest, InstructionsWithSmallerFetchStage) {
-  ir::Step step1({&control1}, {}, {}, 0);
-  ir::Step step2({&control2}, {}, {}, 0);
-  ir::Step step3({&control3}, {}, {}, 0);
+  ir::Step step1(registry, {&control1}, {}, {}, 0);
+  ir::Step step2(registry, {&control2}, {}, {}, 0);
+  ir::Step step3(registry, {&control3}, {}, {}, 0);
   ir::Instruction instruction1(descriptor, {step1, step2}, {});
   ir::Instruction instruction2(descriptor, {step1}, {});
   ir::InstructionSet instruction_set({instruction1, instruction2});
@@ -62,9 +63,9 @@ TEST_F(FetchStageValidatorTest, InstructionsWithSmallerFetchStage) {
 }
 
 TEST_F(FetchStageValidatorTest, InstructionsWithLargerFetchStage) {
-  ir::Step step1({&control1}, {}, {}, 0);
-  ir::Step step2({&control2}, {}, {}, 0);
-  ir::Step step3({&control3}, {}, {}, 0);
+  ir::Step step1(registry, {&control1}, {}, {}, 0);
+  ir::Step step2(registry, {&control2}, {}, {}, 0);
+  ir::Step step3(registry, {&control3}, {}, {}, 0);
   ir::Instruction instruction1(descriptor, {step1, step2}, {});
   ir::Instruction instruction2(descriptor, {step1, step2, step3}, {});
   ir::InstructionSet instruction_set({instruction1, instruction2});
@@ -73,9 +74,9 @@ TEST_F(FetchStageValidatorTest, InstructionsWithLargerFetchStage) {
 
 TEST_F(FetchStageValidatorTest,
        InstructionsWithSameFetchStageButDifferentLaterStages) {
-  ir::Step step1({&control1}, {}, {}, 0);
-  ir::Step step2({&control2}, {}, {}, 1);
-  ir::Step step3({&control3}, {}, {}, 1);
+  ir::Step step1(registry, {&control1}, {}, {}, 0);
+  ir::Step step2(registry, {&control2}, {}, {}, 1);
+  ir::Step step3(registry, {&control3}, {}, {}, 1);
   ir::Instruction instruction1(descriptor, {step1, step2}, {});
   ir::Instruction instruction2(descriptor, {step1, step3}, {});
   ir::InstructionSet instruction_set({instruction1, instruction2});
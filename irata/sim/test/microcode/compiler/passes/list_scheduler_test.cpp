@@ -0,0 +1,219 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <irata/asm/instruction.hpp>
+#include <irata/asm/instruction_set.hpp>
+#include <irata/sim/hdl/irata_decl.hpp>
+#include <irata/sim/microcode/compiler/passes/list_scheduler.hpp>
+#include <irata/sim/microcode/dsl/instruction_set.hpp>
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::Property;
+using ::testing::UnorderedElementsAre;
+
+namespace irata::sim::microcode::compiler::passes {
+
+namespace {
+
+class ListSchedulerTest : public ::testing::Test {
+protected:
+  std::unique_ptr<ListScheduler> scheduler_ = ListScheduler::irata();
+  const hdl::IrataDecl &irata_ = hdl::irata();
+  const hdl::CpuDecl &cpu_ = irata_.cpu();
+  const ir::ControlRegistry registry_{
+      dsl::InstructionSet::irata().controls()};
+  const asm_::Instruction &instruction_descriptor_ =
+      asm_::InstructionSet::irata().get_instruction(
+          "lda", asm_::AddressingMode::Immediate);
+
+  ir::InstructionSet schedule(const ir::InstructionSet &instruction_set) {
+    return scheduler_->run(instruction_set);
+  }
+
+  // Returns an instruction with a step for each set of controls. Steps are in
+  // stage 0 unless stages are given.
+  ir::Instruction instruction_with_controls(
+      std::vector<std::set<const hdl::ControlDecl *>> controls,
+      std::vector<int> stages = {}) {
+    std::vector<ir::Step> steps;
+    for (size_t i = 0; i < controls.size(); ++i) {
+      std::set<const hdl::WriteControlDecl *> write_controls;
+      std::set<const hdl::ReadControlDecl *> read_controls;
+      for (const auto &control : controls[i]) {
+        if (const auto *write_control =
+                dynamic_cast<const hdl::WriteControlDecl *>(control)) {
+          write_controls.insert(write_control);
+        }
+        if (const auto *read_control =
+                dynamic_cast<const hdl::ReadControlDecl *>(control)) {
+          read_controls.insert(read_control);
+        }
+      }
+      steps.push_back(ir::Step(registry_, controls[i], write_controls,
+                               read_controls, stages.empty() ? 0 : stages[i]));
+    }
+    return ir::Instruction(instruction_descriptor_, steps, {});
+  }
+
+  template <typename Matcher>
+  auto InstructionSetHasInstructions(Matcher matcher) {
+    return Property("instructions", &ir::InstructionSet::instructions, matcher);
+  }
+
+  template <typename Matcher> auto InstructionHasSteps(Matcher matcher) {
+    return Property("steps", &ir::Instruction::steps, matcher);
+  }
+
+  template <typename Matcher> auto StepHasControls(Matcher matcher) {
+    return Property("controls", &ir::Step::controls, matcher);
+  }
+
+  template <typename Matcher> auto StepHasStage(Matcher matcher) {
+    return Property("stage", &ir::Step::stage, matcher);
+  }
+};
+
+} // namespace
+
+TEST_F(ListSchedulerTest, EmptyInstruction) {
+  const auto instruction_set =
+      ir::InstructionSet({instruction_with_controls({})});
+  EXPECT_THAT(schedule(instruction_set),
+              InstructionSetHasInstructions(
+                  UnorderedElementsAre(InstructionHasSteps(IsEmpty()))));
+}
+
+TEST_F(ListSchedulerTest, IndependentStepsShareTick) {
+  const auto instruction_set = ir::InstructionSet({instruction_with_controls(
+      {{&cpu_.pc().write(), &irata_.memory().address().read()},
+       {&cpu_.a().write(), &cpu_.alu().lhs().read()}})});
+  EXPECT_THAT(
+      schedule(instruction_set),
+      InstructionSetHasInstructions(UnorderedElementsAre(
+          InstructionHasSteps(ElementsAre(StepHasControls(UnorderedElementsAre(
+              &cpu_.pc().write(), &irata_.memory().address().read(),
+              &cpu_.a().write(), &cpu_.alu().lhs().read())))))));
+}
+
+TEST_F(ListSchedulerTest, SharedBusKeepsStepsApart) {
+  const auto instruction_set = ir::InstructionSet({instruction_with_controls(
+      {{&cpu_.a().write(), &cpu_.alu().lhs().read()},
+       {&cpu_.x().write(), &cpu_.alu().rhs().read()}})});
+  EXPECT_THAT(schedule(instruction_set),
+              InstructionSetHasInstructions(UnorderedElementsAre(
+                  InstructionHasSteps(ElementsAre(
+                      StepHasControls(UnorderedElementsAre(
+                          &cpu_.a().write(), &cpu_.alu().lhs().read())),
+                      StepHasControls(UnorderedElementsAre(
+                          &cpu_.x().write(), &cpu_.alu().rhs().read())))))));
+}
+
+TEST_F(ListSchedulerTest, DependentStepsKeepOrder) {
+  // Reading memory depends on the address loaded in the previous step.
+  const auto instruction_set = ir::InstructionSet({instruction_with_controls(
+      {{&cpu_.pc().write(), &irata_.memory().address().read()},
+       {&irata_.memory().write(), &cpu_.a().read()}})});
+  EXPECT_THAT(schedule(instruction_set),
+              InstructionSetHasInstructions(UnorderedElementsAre(
+                  InstructionHasSteps(ElementsAre(
+                      StepHasControls(UnorderedElementsAre(
+                          &cpu_.pc().write(),
+                          &irata_.memory().address().read())),
+                      StepHasControls(UnorderedElementsAre(
+                          &irata_.memory().write(), &cpu_.a().read())))))));
+}
+
+TEST_F(ListSchedulerTest, DependentStepsInLaterPhasesShareTick) {
+  // The pc is incremented in the process phase, after it's written to the
+  // address bus.
+  const auto instruction_set = ir::InstructionSet({instruction_with_controls(
+      {{&cpu_.pc().write(), &irata_.memory().address().read()},
+       {&cpu_.pc().increment()}})});
+  EXPECT_THAT(
+      schedule(instruction_set),
+      InstructionSetHasInstructions(UnorderedElementsAre(
+          InstructionHasSteps(ElementsAre(StepHasControls(UnorderedElementsAre(
+              &cpu_.pc().write(), &irata_.memory().address().read(),
+              &cpu_.pc().increment())))))));
+}
+
+TEST_F(ListSchedulerTest, ConflictingAccessesInLaterPhasesShareTick) {
+  // The memory reads its address in the write phase, before the address is
+  // loaded in the read phase.
+  const auto instruction_set = ir::InstructionSet({instruction_with_controls(
+      {{&irata_.memory().write(), &cpu_.a().read()},
+       {&cpu_.pc().write(), &irata_.memory().address().read()}})});
+  EXPECT_THAT(
+      schedule(instruction_set),
+      InstructionSetHasInstructions(UnorderedElementsAre(
+          InstructionHasSteps(ElementsAre(StepHasControls(UnorderedElementsAre(
+              &irata_.memory().write(), &cpu_.a().read(), &cpu_.pc().write(),
+              &irata_.memory().address().read())))))));
+}
+
+TEST_F(ListSchedulerTest, IndependentStepMovesEarlier) {
+  const auto instruction_set = ir::InstructionSet({instruction_with_controls(
+      {{&cpu_.pc().write(), &irata_.memory().address().read()},
+       {&irata_.memory().write(), &cpu_.alu().rhs().read()},
+       {&cpu_.a().write(), &cpu_.alu().lhs().read()}})});
+  EXPECT_THAT(schedule(instruction_set),
+              InstructionSetHasInstructions(UnorderedElementsAre(
+                  InstructionHasSteps(ElementsAre(
+                      StepHasControls(UnorderedElementsAre(
+                          &cpu_.pc().write(), &irata_.memory().address().read(),
+                          &cpu_.a().write(), &cpu_.alu().lhs().read())),
+                      StepHasControls(UnorderedElementsAre(
+                          &irata_.memory().write(),
+                          &cpu_.alu().rhs().read())))))));
+}
+
+TEST_F(ListSchedulerTest, AluOperationWaitsForOperands) {
+  const auto &opcode_control = *cpu_.alu().opcode_controls().front();
+  const auto instruction_set = ir::InstructionSet({instruction_with_controls(
+      {{&cpu_.a().write(), &cpu_.alu().lhs().read()},
+       {&cpu_.x().write(), &cpu_.alu().rhs().read()},
+       {&opcode_control}})});
+  EXPECT_THAT(schedule(instruction_set),
+              InstructionSetHasInstructions(UnorderedElementsAre(
+                  InstructionHasSteps(ElementsAre(
+                      StepHasControls(UnorderedElementsAre(
+                          &cpu_.a().write(), &cpu_.alu().lhs().read())),
+                      StepHasControls(UnorderedElementsAre(
+                          &cpu_.x().write(), &cpu_.alu().rhs().read(),
+                          &opcode_control)))))));
+}
+
+TEST_F(ListSchedulerTest, ControlWithoutUnitIsBarrier) {
+  const auto instruction_set = ir::InstructionSet({instruction_with_controls(
+      {{&cpu_.a().write(), &cpu_.alu().lhs().read()},
+       {&irata_.halt()},
+       {&cpu_.pc().increment()}})});
+  EXPECT_THAT(schedule(instruction_set),
+              InstructionSetHasInstructions(UnorderedElementsAre(
+                  InstructionHasSteps(ElementsAre(
+                      StepHasControls(UnorderedElementsAre(
+                          &cpu_.a().write(), &cpu_.alu().lhs().read())),
+                      StepHasControls(UnorderedElementsAre(&irata_.halt())),
+                      StepHasControls(
+                          UnorderedElementsAre(&cpu_.pc().increment())))))));
+}
+
+TEST_F(ListSchedulerTest, StepsStayInTheirStage) {
+  const auto instruction_set = ir::InstructionSet({instruction_with_controls(
+      {{&cpu_.pc().write(), &irata_.memory().address().read()},
+       {&cpu_.a().write(), &cpu_.alu().lhs().read()}},
+      {0, 1})});
+  EXPECT_THAT(schedule(instruction_set),
+              InstructionSetHasInstructions(UnorderedElementsAre(
+                  InstructionHasSteps(ElementsAre(
+                      AllOf(StepHasStage(0),
+                            StepHasControls(UnorderedElementsAre(
+                                &cpu_.pc().write(),
+                                &irata_.memory().address().read()))),
+                      AllOf(StepHasStage(1),
+                            StepHasControls(UnorderedElementsAre(
+                                &cpu_.a().write(),
+                                &cpu_.alu().lhs().read()))))))));
+}
+
+} // namespace irata::sim::microcode::compiler::passes
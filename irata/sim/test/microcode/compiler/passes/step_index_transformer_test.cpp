@@ -26,6 +26,8 @@ protected:
       hdl::irata().cpu().controller().step_counter().reset();
   const hdl::ProcessControlDecl &other_control_ =
       hdl::irata().cpu().pc().increment();
+  const ir::ControlRegistry registry_{
+      {&increment_control_, &reset_control_, &other_control_}};
   const asm_::Instruction &instruction_descriptor_ =
       asm_::InstructionSet::irata().get_instruction(
           "lda", asm_::AddressingMode::Immediate);
@@ -38,7 +40,7 @@ protected:
       std::vector<std::set<const hdl::ControlDecl *>> controls) {
     std::vector<ir::Step> steps;
     for (const auto &control_set : controls) {
-      steps.push_back(ir::Step(control_set, {}, {}, 0));
+      steps.push_back(ir::Step(registry_, control_set, {}, {}, 0));
     }
     return ir::Instruction(instruction_descriptor_, steps, {});
   }
@@ -21,6 +21,8 @@ protected:
   const hdl::ReadControlDecl &read_control_ = hdl::irata().cpu().a().read();
   const hdl::ProcessControlDecl &process_control_ =
       hdl::irata().cpu().pc().increment();
+  const ir::ControlRegistry registry_{
+      {&write_control_, &read_control_, &process_control_}};
   const asm_::Instruction &instruction_descriptor_ =
       asm_::InstructionSet::irata().get_instruction(
           "lda", asm_::AddressingMode::Immediate);
@@ -46,7 +48,8 @@ protected:
         }
       }
       steps.push_back(
-          ir::Step(control_set, write_controls, read_controls, /*stage=*/0));
+          ir::Step(registry_, control_set, write_controls, read_controls,
+                   /*stage=*/0));
     }
     return ir::Instruction(instruction_descriptor_, steps, {});
   }
@@ -138,14 +141,14 @@ TEST_F(StepMergerTest, DoesntMergeStepsInDifferentStages) {
                                                    &read_control_};
     std::set<const hdl::WriteControlDecl *> write_controls = {&write_control_};
     std::set<const hdl::ReadControlDecl *> read_controls = {&read_control_};
-    steps.emplace_back(controls, write_controls, read_controls,
+    steps.emplace_back(registry_, controls, write_controls, read_controls,
                        /*stage=*/0);
   }
   {
     std::set<const hdl::ControlDecl *> controls = {&process_control_};
     std::set<const hdl::WriteControlDecl *> write_controls;
     std::set<const hdl::ReadControlDecl *> read_controls;
-    steps.emplace_back(controls, write_controls, read_controls,
+    steps.emplace_back(registry_, controls, write_controls, read_controls,
                        /*stage=*/1); // Different stage!
   }
 
@@ -0,0 +1,62 @@
+#include <atomic>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <irata/sim/microcode/compiler/worker_pool.hpp>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using ::testing::Each;
+
+namespace irata::sim::microcode::compiler {
+
+TEST(WorkerPoolTest, NumThreads) {
+  EXPECT_EQ(WorkerPool(0).num_threads(), 1);
+  EXPECT_EQ(WorkerPool(1).num_threads(), 1);
+  EXPECT_EQ(WorkerPool(4).num_threads(), 4);
+}
+
+TEST(WorkerPoolTest, RunsEachJobOnce) {
+  WorkerPool pool(4);
+  std::vector<int> runs(100);
+  pool.run(runs.size(), [&runs](size_t i) { ++runs[i]; });
+  EXPECT_THAT(runs, Each(1));
+}
+
+TEST(WorkerPoolTest, RunsNoJobs) {
+  WorkerPool pool(4);
+  pool.run(0, [](size_t) { FAIL(); });
+}
+
+TEST(WorkerPoolTest, ReusesWorkersAcrossBatches) {
+  WorkerPool pool(4);
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  for (int batch = 0; batch < 20; ++batch) {
+    pool.run(16, [&](size_t) {
+      std::lock_guard lock(mutex);
+      threads.insert(std::this_thread::get_id());
+    });
+  }
+  EXPECT_LE(threads.size(), 4);
+}
+
+TEST(WorkerPoolTest, RunsConcurrentBatches) {
+  WorkerPool pool(3);
+  std::atomic<int> runs = 0;
+  std::vector<std::thread> callers;
+  for (int caller = 0; caller < 4; ++caller) {
+    callers.emplace_back([&] {
+      for (int batch = 0; batch < 10; ++batch) {
+        pool.run(10, [&runs](size_t) { ++runs; });
+      }
+    });
+  }
+  for (auto &caller : callers) {
+    caller.join();
+  }
+  EXPECT_EQ(runs, 400);
+}
+
+} // namespace irata::sim::microcode::compiler
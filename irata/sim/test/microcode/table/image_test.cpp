@@ -0,0 +1,95 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <irata/asm/instruction_set.hpp>
+#include <irata/sim/microcode/compiler/compiler.hpp>
+#include <irata/sim/microcode/dsl/instruction.hpp>
+#include <irata/sim/microcode/table/image.hpp>
+#include <sstream>
+#include <stdexcept>
+
+namespace irata::sim::microcode::table {
+
+namespace {
+
+// The hash that the test images record.
+constexpr uint64_t hash = 0x1234;
+
+const Table &irata_table() {
+  static const Table table = compiler::Compiler::compile_irata();
+  return table;
+}
+
+std::string irata_image(uint64_t recorded_hash) {
+  std::ostringstream os;
+  write_image(os, irata_table(), recorded_hash);
+  return os.str();
+}
+
+} // namespace
+
+TEST(ImageTest, RoundTrip) {
+  std::istringstream is(irata_image(hash));
+  const auto table = read_image(is, dsl::InstructionSet::irata(), hash);
+  ASSERT_TRUE(table.has_value());
+  EXPECT_EQ(*table, irata_table());
+}
+
+TEST(ImageTest, HashIsDeterministic) {
+  EXPECT_EQ(image_hash(dsl::InstructionSet::irata(), 1),
+            image_hash(dsl::InstructionSet::irata(), 1));
+}
+
+TEST(ImageTest, HashDependsOnInstructionSet) {
+  dsl::InstructionSet empty;
+  dsl::InstructionSet lda;
+  lda.create_instruction("lda", asm_::AddressingMode::Immediate);
+  EXPECT_NE(image_hash(empty, 1), image_hash(lda, 1));
+  EXPECT_NE(image_hash(lda, 1), image_hash(dsl::InstructionSet::irata(), 1));
+}
+
+TEST(ImageTest, HashDependsOnCompilerFingerprint) {
+  EXPECT_NE(image_hash(dsl::InstructionSet::irata(), 1),
+            image_hash(dsl::InstructionSet::irata(), 2));
+}
+
+TEST(ImageTest, StaleImage) {
+  std::istringstream is(irata_image(hash + 1));
+  EXPECT_EQ(read_image(is, dsl::InstructionSet::irata(), hash), std::nullopt);
+}
+
+TEST(ImageTest, UnknownOpcode) {
+  const auto &instruction_set = dsl::InstructionSet::irata();
+  const Table table = {{{
+      .instruction = asm_::InstructionSet::irata().get_instruction(
+          "lda", asm_::AddressingMode::Immediate),
+      .step_index = Byte(0x00),
+  }}};
+  std::ostringstream os;
+  write_image(os, table, hash);
+  std::string image = os.str();
+  // The entry's opcode follows the magic, version, hash, empty path list and
+  // entry count.
+  const size_t opcode_offset = 8 + 4 + 8 + 2 + 4;
+  {
+    std::istringstream is(image);
+    EXPECT_EQ(read_image(is, instruction_set, hash), table);
+  }
+  image[opcode_offset] = char(0xFF);
+  std::istringstream is(image);
+  EXPECT_EQ(read_image(is, instruction_set, hash), std::nullopt);
+}
+
+TEST(ImageTest, NotAnImage) {
+  std::istringstream is("not a microcode image");
+  EXPECT_THROW(read_image(is, dsl::InstructionSet::irata(), hash),
+               std::runtime_error);
+}
+
+TEST(ImageTest, TruncatedImage) {
+  const auto image = irata_image(hash);
+  std::istringstream is(image.substr(0, image.size() / 2));
+  EXPECT_THROW(read_image(is, dsl::InstructionSet::irata(), hash),
+               std::runtime_error);
+}
+
+} // namespace irata::sim::microcode::table
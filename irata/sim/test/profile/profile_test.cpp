@@ -0,0 +1,94 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <irata/asm/instruction_set.hpp>
+#include <irata/sim/profile/profile.hpp>
+#include <sstream>
+
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+
+namespace irata::sim::profile {
+
+TEST(ProfileTest, Empty) {
+  const Profile profile;
+  EXPECT_EQ(profile.ticks(), 0);
+  EXPECT_EQ(profile.instructions(), 0);
+  EXPECT_THAT(profile.regions(), IsEmpty());
+  EXPECT_THAT(profile.bus_transfers(), IsEmpty());
+  EXPECT_THAT(profile.alu_operations(), IsEmpty());
+}
+
+TEST(ProfileTest, CountTick) {
+  Profile profile;
+  // Fetch and run 0x12 over three ticks.
+  profile.count_tick(0, std::nullopt);
+  profile.count_tick(1, 0x12);
+  profile.count_tick(2, std::nullopt);
+  // Fetch and run 0x34 over four ticks.
+  profile.count_tick(0, std::nullopt);
+  profile.count_tick(1, 0x34);
+  profile.count_tick(2, std::nullopt);
+  profile.count_tick(3, std::nullopt);
+  // Fetch 0x12 again over two ticks.
+  profile.count_tick(0, std::nullopt);
+  profile.count_tick(1, 0x12);
+  EXPECT_EQ(profile.ticks(), 9);
+  EXPECT_EQ(profile.instructions(), 3);
+  EXPECT_EQ(profile.opcodes()[0x12].instructions, 2);
+  EXPECT_EQ(profile.opcodes()[0x12].ticks, 5);
+  EXPECT_EQ(profile.opcodes()[0x34].instructions, 1);
+  EXPECT_EQ(profile.opcodes()[0x34].ticks, 4);
+  EXPECT_EQ(profile.opcodes()[0x56].instructions, 0);
+}
+
+TEST(ProfileTest, UnfinishedFetchIsOnlyCountedInTotal) {
+  Profile profile;
+  profile.count_tick(0, std::nullopt);
+  profile.count_tick(1, 0x12);
+  profile.count_tick(0, std::nullopt);
+  EXPECT_EQ(profile.ticks(), 3);
+  EXPECT_EQ(profile.opcodes()[0x12].ticks, 2);
+}
+
+TEST(ProfileTest, Counts) {
+  Profile profile;
+  profile.count_region_read("ram");
+  profile.count_region_read("ram");
+  profile.count_region_write("ram");
+  profile.count_region_read("cartridge");
+  profile.count_bus_transfer("data_bus");
+  profile.count_alu_operation(hdl::AluOpcode::Add);
+  profile.count_alu_operation(hdl::AluOpcode::Add);
+  EXPECT_EQ(profile.regions().at("ram").reads, 2);
+  EXPECT_EQ(profile.regions().at("ram").writes, 1);
+  EXPECT_EQ(profile.regions().at("cartridge").reads, 1);
+  EXPECT_EQ(profile.regions().at("cartridge").writes, 0);
+  EXPECT_EQ(profile.bus_transfers().at("data_bus"), 1);
+  EXPECT_EQ(profile.alu_operations().at(hdl::AluOpcode::Add), 2);
+}
+
+TEST(ProfileTest, Summary) {
+  const auto lda = asm_::InstructionSet::irata()
+                       .get_instruction("LDA", asm_::AddressingMode::Immediate)
+                       .opcode()
+                       .unsigned_value();
+  Profile profile;
+  profile.count_tick(0, std::nullopt);
+  profile.count_tick(1, lda);
+  profile.count_tick(2, std::nullopt);
+  profile.count_tick(3, std::nullopt);
+  profile.count_region_read("cartridge");
+  profile.count_bus_transfer("data_bus");
+  profile.count_alu_operation(hdl::AluOpcode::Subtract);
+  std::ostringstream os;
+  os << profile;
+  EXPECT_THAT(os.str(),
+              HasSubstr("4 ticks, 1 instructions, 4.0 ticks per instruction"));
+  EXPECT_THAT(os.str(), HasSubstr("(0xA9)"));
+  EXPECT_THAT(os.str(), HasSubstr("1 instructions, 4 ticks (100.0%)"));
+  EXPECT_THAT(os.str(), HasSubstr("cartridge: 1 reads, 0 writes"));
+  EXPECT_THAT(os.str(), HasSubstr("data_bus: 1 (25.0% of ticks)"));
+  EXPECT_THAT(os.str(), HasSubstr("Subtract: 1"));
+}
+
+} // namespace irata::sim::profile
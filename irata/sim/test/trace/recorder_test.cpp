@@ -0,0 +1,83 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <irata/sim/trace/recorder.hpp>
+#include <sstream>
+#include <stdexcept>
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+namespace irata::sim::trace {
+
+namespace {
+
+Header header() { return {{"/a"}, {"/x", "/y"}}; }
+
+Record record(uint8_t opcode) {
+  Record record;
+  record.opcode = opcode;
+  return record;
+}
+
+Record record(uint64_t tick, uint8_t opcode) {
+  auto r = record(opcode);
+  r.tick = tick;
+  return r;
+}
+
+} // namespace
+
+TEST(RecorderTest, ZeroCapacity) {
+  EXPECT_THROW(Recorder(header(), 0), std::invalid_argument);
+}
+
+TEST(RecorderTest, Record) {
+  Recorder recorder(header(), 4);
+  EXPECT_EQ(recorder.header(), header());
+  EXPECT_THAT(recorder.records(), IsEmpty());
+  recorder.record(record(0x10));
+  recorder.record(record(0x11));
+  EXPECT_EQ(recorder.num_recorded(), 2);
+  EXPECT_THAT(recorder.records(),
+              ElementsAre(record(0, 0x10), record(1, 0x11)));
+}
+
+TEST(RecorderTest, RingBufferKeepsNewestRecords) {
+  Recorder recorder(header(), 3);
+  for (uint8_t i = 0; i < 5; ++i) {
+    recorder.record(record(i));
+  }
+  EXPECT_EQ(recorder.num_recorded(), 5);
+  EXPECT_THAT(recorder.records(),
+              ElementsAre(record(2, 2), record(3, 3), record(4, 4)));
+}
+
+TEST(RecorderTest, Write) {
+  Recorder recorder(header(), 2);
+  for (uint8_t i = 0; i < 3; ++i) {
+    recorder.record(record(i));
+  }
+  std::stringstream ss;
+  recorder.write(ss);
+  Reader reader(ss);
+  EXPECT_EQ(reader.header(), header());
+  EXPECT_THAT(reader.read_all(), ElementsAre(record(1, 1), record(2, 2)));
+}
+
+TEST(RecorderTest, Stream) {
+  std::stringstream ss;
+  {
+    Recorder recorder(header(), ss);
+    for (uint8_t i = 0; i < 3; ++i) {
+      recorder.record(record(i));
+    }
+    EXPECT_EQ(recorder.num_recorded(), 3);
+    EXPECT_THAT(recorder.records(), IsEmpty());
+  }
+  Reader reader(ss);
+  EXPECT_EQ(reader.header(), header());
+  EXPECT_THAT(reader.read_all(),
+              ElementsAre(record(0, 0), record(1, 1), record(2, 2)));
+}
+
+} // namespace irata::sim::trace
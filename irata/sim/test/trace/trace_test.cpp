@@ -0,0 +1,147 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <irata/sim/components/controller/controller.hpp>
+#include <irata/sim/trace/trace.hpp>
+#include <sstream>
+#include <stdexcept>
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+namespace irata::sim::trace {
+
+namespace {
+
+Header header() { return {{"/a", "/b"}, {"/x", "/y", "/z"}}; }
+
+Record record() {
+  Record record;
+  record.tick = 0x0102030405060708;
+  record.opcode = 0x12;
+  record.step_counter = 0x03;
+  record.encoded_statuses = 0b10;
+  record.encoded_controls = 0b101;
+  record.data_bus = 0x34;
+  record.address_bus = 0x8000;
+  return record;
+}
+
+} // namespace
+
+TEST(TraceTest, EncodeDecode) {
+  EXPECT_EQ(Record::decode(record().encode()), record());
+  EXPECT_EQ(Record::decode(Record().encode()), Record());
+}
+
+TEST(TraceTest, EncodeWideStatuses) {
+  auto wide = record();
+  wide.encoded_statuses = 0x80000001;
+  EXPECT_EQ(Record::decode(wide.encode()), wide);
+}
+
+TEST(TraceTest, EncodeIsLittleEndian) {
+  const auto bytes = record().encode();
+  EXPECT_EQ(bytes[0], 0x08);
+  EXPECT_EQ(bytes[7], 0x01);
+  EXPECT_EQ(bytes[8], 0b101);
+  EXPECT_EQ(bytes[16], 0x00);
+  EXPECT_EQ(bytes[17], 0x80);
+}
+
+TEST(TraceTest, EncodeEmptyBuses) {
+  auto empty = record();
+  empty.data_bus = std::nullopt;
+  empty.address_bus = std::nullopt;
+  const auto decoded = Record::decode(empty.encode());
+  EXPECT_EQ(decoded.data_bus, std::nullopt);
+  EXPECT_EQ(decoded.address_bus, std::nullopt);
+  EXPECT_NE(decoded, record());
+}
+
+TEST(TraceTest, DecodeMalformed) {
+  auto bytes = record().encode();
+  bytes[Record::size - 1] = 0xFF;
+  EXPECT_THROW(Record::decode(bytes), std::runtime_error);
+}
+
+TEST(TraceTest, HeaderFromEncoder) {
+  const auto &encoder =
+      components::controller::Controller::irata_microcode()->encoder;
+  const auto header = Header::from_encoder(encoder);
+  ASSERT_EQ(header.controls.size(), encoder.control_encoder().num_controls());
+  ASSERT_EQ(header.statuses.size(), encoder.status_encoder().num_statuses());
+  for (size_t i = 0; i < header.controls.size(); ++i) {
+    EXPECT_EQ(header.controls[i],
+              encoder.control_encoder().controls()[i]->path());
+  }
+}
+
+TEST(TraceTest, HeaderWriteRead) {
+  std::stringstream ss;
+  header().write(ss);
+  EXPECT_EQ(Header::read(ss), header());
+}
+
+TEST(TraceTest, HeaderReadNotATrace) {
+  std::stringstream ss("not a trace at all");
+  EXPECT_THROW(Header::read(ss), std::runtime_error);
+}
+
+TEST(TraceTest, HeaderReadTruncated) {
+  std::stringstream ss;
+  header().write(ss);
+  const auto bytes = ss.str();
+  std::stringstream truncated(bytes.substr(0, bytes.size() - 1));
+  EXPECT_THROW(Header::read(truncated), std::runtime_error);
+}
+
+TEST(TraceTest, Describe) {
+  EXPECT_EQ(header().describe(record()),
+            "tick 72623859790382856: opcode=0x12 step_counter=0x03 "
+            "statuses=[/a=0, /b=1] controls=[/x, /z] data_bus=0x34 "
+            "address_bus=0x8000");
+}
+
+TEST(TraceTest, DescribeEmptyBusesAndUnknownControls) {
+  auto unknown = record();
+  unknown.tick = 1;
+  unknown.encoded_controls = 1ull << 40;
+  unknown.data_bus = std::nullopt;
+  unknown.address_bus = std::nullopt;
+  EXPECT_EQ(header().describe(unknown),
+            "tick 1: opcode=0x12 step_counter=0x03 statuses=[/a=0, /b=1] "
+            "controls=[<control 40>] data_bus=- address_bus=-");
+}
+
+TEST(TraceTest, Reader) {
+  std::stringstream ss;
+  header().write(ss);
+  auto second = record();
+  second.tick++;
+  for (const auto &r : {record(), second}) {
+    const auto bytes = r.encode();
+    ss.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+  }
+  Reader reader(ss);
+  EXPECT_EQ(reader.header(), header());
+  EXPECT_THAT(reader.read_all(), ElementsAre(record(), second));
+  EXPECT_EQ(reader.next(), std::nullopt);
+}
+
+TEST(TraceTest, ReaderEmpty) {
+  std::stringstream ss;
+  header().write(ss);
+  Reader reader(ss);
+  EXPECT_THAT(reader.read_all(), IsEmpty());
+}
+
+TEST(TraceTest, ReaderTruncated) {
+  std::stringstream ss;
+  header().write(ss);
+  const auto bytes = record().encode();
+  ss.write(reinterpret_cast<const char *>(bytes.data()), bytes.size() - 1);
+  Reader reader(ss);
+  EXPECT_THROW(reader.next(), std::runtime_error);
+}
+
+} // namespace irata::sim::trace